@@ -0,0 +1,107 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "HUD.h"
+
+// Forget resolved classes and the last sample
+void HudBossTracker::Reset(void) {
+  pdecBoss = NULL;
+  bBossHealth = FALSE;
+
+  pdecCounter = NULL;
+  slCountCurr = -1;
+  slCountFrom = -1;
+
+  penHolder = NULL;
+  tmSampled = -1.0f;
+  fValue = 0.0f;
+};
+
+// Resolve boss properties for a new class
+void HudBossTracker::ResolveBoss(CEntity *penBoss) {
+  pdecBoss = penBoss->en_pecClass->ec_pdecDLLClass;
+  bBossHealth = IsDerivedFromID(penBoss, CEnemyBase_ClassID);
+};
+
+// Resolve counter properties for a new class
+void HudBossTracker::ResolveCounter(CEntity *penCounter) {
+  pdecCounter = penCounter->en_pecClass->ec_pdecDLLClass;
+  slCountCurr = -1;
+  slCountFrom = -1;
+
+  // Find CEnemyCounter::m_iCount and CEnemyCounter::m_iCountFrom
+  CPropertyPtr pptrCountCurr(penCounter);
+  CPropertyPtr pptrCountFrom(penCounter);
+
+  BOOL bProps = pptrCountCurr.ByVariable("CEnemyCounter", "m_iCount")
+             && pptrCountFrom.ByVariable("CEnemyCounter", "m_iCountFrom");
+
+  if (bProps) {
+    slCountCurr = pptrCountCurr.Offset();
+    slCountFrom = pptrCountFrom.Offset();
+  }
+};
+
+// Get boss bar value from a music holder (0 if none)
+FLOAT HudBossTracker::Sample(CEntity *penMusicHolder, TIME tmTick) {
+  // Already sampled during this tick
+  if (penMusicHolder == penHolder && tmTick == tmSampled) return fValue;
+
+  penHolder = penMusicHolder;
+  tmSampled = tmTick;
+  fValue = 0.0f;
+
+  if (penMusicHolder == NULL) return fValue;
+
+  CMusicHolder &mh = (CMusicHolder &)*penMusicHolder;
+
+  // Boss health
+  CEntity *penBoss = mh.m_penBoss;
+
+  if (penBoss != NULL && penBoss->GetFlags() & ENF_ALIVE) {
+    if (penBoss->en_pecClass->ec_pdecDLLClass != pdecBoss) {
+      ResolveBoss(penBoss);
+    }
+
+    if (bBossHealth) {
+      CEnemyBase &eb = (CEnemyBase &)*penBoss;
+      ASSERT(eb.m_fMaxHealth > 0);
+
+      fValue = eb.GetHealth() / eb.m_fMaxHealth;
+    }
+  }
+
+  // Enemy counter
+  CEntity *penCounter = mh.m_penCounter;
+
+  if (penCounter != NULL) {
+    if (penCounter->en_pecClass->ec_pdecDLLClass != pdecCounter) {
+      ResolveCounter(penCounter);
+    }
+
+    if (slCountCurr != -1 && slCountFrom != -1) {
+      const INDEX iCountCurr = ENTITYPROPERTY(penCounter, slCountCurr, INDEX);
+      const INDEX iCountFrom = ENTITYPROPERTY(penCounter, slCountFrom, INDEX);
+
+      if (iCountCurr > 0) {
+        fValue = FLOAT(iCountCurr) / iCountFrom;
+      }
+    }
+  }
+
+  return fValue;
+};
@@ -0,0 +1,57 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#ifndef CECIL_INCL_BOSSTRACKER_H
+#define CECIL_INCL_BOSSTRACKER_H
+
+#ifdef PRAGMA_ONCE
+  #pragma once
+#endif
+
+// Boss health and enemy counter that are sampled once per tick
+struct HudBossTracker {
+  // Boss class and whether its health can be read
+  CDLLEntityClass *pdecBoss;
+  BOOL bBossHealth;
+
+  // Counter class and offsets of its properties (-1 if not found)
+  CDLLEntityClass *pdecCounter;
+  SLONG slCountCurr;
+  SLONG slCountFrom;
+
+  // Last sample
+  CEntity *penHolder;
+  TIME tmSampled;
+  FLOAT fValue;
+
+  HudBossTracker() {
+    Reset();
+  };
+
+  // Forget resolved classes and the last sample
+  void Reset(void);
+
+  // Get boss bar value from a music holder (0 if none)
+  FLOAT Sample(CEntity *penMusicHolder, TIME tmTick);
+
+  private:
+    // Resolve boss properties for a new class
+    void ResolveBoss(CEntity *penBoss);
+
+    // Resolve counter properties for a new class
+    void ResolveCounter(CEntity *penCounter);
+};
+
+#endif
@@ -0,0 +1,216 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "HUD.h"
+
+// Size of one player cell in virtual pixels
+#define CASTER_CELL_W 168.0f
+#define CASTER_CELL_H 20.0f
+#define CASTER_CELL_GAP 2.0f
+
+// Value considered to be full for health and armor bars
+#define CASTER_TOP_VALUE 100.0f
+
+// Reset arrays for a certain amount of players
+void HudCasterRoster::Resize(INDEX ct) {
+  ctPlayers = ct;
+
+  #define RESIZE_STREAM(_Stream) \
+    _Stream.PopAll(); \
+    if (ct > 0) _Stream.Push(ct);
+
+  RESIZE_STREAM(apenPlayers);
+  RESIZE_STREAM(astrNames);
+  RESIZE_STREAM(afHealth);
+  RESIZE_STREAM(afArmor);
+  RESIZE_STREAM(aiWeaponInfo);
+  RESIZE_STREAM(aiAmmo);
+  RESIZE_STREAM(aiMaxAmmo);
+  RESIZE_STREAM(abAlive);
+
+  #undef RESIZE_STREAM
+};
+
+// Check if the roster needs to be captured again
+BOOL HudCasterRoster::IsOutdated(TIME tmTick, const CDynamicContainer<CPlayer> &cenPlayers) const {
+  // New tick or different players
+  if (tmTick != tmCaptured || ctPlayers != cenPlayers.Count()) return TRUE;
+
+  for (INDEX i = 0; i < ctPlayers; i++) {
+    if (apenPlayers[i] != cenPlayers.Pointer(i)) return TRUE;
+  }
+
+  return FALSE;
+};
+
+// Gather vitals and arsenal of all players once per tick
+void CHud::CaptureCasterRoster(void) {
+  if (!_roster.IsOutdated(_snap.tmTick, _cenPlayers)) return;
+
+  const INDEX ctPlayers = _cenPlayers.Count();
+  _roster.Resize(ctPlayers);
+  _roster.tmCaptured = _snap.tmTick;
+
+  for (INDEX i = 0; i < ctPlayers; i++) {
+    CPlayer *pen = (CPlayer *)_cenPlayers.Pointer(i);
+
+    _roster.apenPlayers[i] = pen;
+    _roster.astrNames[i] = pen->GetPlayerName();
+    _roster.afHealth[i] = pen->GetHealth();
+    _roster.afArmor[i] = pen->m_fArmor;
+    _roster.abAlive[i] = (pen->GetFlags() & ENF_ALIVE) ? TRUE : FALSE;
+
+    _roster.aiWeaponInfo[i] = -1;
+    _roster.aiAmmo[i] = 0;
+    _roster.aiMaxAmmo[i] = 0;
+
+    CPlayerWeapons *penWeapons = (CPlayerWeapons *)&*pen->m_penWeapons;
+    if (penWeapons == NULL) continue;
+
+    // Find weapon in the table
+    const INDEX iWeapon = penWeapons->m_iCurrentWeapon;
+
+    for (INDEX iInfo = 0; iInfo < GetWeapons().Count(); iInfo++) {
+      if (GetWeapons()[iInfo].iWeapon == iWeapon) {
+        _roster.aiWeaponInfo[i] = iInfo;
+        break;
+      }
+    }
+
+    _roster.aiAmmo[i] = (penWeapons->*pGetAmmo)();
+    _roster.aiMaxAmmo[i] = (penWeapons->*pGetMaxAmmo)();
+  }
+};
+
+// Display vitals and arsenal of all players in a grid
+void CHud::RenderCasterOverview(void) {
+  CaptureCasterRoster();
+
+  const INDEX ctPlayers = _roster.ctPlayers;
+  if (ctPlayers == 0) return;
+
+  // Cell layout
+  const FLOAT fScale = _fHudScaling;
+  const FLOAT fCellW = CASTER_CELL_W * fScale * _vScaling(1);
+  const FLOAT fCellH = CASTER_CELL_H * fScale * _vScaling(1);
+  const FLOAT fGap = CASTER_CELL_GAP * fScale * _vScaling(1);
+  const FLOAT fIconSize = fCellH - fGap * 2.0f;
+  const FLOAT fBarH = Max(fCellH * 0.1f, 1.0f);
+
+  // Start below score and deaths and wrap into more columns if players don't fit
+  const FLOAT fStartX = _vpixTL(1) * _vScaling(1);
+  const FLOAT fStartY = (_vpixTL(2) + 96.0f * fScale) * _vScaling(2);
+
+  const INDEX ctRows = Clamp(INDEX((_vpixScreen(2) - fStartY) / (fCellH + fGap)), (INDEX)1, ctPlayers);
+
+  #define CELL_X(_Player) (fStartX + ((_Player) / ctRows) * (fCellW + fGap))
+  #define CELL_Y(_Player) (fStartY + ((_Player) % ctRows) * (fCellH + fGap))
+
+  const COLOR colBack = C_BLACK | (_ulAlphaHUD >> 1);
+  const COLOR colEmpty = C_vdGRAY | (_ulAlphaHUD >> 1);
+
+  PrepareColorTransitions(_colMax, _colTop, _colMid, _colLow, 0.5f, 0.25f, FALSE);
+
+  // Cell backgrounds and bars without texture
+  _pdp->InitTexture(NULL);
+
+  for (INDEX iBack = 0; iBack < ctPlayers; iBack++) {
+    const FLOAT fX = CELL_X(iBack);
+    const FLOAT fY = CELL_Y(iBack);
+
+    const FLOAT fBarX = fX + fIconSize + fGap * 2.0f;
+    const FLOAT fBarW = fCellW - (fBarX - fX) - fGap;
+    const FLOAT fBarY = fY + fCellH - fGap - fBarH * 2.0f;
+
+    const FLOAT fHealth = Clamp(_roster.afHealth[iBack] / CASTER_TOP_VALUE, 0.0f, 1.0f);
+    const FLOAT fArmor = Clamp(_roster.afArmor[iBack] / CASTER_TOP_VALUE, 0.0f, 1.0f);
+
+    _pdp->AddTexture(fX, fY, fX + fCellW, fY + fCellH, colBack);
+
+    _pdp->AddTexture(fBarX, fBarY, fBarX + fBarW, fBarY + fBarH * 2.0f, colEmpty);
+    _pdp->AddTexture(fBarX, fBarY, fBarX + fBarW * fHealth, fBarY + fBarH, GetCurrentColor(fHealth) | _ulAlphaHUD);
+    _pdp->AddTexture(fBarX, fBarY + fBarH, fBarX + fBarW * fArmor, fBarY + fBarH * 2.0f, _colIconStd | _ulAlphaHUD);
+  }
+
+  _pdp->FlushRenderingQueue();
+
+  // Weapon icons with one texture switch per weapon type
+  for (INDEX iInfo = 0; iInfo < GetWeapons().Count(); iInfo++) {
+    SIconTexture *pto = GetWeapons()[iInfo].ptoWeapon;
+    if (pto == NULL) continue;
+
+    BOOL bInitialized = FALSE;
+
+    for (INDEX iIcon = 0; iIcon < ctPlayers; iIcon++) {
+      if (_roster.aiWeaponInfo[iIcon] != iInfo) continue;
+
+      if (!bInitialized) {
+        _pdp->InitTexture(&pto->ato[_iTheme]);
+        bInitialized = TRUE;
+      }
+
+      const FLOAT fX = CELL_X(iIcon) + fGap;
+      const FLOAT fY = CELL_Y(iIcon) + fGap;
+      const COLOR colIcon = (_roster.abAlive[iIcon] ? _colIconStd : C_vdGRAY);
+
+      _pdp->AddTexture(fX, fY, fX + fIconSize, fY + fIconSize, colIcon | _ulAlphaHUD);
+    }
+
+    if (bInitialized) {
+      _pdp->FlushRenderingQueue();
+    }
+  }
+
+  // Names and ammo in one text batch
+  const FLOAT fTextScale = fCellH / (FLOAT)_pfdCurrentText->GetHeight() * 0.6f;
+
+  _pfdCurrentText->SetVariableWidth();
+  _pdp->SetFont(_pfdCurrentText);
+  _pdp->SetTextScaling(fTextScale);
+  _pdp->SetTextCharSpacing(0);
+
+  _tbText.Begin(_pdp);
+
+  for (INDEX iText = 0; iText < ctPlayers; iText++) {
+    const FLOAT fX = CELL_X(iText);
+    const FLOAT fY = CELL_Y(iText) + fGap;
+
+    CTString strName = _roster.astrNames[iText];
+
+    if (!_psDecoratedNames.GetIndex()) {
+      strName = strName.Undecorated();
+    }
+
+    const COLOR colName = (_roster.abAlive[iText] ? COL_PlayerNames() : COL_ValueLow());
+    _tbText.AddText(strName, fX + fIconSize + fGap * 2.0f, fY, colName | _ulAlphaHUD, CHudTextBatch::E_TA_LEFT);
+
+    // Ammo of the current weapon
+    if (_roster.aiMaxAmmo[iText] > 0 && !_snap.bInfiniteAmmo) {
+      const FLOAT fNormAmmo = (FLOAT)_roster.aiAmmo[iText] / (FLOAT)_roster.aiMaxAmmo[iText];
+
+      CTString strAmmo;
+      strAmmo.PrintF("%d", _roster.aiAmmo[iText]);
+
+      _tbText.AddText(strAmmo, fX + fCellW - fGap, fY, GetCurrentColor(fNormAmmo) | _ulAlphaHUD, CHudTextBatch::E_TA_RIGHT);
+    }
+  }
+
+  _tbText.Flush(_pdp);
+
+  #undef CELL_X
+  #undef CELL_Y
+};
@@ -0,0 +1,48 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#ifndef CECIL_INCL_CASTEROVERVIEW_H
+#define CECIL_INCL_CASTEROVERVIEW_H
+
+#ifdef PRAGMA_ONCE
+  #pragma once
+#endif
+
+class CPlayer;
+
+// Vitals and arsenal of all players in a structure-of-arrays layout
+struct HudCasterRoster {
+  INDEX ctPlayers;
+  TIME tmCaptured; // Game tick of the last capture
+
+  CStaticStackArray<CPlayer *> apenPlayers;
+  CStaticStackArray<CTString> astrNames;
+  CStaticStackArray<FLOAT> afHealth;
+  CStaticStackArray<FLOAT> afArmor;
+  CStaticStackArray<INDEX> aiWeaponInfo; // Index in the weapon table (-1 if none)
+  CStaticStackArray<INDEX> aiAmmo;
+  CStaticStackArray<INDEX> aiMaxAmmo;
+  CStaticStackArray<BOOL> abAlive;
+
+  HudCasterRoster() : ctPlayers(0), tmCaptured(-1.0f) {};
+
+  // Reset arrays for a certain amount of players
+  void Resize(INDEX ct);
+
+  // Check if the roster needs to be captured again
+  BOOL IsOutdated(TIME tmTick, const CDynamicContainer<CPlayer> &cenPlayers) const;
+};
+
+#endif
@@ -13,162 +13,123 @@ You should have received a copy of the GNU General Public License along
 with this program; if not, write to the Free Software Foundation, Inc.,
 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
 
-// Base colors
-COLOR CHud::COL_Base(void) {
-  // Custom color
-  if (_psColorize.GetIndex()) {
-    return _psColorBase.GetIndex() << 8;
+// Resolve colors of the current theme and custom colors once per frame
+void CHud::ResolveColors(const HudColorSet &colTheme) {
+  _colSet = colTheme;
+
+  // Custom colors
+  const BOOL bColorize = (_psColorize.GetIndex() != 0);
+
+  if (bColorize) {
+    _colSet.colBase         = _psColorBase.GetIndex() << 8;
+    _colSet.colIcon         = _psColorIcon.GetIndex() << 8;
+    _colSet.colNames        = _psColorNames.GetIndex() << 8;
+    _colSet.colAmmoSelected = _psColorSelect.GetIndex() << 8;
+
+    _colSet.colValueOverTop = _psColorMax.GetIndex() << 8;
+    _colSet.colValueTop     = _psColorTop.GetIndex() << 8;
+    _colSet.colValueMid     = _psColorMid.GetIndex() << 8;
+    _colSet.colValueLow     = _psColorLow.GetIndex() << 8;
+
+    _colSet.colScopeMask    = _psColorBase.GetIndex() << 8;
+    _colSet.colScopeDetails = _psColorIcon.GetIndex() << 8;
+
+    _colSet.colWeaponBorder = _psColorBase.GetIndex() << 8;
+    _colSet.colWeaponIcon   = _psColorWeapon.GetIndex() << 8;
+    _colSet.colWeaponWanted = _psColorSelect.GetIndex() << 8;
   }
 
-  return pColorSet->colBase;
-};
+  // Swap color channels and shift for TFE and custom colors
+  if (!_bTSEColors || bColorize) {
+    UBYTE ubR, ubG, ubB;
+    ColorToRGB(_colSet.colBase, ubR, ubG, ubB);
 
-COLOR CHud::COL_Icon(void) {
-  // Custom color
-  if (_psColorize.GetIndex()) {
-    return _psColorIcon.GetIndex() << 8;
+    _colSnoopingLight = RGBToColor(ubG, ubB, ubR);
+    _colSnoopingDark = (_colSnoopingLight >> 1) & 0x7F7F7F00;
+
+  // TSE colors
+  } else {
+    _colSnoopingLight = 0xEE9C0000;
+    _colSnoopingDark = 0x9B4B0000;
   }
+};
 
-  return pColorSet->colIcon;
+// Base colors
+COLOR CHud::COL_Base(void) {
+  return _colSet.colBase;
 };
 
-COLOR CHud::COL_PlayerNames(void) {
-  // Custom color
-  if (_psColorize.GetIndex()) {
-    return _psColorNames.GetIndex() << 8;
-  }
+COLOR CHud::COL_Icon(void) {
+  return _colSet.colIcon;
+};
 
-  return pColorSet->colNames;
+COLOR CHud::COL_PlayerNames(void) {
+  return _colSet.colNames;
 };
 
 COLOR CHud::COL_SnoopingLight(void) {
-  // Swap color channels for TFE and custom colors
-  if (!_bTSEColors || _psColorize.GetIndex()) {
-    UBYTE ubR, ubG, ubB;
-    ColorToRGB(_colBorder, ubR, ubG, ubB);
-
-    return RGBToColor(ubG, ubB, ubR);
-  }
-
-  // TSE colors
-  return 0xEE9C0000;
+  return _colSnoopingLight;
 };
 
 COLOR CHud::COL_SnoopingDark(void) {
-  // Shift for TFE and custom color
-  if (!_bTSEColors || _psColorize.GetIndex()) {
-    return (_colBorder >> 1) & 0x7F7F7F00;
-  }
-
-  // TSE colors
-  return 0x9B4B0000;
+  return _colSnoopingDark;
 };
 
 COLOR CHud::COL_AmmoSelected(void) {
-  // Custom color
-  if (_psColorize.GetIndex()) {
-    return _psColorSelect.GetIndex() << 8;
-  }
-
-  return pColorSet->colAmmoSelected;
+  return _colSet.colAmmoSelected;
 };
 
 COLOR CHud::COL_AmmoDepleted(void) {
-  return pColorSet->colAmmoDepleted;
+  return _colSet.colAmmoDepleted;
 };
 
 // Value colors
 COLOR CHud::COL_ValueOverTop(void) {
-  // Custom color
-  if (_psColorize.GetIndex()) {
-    return _psColorMax.GetIndex() << 8;
-  }
-
-  return pColorSet->colValueOverTop;
+  return _colSet.colValueOverTop;
 };
 
 COLOR CHud::COL_ValueTop(void) {
-  // Custom color
-  if (_psColorize.GetIndex()) {
-    return _psColorTop.GetIndex() << 8;
-  }
-
-  return pColorSet->colValueTop;
+  return _colSet.colValueTop;
 };
 
 COLOR CHud::COL_ValueMid(void) {
-  // Custom color
-  if (_psColorize.GetIndex()) {
-    return _psColorMid.GetIndex() << 8;
-  }
-
-  return pColorSet->colValueMid;
+  return _colSet.colValueMid;
 };
 
 COLOR CHud::COL_ValueLow(void) {
-  // Custom color
-  if (_psColorize.GetIndex()) {
-    return _psColorLow.GetIndex() << 8;
-  }
-
-  return pColorSet->colValueLow;
+  return _colSet.colValueLow;
 };
 
 // Sniper scope
 COLOR CHud::COL_ScopeMask(void) {
-  // Custom color
-  if (_psColorize.GetIndex()) {
-    return _psColorBase.GetIndex() << 8;
-  }
-
-  return pColorSet->colScopeMask;
+  return _colSet.colScopeMask;
 };
 
 COLOR CHud::COL_ScopeDetails(void) {
-  // Custom color
-  if (_psColorize.GetIndex()) {
-    return _psColorIcon.GetIndex() << 8;
-  }
-
-  return pColorSet->colScopeDetails;
+  return _colSet.colScopeDetails;
 };
 
 COLOR CHud::COL_ScopeLedIdle(void) {
-  return pColorSet->colScopeLedIdle;
+  return _colSet.colScopeLedIdle;
 };
 
 COLOR CHud::COL_ScopeLedFire(void) {
-  return pColorSet->colScopeLedFire;
+  return _colSet.colScopeLedFire;
 };
 
 // Weapon selection list
 COLOR CHud::COL_WeaponBorder(void) {
-  // Custom color
-  if (_psColorize.GetIndex()) {
-    return _psColorBase.GetIndex() << 8;
-  }
-
-  return pColorSet->colWeaponBorder;
+  return _colSet.colWeaponBorder;
 };
 
 COLOR CHud::COL_WeaponIcon(void) {
-  // Custom color
-  if (_psColorize.GetIndex()) {
-    return _psColorWeapon.GetIndex() << 8;
-  }
-
-  return pColorSet->colWeaponIcon;
+  return _colSet.colWeaponIcon;
 };
 
 COLOR CHud::COL_WeaponNoAmmo(void) {
-  return pColorSet->colWeaponNoAmmo;
+  return _colSet.colWeaponNoAmmo;
 };
 
 COLOR CHud::COL_WeaponWanted(void) {
-  // Custom color
-  if (_psColorize.GetIndex()) {
-    return _psColorSelect.GetIndex() << 8;
-  }
-
-  return pColorSet->colWeaponWanted;
+  return _colSet.colWeaponWanted;
 };
@@ -0,0 +1,181 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "HUD.h"
+
+// Stored hashes format
+static const INDEX _iDrawHashVersion = 1;
+
+// Draw commands are being hashed
+BOOL _bHashDraws = FALSE;
+
+// Hash of the current frame
+static ULONG _ulDrawHash = 0;
+
+// Vertices are compared with a quarter-pixel precision
+static inline SLONG QuantizeCoord(FLOAT f) {
+  return (SLONG)floor(f * 4.0f + 0.5f);
+};
+
+// Texture coordinates are compared with 1/1024 precision
+static inline SLONG QuantizeUV(FLOAT f) {
+  return (SLONG)floor(f * 1024.0f + 0.5f);
+};
+
+// Add raw data to the hash of the current frame
+void HashDrawData(const void *pData, SLONG slSize) {
+  const UBYTE *pub = (const UBYTE *)pData;
+
+  for (SLONG i = 0; i < slSize; i++) {
+    _ulDrawHash = (_ulDrawHash ^ pub[i]) * 16777619UL;
+  }
+};
+
+// Add texture to the hash by its file name
+void HashDrawTextureData(CTextureObject *pto) {
+  // Separate commands
+  HashDrawData("T", 1);
+
+  CTextureData *ptd = (pto != NULL) ? (CTextureData *)pto->GetData() : NULL;
+  if (ptd == NULL) return;
+
+  const CTString strName = ptd->GetName();
+  HashDrawData(strName.str_String, strName.Length());
+};
+
+// Add quad with texture coordinates to the hash
+void HashDrawQuadData(const HudQuad &quad) {
+  const SLONG aslQuad[9] = {
+    QuantizeCoord(quad.fI0), QuantizeCoord(quad.fJ0), QuantizeCoord(quad.fI1), QuantizeCoord(quad.fJ1),
+    QuantizeUV(quad.fU0), QuantizeUV(quad.fV0), QuantizeUV(quad.fU1), QuantizeUV(quad.fV1),
+    (SLONG)quad.col,
+  };
+
+  HashDrawData("Q", 1);
+  HashDrawData(aslQuad, sizeof(aslQuad));
+};
+
+// Add rectangle with an entire texture or a fill to the hash
+void HashDrawRectData(FLOAT fI0, FLOAT fJ0, FLOAT fI1, FLOAT fJ1, COLOR col) {
+  const SLONG aslRect[5] = {
+    QuantizeCoord(fI0), QuantizeCoord(fJ0), QuantizeCoord(fI1), QuantizeCoord(fJ1), (SLONG)col,
+  };
+
+  HashDrawData("R", 1);
+  HashDrawData(aslRect, sizeof(aslRect));
+};
+
+// Add text line printed with a certain font to the hash
+void HashDrawTextData(const CFontData *pfd, FLOAT fScaling, const CTString &strText, FLOAT fX, FLOAT fY, COLOR col) {
+  HashDrawData("S", 1);
+
+  if (pfd != NULL) {
+    HashDrawData(pfd->fd_fnTexture.str_String, pfd->fd_fnTexture.Length());
+  }
+
+  const SLONG aslText[4] = { QuantizeUV(fScaling), QuantizeCoord(fX), QuantizeCoord(fY), (SLONG)col };
+  HashDrawData(aslText, sizeof(aslText));
+  HashDrawData(strText.str_String, strText.Length());
+};
+
+// Start hashing draw commands of a new frame
+void BeginDrawHash(void) {
+  _ulDrawHash = 2166136261UL;
+  _bHashDraws = TRUE;
+};
+
+// Stop hashing and return the hash of the frame
+ULONG EndDrawHash(void) {
+  _bHashDraws = FALSE;
+  return _ulDrawHash;
+};
+
+// Compare frame hashes of recorded snapshots with stored ones or store them if there are none
+void CheckDrawHashes(const CTFileName &fnmSnapshots, const CStaticStackArray<ULONG> &aulHashes, PIX pixW, PIX pixH, INDEX iTheme) {
+  const CTFileName fnmHashes = fnmSnapshots.NoExt() + ".hashes";
+  const INDEX ctFrames = aulHashes.Count();
+
+  try {
+    // Store hashes as the reference
+    if (!FileExists(fnmHashes)) {
+      CTFileStream strm;
+      strm.Create_t(fnmHashes);
+
+      strm.WriteID_t("HHSH");
+      strm << _iDrawHashVersion << pixW << pixH << iTheme << ctFrames;
+      if (ctFrames > 0) strm.Write_t(&aulHashes[0], ctFrames * sizeof(ULONG));
+
+      CPrintF(TRANS("Stored draw hashes of %d HUD frames in '%s'\n"), ctFrames, fnmHashes.str_String);
+      return;
+    }
+
+    CTFileStream strm;
+    strm.Open_t(fnmHashes);
+    strm.ExpectID_t("HHSH");
+
+    INDEX iVersion, iStoredTheme, ctStored;
+    PIX pixStoredW, pixStoredH;
+    strm >> iVersion >> pixStoredW >> pixStoredH >> iStoredTheme >> ctStored;
+
+    if (iVersion != _iDrawHashVersion) {
+      ThrowF_t(TRANS("expected version %d but got %d"), _iDrawHashVersion, iVersion);
+    }
+
+    // Hashes depend on the resolution and the theme
+    if (pixStoredW != pixW || pixStoredH != pixH || iStoredTheme != iTheme) {
+      ThrowF_t(TRANS("hashes are for %dx%d with theme %d but the HUD is %dx%d with theme %d"),
+        pixStoredW, pixStoredH, iStoredTheme, pixW, pixH, iTheme);
+    }
+
+    if (ctStored != ctFrames) {
+      ThrowF_t(TRANS("expected %d frames but replayed %d"), ctStored, ctFrames);
+    }
+
+    INDEX ctDiffer = 0;
+
+    for (INDEX iFrame = 0; iFrame < ctFrames; iFrame++) {
+      ULONG ulStored;
+      strm >> ulStored;
+
+      if (ulStored == aulHashes[iFrame]) continue;
+
+      // Only print the first few
+      if (ctDiffer++ < 10) {
+        CPrintF(TRANS("  Frame %d: 0x%08X instead of 0x%08X\n"), iFrame, aulHashes[iFrame], ulStored);
+      }
+    }
+
+    if (ctDiffer == 0) {
+      CPrintF(TRANS("All %d HUD frames match stored draw hashes\n"), ctFrames);
+    } else {
+      CPrintF(TRANS("%d of %d HUD frames differ from stored draw hashes\n"), ctDiffer, ctFrames);
+    }
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot check draw hashes in '%s': %s\n"), fnmHashes.str_String, strError);
+  }
+};
+
+// Replay HUD snapshots from a file the next time the HUD is rendered and check their draw hashes
+void ReplayDrawHashes(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const CTString &strFile = *NEXT_ARG(CTString *);
+
+  _HUD._fnmReplay = CTFileName(strFile);
+  _HUD._bHashReplay = TRUE;
+  CPrintF(TRANS("Draw hashes of HUD snapshots from '%s' will be checked on the next frame\n"), strFile.str_String);
+};
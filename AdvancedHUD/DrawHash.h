@@ -0,0 +1,72 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#ifndef CECIL_INCL_DRAWHASH_H
+#define CECIL_INCL_DRAWHASH_H
+
+#ifdef PRAGMA_ONCE
+  #pragma once
+#endif
+
+struct HudQuad;
+
+// Draw commands are being hashed
+extern BOOL _bHashDraws;
+
+// Add raw data to the hash of the current frame
+void HashDrawData(const void *pData, SLONG slSize);
+
+// Add texture to the hash by its file name
+void HashDrawTextureData(CTextureObject *pto);
+
+// Add quad with texture coordinates to the hash
+void HashDrawQuadData(const HudQuad &quad);
+
+// Add rectangle with an entire texture or a fill to the hash
+void HashDrawRectData(FLOAT fI0, FLOAT fJ0, FLOAT fI1, FLOAT fJ1, COLOR col);
+
+// Add text line printed with a certain font to the hash
+void HashDrawTextData(const CFontData *pfd, FLOAT fScaling, const CTString &strText, FLOAT fX, FLOAT fY, COLOR col);
+
+// Checks that cost nothing while not hashing
+inline void HashDrawTexture(CTextureObject *pto) {
+  if (_bHashDraws) HashDrawTextureData(pto);
+};
+
+inline void HashDrawQuad(const HudQuad &quad) {
+  if (_bHashDraws) HashDrawQuadData(quad);
+};
+
+inline void HashDrawRect(FLOAT fI0, FLOAT fJ0, FLOAT fI1, FLOAT fJ1, COLOR col) {
+  if (_bHashDraws) HashDrawRectData(fI0, fJ0, fI1, fJ1, col);
+};
+
+inline void HashDrawText(const CFontData *pfd, FLOAT fScaling, const CTString &strText, FLOAT fX, FLOAT fY, COLOR col) {
+  if (_bHashDraws) HashDrawTextData(pfd, fScaling, strText, fX, fY, col);
+};
+
+// Start hashing draw commands of a new frame
+void BeginDrawHash(void);
+
+// Stop hashing and return the hash of the frame
+ULONG EndDrawHash(void);
+
+// Compare frame hashes of recorded snapshots with stored ones or store them if there are none
+void CheckDrawHashes(const CTFileName &fnmSnapshots, const CStaticStackArray<ULONG> &aulHashes, PIX pixW, PIX pixH, INDEX iTheme);
+
+// Replay HUD snapshots from a file the next time the HUD is rendered and check their draw hashes
+void ReplayDrawHashes(SHELL_FUNC_ARGS);
+
+#endif
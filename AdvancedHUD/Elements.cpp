@@ -33,32 +33,22 @@ void CHud::PrepareColorTransitions(COLOR colFine, COLOR colHigh, COLOR colMedium
 };
 
 // Calculate shake amount and color value depending on value change
-COLOR CHud::AddShaker(const PIX pixAmount, const INDEX iCurrentValue, INDEX &iLastValue,
-                      FLOAT &tmChanged, FLOAT &fMoverX, FLOAT &fMoverY)
+COLOR CHud::AddShaker(const PIX pixAmount, const HudValueHistory &hist, FLOAT &fMoverX, FLOAT &fMoverY)
 {
-  // Update shaking if needed
+  // Changes are recorded per tick, so only the time since then is needed
   fMoverX = 0.0f;
   fMoverY = 0.0f;
 
-  const TIME tmNow = _pTimer->GetLerpedCurrentTick();
+  const TIME tmNow = _snap.tmLerped;
+  const INDEX iCurrentValue = hist.iCurr;
   #define SHAKE_TIME (2.0f)
 
-  if (iCurrentValue != iLastValue) {
-    iLastValue = iCurrentValue;
-    tmChanged  = tmNow;
-
-  } else {
-    // In case of loading (timer got reset)
-    tmChanged = ClampUp((FLOAT)tmChanged, (FLOAT)tmNow);
-  }
-
-  const TIME tmDelta = tmNow - tmChanged;
+  // Lerped time can be slightly behind the tick of the change
+  const TIME tmDelta = ClampDn(tmNow - hist.tmChanged, (TIME)0.0f);
 
   // No shake
   if (tmDelta > SHAKE_TIME) return NONE;
 
-  ASSERT(tmDelta >= 0);
-
   // Add shake
   const FLOAT fAmount = _vScaling(1) * _fCustomScaling * pixAmount;
   const FLOAT fMultiplier = (SHAKE_TIME - tmDelta) / SHAKE_TIME * fAmount;
@@ -79,6 +69,16 @@ COLOR CHud::AddShaker(const PIX pixAmount, const INDEX iCurrentValue, INDEX &iLa
   return NONE;
 };
 
+// Get number to display for a value that may be counting towards the current one
+INDEX CHud::GetCounterValue(const HudValueHistory &hist)
+{
+  if (!_psSmoothCounters.GetIndex()) return hist.iCurr;
+
+  // Count over a quarter of a second
+  const FLOAT fValue = hist.Interpolate(_snap.tmLerped, 0.25f);
+  return (hist.iCurr > hist.iPrev) ? (INDEX)floor(fValue) : (INDEX)ceil(fValue);
+};
+
 // Get current color from local color transitions table
 COLOR CHud::GetCurrentColor(FLOAT fNormValue)
 {
@@ -151,9 +151,18 @@ void CHud::GatherPlayers(void) {
 };
 
 // Fill array with players sorted by a specific statistic
-void CHud::SetAllPlayersStats(CDynamicContainer<CPlayer> &cen, INDEX iSortKey) {
+void CHud::SortPlayers(CStaticStackArray<HudPlayerInfo *> &apSorted, INDEX iSortKey) {
   // Copy all players
-  cen.CopyArray(_cenPlayers);
+  const INDEX ctPlayers = _snap.aPlayers.Count();
+  apSorted.PopAll();
+
+  if (ctPlayers == 0) return;
+
+  apSorted.Push(ctPlayers);
+
+  for (INDEX iPlayer = 0; iPlayer < ctPlayers; iPlayer++) {
+    apSorted[iPlayer] = &_snap.aPlayers[iPlayer];
+  }
 
   // Pick sorting function
   typedef int (*CSortingFunc)(const void *, const void *);
@@ -169,12 +178,34 @@ void CHud::SetAllPlayersStats(CDynamicContainer<CPlayer> &cen, INDEX iSortKey) {
 
   // Sort the array
   if (iSortKey >= 0 && iSortKey < 6) {
-    qsort(cen.sa_Array, cen.Count(), sizeof(CPlayer *), apFunctions[iSortKey]);
+    qsort(&apSorted[0], ctPlayers, sizeof(HudPlayerInfo *), apFunctions[iSortKey]);
   }
 };
 
 // Draw border using a tile texture
 void CHud::DrawBorder(FLOAT fX, FLOAT fY, FLOAT fW, FLOAT fH, COLOR colTiles)
+{
+  _pdp->InitTexture(&tex.toTile, TRUE);
+  HashDrawTexture(&tex.toTile);
+  AddBorderQuads(fX, fY, fW, fH, colTiles);
+  _pdp->FlushRenderingQueue();
+};
+
+// Add border quads to the rendering queue with the tile texture already set
+void CHud::AddBorderQuads(FLOAT fX, FLOAT fY, FLOAT fW, FLOAT fH, COLOR colTiles)
+{
+  HudQuad aQuads[9];
+  GetBorderQuads(fX, fY, fW, fH, colTiles, aQuads);
+
+  for (INDEX iQuad = 0; iQuad < 9; iQuad++) {
+    const HudQuad &q = aQuads[iQuad];
+    HashDrawQuad(q);
+    _pdp->AddTexture(q.fI0, q.fJ0, q.fI1, q.fJ1, q.fU0, q.fV0, q.fU1, q.fV1, q.col);
+  }
+};
+
+// Calculate quads of a border that uses a tile texture
+void CHud::GetBorderQuads(FLOAT fX, FLOAT fY, FLOAT fW, FLOAT fH, COLOR colTiles, HudQuad aQuads[9])
 {
   // Determine location
   const FLOAT fCenterI = fX * _vScaling(1);
@@ -195,22 +226,29 @@ void CHud::DrawBorder(FLOAT fX, FLOAT fY, FLOAT fW, FLOAT fH, COLOR colTiles)
 
   colTiles |= _ulAlphaHUD;
 
+  #define SET_QUAD(_iQuad, _fI0, _fJ0, _fI1, _fJ1, _fU0, _fV0, _fU1, _fV1) { \
+    HudQuad &q = aQuads[_iQuad]; \
+    q.fI0 = _fI0; q.fJ0 = _fJ0; q.fI1 = _fI1; q.fJ1 = _fJ1; \
+    q.fU0 = _fU0; q.fV0 = _fV0; q.fU1 = _fU1; q.fV1 = _fV1; \
+    q.col = colTiles; \
+  }
+
   // Put corners
-  _pdp->InitTexture(&tex.toTile, TRUE);
-  _pdp->AddTexture(fLeft,  fUp,   fLeftEnd,  fUpEnd,   colTiles);
-  _pdp->AddTexture(fRight, fUp,   fRightBeg, fUpEnd,   colTiles);
-  _pdp->AddTexture(fRight, fDown, fRightBeg, fDownBeg, colTiles);
-  _pdp->AddTexture(fLeft,  fDown, fLeftEnd,  fDownBeg, colTiles);
+  SET_QUAD(0, fLeft,  fUp,   fLeftEnd,  fUpEnd,   0.0f, 0.0f, 1.0f, 1.0f);
+  SET_QUAD(1, fRight, fUp,   fRightBeg, fUpEnd,   0.0f, 0.0f, 1.0f, 1.0f);
+  SET_QUAD(2, fRight, fDown, fRightBeg, fDownBeg, 0.0f, 0.0f, 1.0f, 1.0f);
+  SET_QUAD(3, fLeft,  fDown, fLeftEnd,  fDownBeg, 0.0f, 0.0f, 1.0f, 1.0f);
 
   // Put edges
-  _pdp->AddTexture(fLeftEnd, fUp,    fRightBeg, fUpEnd,   0.4f, 0.0f, 0.6f, 1.0f, colTiles);
-  _pdp->AddTexture(fLeftEnd, fDown,  fRightBeg, fDownBeg, 0.4f, 0.0f, 0.6f, 1.0f, colTiles);
-  _pdp->AddTexture(fLeft,    fUpEnd, fLeftEnd,  fDownBeg, 0.0f, 0.4f, 1.0f, 0.6f, colTiles);
-  _pdp->AddTexture(fRight,   fUpEnd, fRightBeg, fDownBeg, 0.0f, 0.4f, 1.0f, 0.6f, colTiles);
+  SET_QUAD(4, fLeftEnd, fUp,    fRightBeg, fUpEnd,   0.4f, 0.0f, 0.6f, 1.0f);
+  SET_QUAD(5, fLeftEnd, fDown,  fRightBeg, fDownBeg, 0.4f, 0.0f, 0.6f, 1.0f);
+  SET_QUAD(6, fLeft,    fUpEnd, fLeftEnd,  fDownBeg, 0.0f, 0.4f, 1.0f, 0.6f);
+  SET_QUAD(7, fRight,   fUpEnd, fRightBeg, fDownBeg, 0.0f, 0.4f, 1.0f, 0.6f);
 
   // Fill center
-  _pdp->AddTexture(fLeftEnd, fUpEnd, fRightBeg, fDownBeg, 0.4f, 0.4f, 0.6f, 0.6f, colTiles);
-  _pdp->FlushRenderingQueue();
+  SET_QUAD(8, fLeftEnd, fUpEnd, fRightBeg, fDownBeg, 0.4f, 0.4f, 0.6f, 0.6f);
+
+  #undef SET_QUAD
 };
 
 // Draw icon texture
@@ -230,11 +268,42 @@ void CHud::DrawIcon(FLOAT fX, FLOAT fY, CTextureObject &toIcon, COLOR colDefault
   CTextureData *ptd = (CTextureData *)toIcon.GetData();
   const FLOAT fSize = 16 * _vScaling(1) * _fCustomScaling;
 
+  HashDrawTexture(&toIcon);
+  HashDrawRect(fCenterI - fSize, fCenterJ - fSize, fCenterI + fSize, fCenterJ + fSize, colDefault | _ulAlphaHUD);
+
   _pdp->InitTexture(&toIcon);
   _pdp->AddTexture(fCenterI - fSize, fCenterJ - fSize, fCenterI + fSize, fCenterJ + fSize, colDefault | _ulAlphaHUD);
   _pdp->FlushRenderingQueue();
 };
 
+// Print text aligned to the right using cached text widths
+void CHud::PrintRight(const CTString &strText, PIX pixX, PIX pixY, COLOR col)
+{
+  const PIX pixTextX = pixX - GetCachedTextWidth(_pdp, strText);
+
+  HashDrawText(_pdp->dp_FontData, _pdp->dp_fTextScaling, strText, pixTextX, pixY, col);
+  _pdp->PutText(strText, pixTextX, pixY, col);
+};
+
+// Print text centered horizontally using cached text widths
+void CHud::PrintCentered(const CTString &strText, PIX pixX, PIX pixY, COLOR col)
+{
+  const PIX pixTextX = pixX - GetCachedTextWidth(_pdp, strText) / 2;
+
+  HashDrawText(_pdp->dp_FontData, _pdp->dp_fTextScaling, strText, pixTextX, pixY, col);
+  _pdp->PutText(strText, pixTextX, pixY, col);
+};
+
+// Print text centered on both axes using cached text widths
+void CHud::PrintCenteredXY(const CTString &strText, PIX pixX, PIX pixY, COLOR col)
+{
+  const PIX pixTextHeight = _pdp->dp_FontData->fd_pixCharHeight * _pdp->dp_fTextScaling;
+  const PIX pixTextX = pixX - GetCachedTextWidth(_pdp, strText) / 2;
+
+  HashDrawText(_pdp->dp_FontData, _pdp->dp_fTextScaling, strText, pixTextX, pixY - pixTextHeight / 2, col);
+  _pdp->PutText(strText, pixTextX, pixY - pixTextHeight / 2, col);
+};
+
 // Draw text
 void CHud::DrawString(FLOAT fX, FLOAT fY, const CTString &strText, COLOR colDefault, FLOAT fNormValue)
 {
@@ -242,7 +311,7 @@ void CHud::DrawString(FLOAT fX, FLOAT fY, const CTString &strText, COLOR colDefa
   const FLOAT fFontScaling = (FLOAT)_pfdCurrentNumbers->GetHeight() * 0.03125f; // (1 / 32)
 
   _pdp->SetTextScaling(_vScaling(1) * _fCustomScaling / fFontScaling);
-  _pdp->PutTextCXY(strText, fX * _vScaling(1), fY * _vScaling(2), colDefault | _ulAlphaHUD);
+  PrintCenteredXY(strText, fX * _vScaling(1), fY * _vScaling(2), colDefault | _ulAlphaHUD);
 };
 
 // Draw percentage bar
@@ -277,6 +346,9 @@ void CHud::DrawBar(FLOAT fX, FLOAT fY, PIX pixW, PIX pixH, EBarDir eBarDir, COLO
       break;
   }
 
+  HashDrawTexture(NULL);
+  HashDrawRect(pixLeft, pixUpper, pixLeft + pixSizeI, pixUpper + pixSizeJ, colDefault | _ulAlphaHUD);
+
   _pdp->Fill(pixLeft, pixUpper, pixSizeI, pixSizeJ, colDefault | _ulAlphaHUD);
 };
 
@@ -299,6 +371,10 @@ void CHud::DrawRotatedQuad(CTextureObject *pto, FLOAT fX, FLOAT fY, FLOAT fSize,
   FLOAT fI3 = fX - fSinMCos;
   FLOAT fJ3 = fY + fSinPCos;
 
+  HashDrawTexture(pto);
+  HashDrawRect(fI0, fJ0, fI1, fJ1, col);
+  HashDrawRect(fI2, fJ2, fI3, fJ3, col);
+
   _pdp->InitTexture(pto);
   _pdp->AddTexture(fI0, fJ0, 0, 0, col, fI1, fJ1, 0, 1, col, fI2, fJ2, 1, 1, col, fI3, fJ3, 1, 0, col);
   _pdp->FlushRenderingQueue();  
@@ -310,6 +386,9 @@ void CHud::DrawCorrectTexture(CTextureObject *pto, FLOAT fX, FLOAT fY, FLOAT fWi
   FLOAT fTexSizeJ = ptd->GetPixHeight();
   FLOAT fHeight = fWidth * fTexSizeJ / fTexSizeJ;
 
+  HashDrawTexture(pto);
+  HashDrawRect(fX - fWidth * 0.5f, fY - fHeight * 0.5f, fX + fWidth * 0.5f, fY + fHeight * 0.5f, col);
+
   _pdp->InitTexture(pto);
   _pdp->AddTexture(fX - fWidth * 0.5f, fY - fHeight * 0.5f, fX + fWidth * 0.5f, fY + fHeight * 0.5f, 0, 0, 1, 1, col);
   _pdp->FlushRenderingQueue();
@@ -330,27 +409,46 @@ void CHud::DrawSniperMask(void) {
   COLOR colMask = 0xFFFFFF00 | ubScopeAlpha;
 
   // Sniper mask
+  const HudQuad aQuads[4] = {
+    { fBorder, 0,  fX,           fY, 0.98f, 0.02f,  0.0f,  1.0f, colMask },
+    { fX,      0,  fW - fBorder, fY,  0.0f, 0.02f, 0.98f,  1.0f, colMask },
+    { fBorder, fY, fX,           fH, 0.98f,  1.0f,  0.0f, 0.02f, colMask },
+    { fX,      fY, fW - fBorder, fH,  0.0f,  1.0f, 0.98f, 0.02f, colMask },
+  };
+
   _pdp->InitTexture(&tex.toSniperMask);
-  _pdp->AddTexture(fBorder, 0,  fX,           fY, 0.98f, 0.02f,  0.0f,  1.0f, colMask);
-  _pdp->AddTexture(fX,      0,  fW - fBorder, fY,  0.0f, 0.02f, 0.98f,  1.0f, colMask);
-  _pdp->AddTexture(fBorder, fY, fX,           fH, 0.98f,  1.0f,  0.0f, 0.02f, colMask);
-  _pdp->AddTexture(fX,      fY, fW - fBorder, fH,  0.0f,  1.0f, 0.98f, 0.02f, colMask);
+  HashDrawTexture(&tex.toSniperMask);
+
+  for (INDEX iQuad = 0; iQuad < 4; iQuad++) {
+    const HudQuad &q = aQuads[iQuad];
+    HashDrawQuad(q);
+    _pdp->AddTexture(q.fI0, q.fJ0, q.fI1, q.fJ1, q.fU0, q.fV0, q.fU1, q.fV1, q.col);
+  }
+
   _pdp->FlushRenderingQueue();
 
   // Side borders
+  HashDrawTexture(NULL);
+  HashDrawRect(0, 0, fBorder, fH, C_BLACK | ubScopeAlpha);
+  HashDrawRect(fW - fBorder, 0, fW, fH, C_BLACK | ubScopeAlpha);
+
   _pdp->Fill(0,            0, fBorder, fH, C_BLACK | ubScopeAlpha);
   _pdp->Fill(fW - fBorder, 0, fBorder, fH, C_BLACK | ubScopeAlpha);
 
   // Center dot with inverted alpha
   const PIX pixDotSize = 2 * _vScaling(1);
-  _pdp->Fill(fX - (pixDotSize >> 1), fY - (pixDotSize >> 1), pixDotSize, pixDotSize, C_BLACK | UBYTE(~ubScopeAlpha));
+  const PIX pixDotX = fX - (pixDotSize >> 1);
+  const PIX pixDotY = fY - (pixDotSize >> 1);
+  HashDrawRect(pixDotX, pixDotY, pixDotX + pixDotSize, pixDotY + pixDotSize, C_BLACK | UBYTE(~ubScopeAlpha));
+
+  _pdp->Fill(pixDotX, pixDotY, pixDotSize, pixDotSize, C_BLACK | UBYTE(~ubScopeAlpha));
 
   colMask = LerpColor(COL_ScopeMask(), C_WHITE, 0.25f);
 
   FLOAT fScalingY = fH / 480.0f;
 
-  FLOAT fDistance = _penWeapons->m_fRayHitDistance;
-  FLOAT aFOV = Lerp(_penWeapons->m_fSniperFOVlast, _penWeapons->m_fSniperFOV, _pTimer->GetLerpFactor());
+  FLOAT fDistance = _snap.fRayHitDistance;
+  FLOAT aFOV = _snap.fSniperFOV;
 
   // Zoom wheel
   FLOAT fZoom = 1.0f / tan(RadAngle(aFOV) * 0.5f); // 2.0 - 8.0
@@ -359,7 +457,7 @@ void CHud::DrawSniperMask(void) {
   ANGLE aAngle = 314.0f + fAFact * 292.0f;
 
   COLOR colSniperWheel = colMask | 0x44;
-  const FLOAT fEnemyHealth = _penWeapons->m_fEnemyHealth;
+  const FLOAT fEnemyHealth = _snap.fEnemyHealth;
 
   if (_psScopeColoring.GetIndex()) {
     if (fEnemyHealth > 0.0f) {
@@ -385,7 +483,7 @@ void CHud::DrawSniperMask(void) {
   COLOR colLED;
 
   // Blinking
-  if (_penWeapons->m_tmLastSniperFire + 1.25f < _pTimer->GetLerpedCurrentTick()) {
+  if (_snap.tmLastSniperFire + 1.25f < _snap.tmLerped) {
     colLED = COL_ScopeLedIdle();
   } else {
     colLED = COL_ScopeLedFire();
@@ -437,7 +535,7 @@ void CHud::DrawSniperMask(void) {
       strTmp.PrintF("%.1f", fDistance);
     }
 
-    _pdp->PutTextC(strTmp, fX - fLeftX * fScalingY, fY + fLeftYD * fScalingY, colMask | 0xAA);
+    PrintCentered(strTmp, fX - fLeftX * fScalingY, fY + fLeftYD * fScalingY, colMask | 0xAA);
 
     // Eye + zoom level
     DrawCorrectTexture(&tex.toSniperEye, fX + fRightX * fScalingY,
@@ -445,7 +543,7 @@ void CHud::DrawSniperMask(void) {
 
     strTmp.PrintF("%.1fx", fZoom);
 
-    _pdp->PutTextC(strTmp, fX + fRightX * fScalingY, fY + fRightYD * fScalingY, colMask | 0xAA);
+    PrintCentered(strTmp, fX + fRightX * fScalingY, fY + fRightYD * fScalingY, colMask | 0xAA);
   }
 };
 
@@ -0,0 +1,248 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "FontMetrics.h"
+
+// Amount of advance tables for different text settings
+#define ADVANCE_TABLES 8
+
+// Amount of measured strings that are remembered
+#define WIDTH_CACHE_SIZE 64
+
+static HudGlyphAdvances _aAdvances[ADVANCE_TABLES];
+static INDEX _iNextAdvances = 0;
+static ULONG _ulLastSerial = 0;
+
+// Measured string
+struct HudCachedWidth {
+  ULONG ulSerial; // Advance table that has been used (0 if none)
+  INDEX iTextMode;
+  ULONG ulHash;
+  CTString strText;
+  PIX pixWidth;
+
+  HudCachedWidth() : ulSerial(0) {};
+};
+
+static HudCachedWidth _aCachedWidths[WIDTH_CACHE_SIZE];
+
+// Statistics
+static INDEX _ctWidthHits = 0;
+static INDEX _ctWidthMisses = 0;
+
+// Get advance table for current text settings of a drawport
+const HudGlyphAdvances &GetGlyphAdvances(const CDrawPort *pdp) {
+  const CFontData *pfd = pdp->dp_FontData;
+  const SLONG fixScalingX = FloatToInt(pdp->dp_fTextScaling * pdp->dp_fTextAspect * 65536.0f);
+  const PIX pixCharSpacing = pdp->dp_pixTextCharSpacing;
+
+  for (INDEX iTable = 0; iTable < ADVANCE_TABLES; iTable++) {
+    if (_aAdvances[iTable].Matches(pfd, fixScalingX, pixCharSpacing)) {
+      return _aAdvances[iTable];
+    }
+  }
+
+  // Replace the oldest table
+  HudGlyphAdvances &adv = _aAdvances[_iNextAdvances];
+  _iNextAdvances = (_iNextAdvances + 1) % ADVANCE_TABLES;
+
+  adv.pfd = pfd;
+  adv.bFixedWidth = pfd->fd_bFixedWidth;
+  adv.fixScalingX = fixScalingX;
+  adv.pixCharSpacing = pixCharSpacing;
+  adv.ulSerial = ++_ulLastSerial;
+
+  PIX pixCharStart = 0;
+  PIX pixCharEnd = pfd->fd_pixCharWidth;
+
+  for (INDEX iChar = 0; iChar < 256; iChar++) {
+    // Proportional font
+    if (!adv.bFixedWidth) {
+      pixCharStart = pfd->fd_fcdFontCharData[iChar].fcd_pixStart;
+      pixCharEnd   = pfd->fd_fcdFontCharData[iChar].fcd_pixEnd;
+    }
+
+    adv.apixAdvance[iChar] = (((pixCharEnd - pixCharStart) * fixScalingX) >> 16) + pixCharSpacing;
+  }
+
+  return adv;
+};
+
+// Count characters until the end of the string up to some limit
+static INDEX CountUntilEnd(const char *str, INDEX ctMax) {
+  INDEX ct = 0;
+  while (ct < ctMax && str[ct] != '\0') ct++;
+  return ct;
+};
+
+// Measure text the same way the drawport does but using an advance table
+PIX MeasureText(const HudGlyphAdvances &adv, const CTString &strText, INDEX iTextMode) {
+  const char *str = strText.str_String;
+  const INDEX ctLength = strlen(str);
+
+  PIX pixWidth = 0;
+  PIX pixLongest = 0;
+
+  for (INDEX i = 0; i < ctLength; i++) {
+    UBYTE ch = str[i];
+
+    // Start the next line
+    if (ch == '\n') {
+      pixLongest = Max(pixLongest, pixWidth);
+      pixWidth = 0;
+      continue;
+    }
+
+    // Skip special codes
+    if (ch == '^' && iTextMode != -1) {
+      ch = str[++i];
+
+      switch (ch) {
+        case 'c': i += CountUntilEnd(str + i, 6); continue;
+        case 'a': i += CountUntilEnd(str + i, 2); continue;
+        case 'f': i += 1; continue;
+
+        case 'b': case 'i': case 'r': case 'o':
+        case 'C': case 'A': case 'F': case 'B': case 'I':
+          continue;
+      }
+
+    } else if (ch == '\t') {
+      continue;
+    }
+
+    pixWidth += adv.apixAdvance[ch];
+  }
+
+  return Max(pixLongest, pixWidth);
+};
+
+// Get text width using widths of recurring strings that have already been measured
+PIX GetCachedTextWidth(const HudGlyphAdvances &adv, const CTString &strText, INDEX iTextMode) {
+  // Hash the string with the table it's measured with
+  ULONG ulHash = 2166136261UL ^ adv.ulSerial;
+
+  for (const char *pch = strText.str_String; *pch != '\0'; pch++) {
+    ulHash = (ulHash ^ UBYTE(*pch)) * 16777619UL;
+  }
+
+  HudCachedWidth &cw = _aCachedWidths[ulHash % WIDTH_CACHE_SIZE];
+
+  if (cw.ulSerial == adv.ulSerial && cw.iTextMode == iTextMode && cw.ulHash == ulHash && cw.strText == strText) {
+    _ctWidthHits++;
+    return cw.pixWidth;
+  }
+
+  _ctWidthMisses++;
+
+  cw.ulSerial = adv.ulSerial;
+  cw.iTextMode = iTextMode;
+  cw.ulHash = ulHash;
+  cw.strText = strText;
+  cw.pixWidth = MeasureText(adv, strText, iTextMode);
+
+  return cw.pixWidth;
+};
+
+// Compare cached text widths with the drawport measurement using various fonts and settings
+void VerifyTextWidths(CDrawPort *pdp, CFontData **apfd, INDEX ctFonts) {
+  static const char *astrTexts[] = {
+    "god", "fly", "ghost", "invisible", "turbo",
+    "0123456789", "/", " 100ms", "---.-", "12.5x",
+    "TIME LEFT: 04:59", "FRAGS LEFT: 10\nSCORE LEFT: 5000",
+    "^cFF0000Red^r name", "^a80half^A alpha", "^bbold^B ^iitalic^I", "tab\there", "caret ^^ sign", "broken ^",
+  };
+
+  static const FLOAT afScaling[] = { 0.5f, 0.8f, 1.0f, 1.37f, 2.0f };
+  static const FLOAT afAspect[] = { 1.0f, 0.75f };
+  static const PIX apixSpacing[] = { 0, -2, 1 };
+  static const INDEX aiTextMode[] = { 1, 0, -1 };
+
+  const INDEX ctTexts = ARRAYCOUNT(astrTexts);
+
+  // Keep current text settings
+  CFontData *pfdOld = pdp->dp_FontData;
+  const FLOAT fOldScaling = pdp->dp_fTextScaling;
+  const FLOAT fOldAspect = pdp->dp_fTextAspect;
+  const PIX pixOldSpacing = pdp->dp_pixTextCharSpacing;
+  const INDEX iOldMode = pdp->dp_iTextMode;
+
+  INDEX ctChecked = 0;
+  INDEX ctFailed = 0;
+
+  for (INDEX iFont = 0; iFont < ctFonts; iFont++) {
+    CFontData *pfd = apfd[iFont];
+    if (pfd == NULL || pfd->fd_ptdTextureData == NULL) continue;
+
+    const BOOL bOldFixed = pfd->fd_bFixedWidth;
+    pdp->SetFont(pfd);
+
+    for (INDEX iFixed = 0; iFixed < 2; iFixed++) {
+      if (iFixed) {
+        pfd->SetFixedWidth();
+      } else {
+        pfd->SetVariableWidth();
+      }
+
+      for (INDEX iScaling = 0; iScaling < ARRAYCOUNT(afScaling); iScaling++)
+      for (INDEX iAspect = 0; iAspect < ARRAYCOUNT(afAspect); iAspect++)
+      for (INDEX iSpacing = 0; iSpacing < ARRAYCOUNT(apixSpacing); iSpacing++)
+      for (INDEX iMode = 0; iMode < ARRAYCOUNT(aiTextMode); iMode++)
+      {
+        pdp->SetTextScaling(afScaling[iScaling]);
+        pdp->SetTextAspect(afAspect[iAspect]);
+        pdp->SetTextCharSpacing(apixSpacing[iSpacing]);
+        pdp->SetTextMode(aiTextMode[iMode]);
+
+        for (INDEX iText = 0; iText < ctTexts; iText++) {
+          const CTString strText = astrTexts[iText];
+          const PIX pixEngine = pdp->GetTextWidth(strText);
+
+          // Measure twice to check the cached width as well
+          const PIX pixMeasured = GetCachedTextWidth(pdp, strText);
+          const PIX pixCached = GetCachedTextWidth(pdp, strText);
+          ctChecked++;
+
+          if (pixMeasured == pixEngine && pixCached == pixEngine) continue;
+
+          // Only print the first few
+          if (ctFailed++ < 10) {
+            CPrintF(TRANS("  '%s' in '%s' (scaling: %.2f, aspect: %.2f, spacing: %d, mode: %d): %d / %d instead of %d\n"),
+              strText.str_String, pfd->fd_fnTexture.str_String, afScaling[iScaling], afAspect[iAspect],
+              apixSpacing[iSpacing], aiTextMode[iMode], pixMeasured, pixCached, pixEngine);
+          }
+        }
+      }
+    }
+
+    // Restore font width
+    if (bOldFixed) {
+      pfd->SetFixedWidth();
+    } else {
+      pfd->SetVariableWidth();
+    }
+  }
+
+  pdp->SetFont(pfdOld);
+  pdp->SetTextScaling(fOldScaling);
+  pdp->SetTextAspect(fOldAspect);
+  pdp->SetTextCharSpacing(pixOldSpacing);
+  pdp->SetTextMode(iOldMode);
+
+  CPrintF(TRANS("Text widths: %d of %d differ from the drawport (%d cache hits, %d misses so far)\n"),
+    ctFailed, ctChecked, _ctWidthHits, _ctWidthMisses);
+};
@@ -0,0 +1,60 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#ifndef CECIL_INCL_FONTMETRICS_H
+#define CECIL_INCL_FONTMETRICS_H
+
+#ifdef PRAGMA_ONCE
+  #pragma once
+#endif
+
+// Horizontal advances of all characters of a font at a certain scale
+struct HudGlyphAdvances {
+  // Text settings that the table has been made for
+  const CFontData *pfd;
+  BOOL bFixedWidth;
+  SLONG fixScalingX; // Horizontal scaling with aspect ratio in 16.16 fixed point
+  PIX pixCharSpacing;
+
+  ULONG ulSerial; // Changes every time the table is made again
+  PIX apixAdvance[256];
+
+  HudGlyphAdvances() : pfd(NULL), ulSerial(0) {};
+
+  // Check if the table is made for specific text settings
+  inline BOOL Matches(const CFontData *pfdCheck, SLONG fixScaling, PIX pixSpacing) const {
+    return pfd == pfdCheck && bFixedWidth == pfdCheck->fd_bFixedWidth
+        && fixScalingX == fixScaling && pixCharSpacing == pixSpacing;
+  };
+};
+
+// Get advance table for current text settings of a drawport
+const HudGlyphAdvances &GetGlyphAdvances(const CDrawPort *pdp);
+
+// Measure text the same way the drawport does but using an advance table
+PIX MeasureText(const HudGlyphAdvances &adv, const CTString &strText, INDEX iTextMode);
+
+// Get text width using widths of recurring strings that have already been measured
+PIX GetCachedTextWidth(const HudGlyphAdvances &adv, const CTString &strText, INDEX iTextMode);
+
+// Get text width for current text settings of a drawport
+inline PIX GetCachedTextWidth(const CDrawPort *pdp, const CTString &strText) {
+  return GetCachedTextWidth(GetGlyphAdvances(pdp), strText, pdp->dp_iTextMode);
+};
+
+// Compare cached text widths with the drawport measurement using various fonts and settings
+void VerifyTextWidths(CDrawPort *pdp, CFontData **apfd, INDEX ctFonts);
+
+#endif
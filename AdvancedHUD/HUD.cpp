@@ -35,33 +35,17 @@ CHud::CGetMaxAmmoFunc   CHud::pGetMaxAmmo = NULL;
 // Update weapon and ammo tables with current info
 void CHud::UpdateWeaponArsenal(void) {
   // Ammo quantities
-  GetAmmo()[0].iAmmo    = _penWeapons->m_iShells;
-  GetAmmo()[0].iMaxAmmo = _penWeapons->m_iMaxShells;
-  GetAmmo()[1].iAmmo    = _penWeapons->m_iBullets;
-  GetAmmo()[1].iMaxAmmo = _penWeapons->m_iMaxBullets;
-  GetAmmo()[2].iAmmo    = _penWeapons->m_iRockets;
-  GetAmmo()[2].iMaxAmmo = _penWeapons->m_iMaxRockets;
-  GetAmmo()[3].iAmmo    = _penWeapons->m_iGrenades;
-  GetAmmo()[3].iMaxAmmo = _penWeapons->m_iMaxGrenades;
-
-#if SE1_GAME != SS_TFE
-  GetAmmo()[4].iAmmo    = _penWeapons->m_iNapalm;
-  GetAmmo()[4].iMaxAmmo = _penWeapons->m_iMaxNapalm;
-  GetAmmo()[5].iAmmo    = _penWeapons->m_iSniperBullets;
-  GetAmmo()[5].iMaxAmmo = _penWeapons->m_iMaxSniperBullets;
-#endif
-
-  GetAmmo()[6].iAmmo    = _penWeapons->m_iElectricity;
-  GetAmmo()[6].iMaxAmmo = _penWeapons->m_iMaxElectricity;
-  GetAmmo()[7].iAmmo    = _penWeapons->m_iIronBalls;
-  GetAmmo()[7].iMaxAmmo = _penWeapons->m_iMaxIronBalls;
+  for (INDEX iAmmo = 0; iAmmo < HUD_AMMO_SLOTS; iAmmo++) {
+    GetAmmo()[iAmmo].iAmmo    = _snap.aiAmmo[iAmmo];
+    GetAmmo()[iAmmo].iMaxAmmo = _snap.aiMaxAmmo[iAmmo];
+  }
 
   // Prepare ammo table for weapon possesion
   for (INDEX i = 0; i < GetAmmo().Count(); i++) {
     GetAmmo()[i].bHasWeapon = FALSE;
   }
 
-  INDEX iAvailableWeapons = _penWeapons->m_iAvailableWeapons;
+  INDEX iAvailableWeapons = _snap.iAvailableWeapons;
 
   // Weapon possesion
   for (INDEX iCheck = 1; iCheck < GetWeapons().Count(); iCheck++) {
@@ -76,12 +60,254 @@ void CHud::UpdateWeaponArsenal(void) {
   }
 };
 
+// Value histories of a viewed player that are kept alongside its last values
+struct HudPlayerHistory {
+  ULONG ulPlayer;
+  HudValueHistory histHealth;
+  HudValueHistory histArmor;
+  HudValueHistory histAmmo;
+};
+
+// Histories of all viewed players
+static CStaticStackArray<HudPlayerHistory> _aPlayerHistories;
+
+// Player and tick of the last detected changes
+static CPlayer *_penHistoryPlayer = NULL;
+static TIME _tmHistoryTick = -1.0f;
+
+// Get stored histories of some player
+static HudPlayerHistory &GetPlayerHistory(CPlayer *pen) {
+  for (INDEX i = 0; i < _aPlayerHistories.Count(); i++) {
+    if (_aPlayerHistories[i].ulPlayer == pen->en_ulID) return _aPlayerHistories[i];
+  }
+
+  // Forget players from previous games
+  if (_aPlayerHistories.Count() >= NET_MAXGAMEPLAYERS * 2) _aPlayerHistories.PopAll();
+
+  HudPlayerHistory &ph = _aPlayerHistories.Push();
+  ph.ulPlayer = pen->en_ulID;
+  ph.histHealth.Reset(pen->m_iLastHealth, pen->m_tmHealthChanged);
+  ph.histArmor.Reset(pen->m_iLastArmor, pen->m_tmArmorChanged);
+  ph.histAmmo.Reset(pen->m_iLastAmmo, pen->m_tmAmmoChanged);
+  return ph;
+};
+
+// Update value history that continues from the last value stored in a player
+static void ContinueHistory(HudValueHistory &hist, HudValueHistory &histPlayer, INDEX &iLastValue, FLOAT &tmLastChanged, INDEX iValue, TIME tmTick) {
+  // Switched to another player
+  if (hist.iCurr != iLastValue || hist.tmChanged != tmLastChanged) {
+    // Continue the interpolation of that player if its last values haven't been changed elsewhere
+    if (histPlayer.iCurr == iLastValue && histPlayer.tmChanged == tmLastChanged) {
+      hist = histPlayer;
+    } else {
+      hist.Reset(iLastValue, tmLastChanged);
+    }
+  }
+
+  hist.Update(iValue, tmTick);
+
+  iLastValue = hist.iCurr;
+  tmLastChanged = hist.tmChanged;
+  histPlayer = hist;
+};
+
+// Gather everything that's needed for rendering from the game
+void CHud::CaptureSnapshot(void) {
+  HudSnapshot &snap = _snap;
+  const CSessionProperties *psp = pGetSP();
+
+  // Time
+  snap.tmTick = _pTimer->CurrentTick();
+  snap.tmLerped = _pTimer->GetLerpedCurrentTick();
+  snap.tmGameTime = _pNetwork->GetGameTime();
+
+  // Session
+  snap.iGameMode = E_GM_SP;
+
+  if (!psp->sp_bSinglePlayer) {
+    if (psp->sp_bCooperative) {
+      snap.iGameMode = E_GM_COOP;
+
+    } else if (!psp->sp_bUseFrags) {
+      snap.iGameMode = E_GM_SCORE;
+
+    } else {
+      snap.iGameMode = E_GM_FRAG;
+    }
+  }
+
+  snap.bInfiniteAmmo = psp->sp_bInfiniteAmmo;
+  snap.ctMaxPlayers = psp->sp_ctMaxPlayers;
+  snap.ctCredits = psp->sp_ctCredits;
+  snap.ctCreditsLeft = psp->sp_ctCreditsLeft;
+  snap.iTimeLimit = psp->sp_iTimeLimit;
+  snap.iFragLimit = psp->sp_iFragLimit;
+  snap.iScoreLimit = psp->sp_iScoreLimit;
+
+#if SE1_GAME != SS_TFE
+  snap.tmSpawnInvul = psp->sp_tmSpawnInvulnerability;
+#else
+  snap.tmSpawnInvul = 0.0f;
+#endif
+
+  // Vitals
+  snap.fHealth = _penPlayer->GetHealth();
+  snap.fArmor = _penPlayer->m_fArmor;
+  snap.bAlive = (_penPlayer->GetFlags() & ENF_ALIVE) ? TRUE : FALSE;
+  snap.bConnected = (pIsConnected_opt != NULL) ? (_penPlayer->*pIsConnected_opt)() : TRUE;
+  snap.tmAirLeft = _penPlayer->en_tmMaxHoldBreath - (snap.tmTick - _penPlayer->en_tmLastBreathed);
+  snap.tmLatency = _penPlayer->m_tmLatency;
+
+  // Arsenal
+  snap.iCurrentWeapon = _penWeapons->m_iCurrentWeapon;
+  snap.iWantedWeapon = _penWeapons->m_iWantedWeapon;
+  snap.iAvailableWeapons = _penWeapons->m_iAvailableWeapons;
+  snap.iCurrentAmmo = (_penWeapons->*pGetAmmo)();
+  snap.iCurrentMaxAmmo = (_penWeapons->*pGetMaxAmmo)();
+  snap.tmWeaponChangeRequired = _penWeapons->m_tmWeaponChangeRequired;
+
+  snap.aiAmmo[0] = _penWeapons->m_iShells;
+  snap.aiMaxAmmo[0] = _penWeapons->m_iMaxShells;
+  snap.aiAmmo[1] = _penWeapons->m_iBullets;
+  snap.aiMaxAmmo[1] = _penWeapons->m_iMaxBullets;
+  snap.aiAmmo[2] = _penWeapons->m_iRockets;
+  snap.aiMaxAmmo[2] = _penWeapons->m_iMaxRockets;
+  snap.aiAmmo[3] = _penWeapons->m_iGrenades;
+  snap.aiMaxAmmo[3] = _penWeapons->m_iMaxGrenades;
+
+#if SE1_GAME != SS_TFE
+  snap.aiAmmo[4] = _penWeapons->m_iNapalm;
+  snap.aiMaxAmmo[4] = _penWeapons->m_iMaxNapalm;
+  snap.aiAmmo[5] = _penWeapons->m_iSniperBullets;
+  snap.aiMaxAmmo[5] = _penWeapons->m_iMaxSniperBullets;
+#else
+  snap.aiAmmo[4] = snap.aiMaxAmmo[4] = 0;
+  snap.aiAmmo[5] = snap.aiMaxAmmo[5] = 0;
+#endif
+
+  snap.aiAmmo[6] = _penWeapons->m_iElectricity;
+  snap.aiMaxAmmo[6] = _penWeapons->m_iMaxElectricity;
+  snap.aiAmmo[7] = _penWeapons->m_iIronBalls;
+  snap.aiMaxAmmo[7] = _penWeapons->m_iMaxIronBalls;
+
+  // Changes of displayed values (the player keeps them between views)
+  // Only detected once per tick or after switching to another player
+  if (snap.tmTick != _tmHistoryTick || _penLast != _penHistoryPlayer) {
+    _tmHistoryTick = snap.tmTick;
+    _penHistoryPlayer = _penLast;
+
+    const INDEX iHealth = (INDEX)ceil(ClampDn(snap.fHealth, 0.0f));
+    const INDEX iArmor = (INDEX)ceil(ClampDn(snap.fArmor, 0.0f));
+    HudPlayerHistory &ph = GetPlayerHistory(_penLast);
+
+    ContinueHistory(snap.histHealth, ph.histHealth, _penLast->m_iLastHealth, _penLast->m_tmHealthChanged, iHealth, snap.tmTick);
+    ContinueHistory(snap.histArmor, ph.histArmor, _penLast->m_iLastArmor, _penLast->m_tmArmorChanged, iArmor, snap.tmTick);
+    ContinueHistory(snap.histAmmo, ph.histAmmo, _penLast->m_iLastAmmo, _penLast->m_tmAmmoChanged, snap.iCurrentAmmo, snap.tmTick);
+
+    for (INDEX iAmmoHist = 0; iAmmoHist < HUD_AMMO_SLOTS; iAmmoHist++) {
+      snap.ahistAmmo[iAmmoHist].Update(snap.aiAmmo[iAmmoHist], snap.tmTick);
+    }
+  }
+
+  // Powerups
+#if SE1_GAME != SS_TFE
+  snap.ctSeriousBombs = _penPlayer->m_iSeriousBombCount;
+  snap.tmSeriousBombFired = _penPlayer->m_tmSeriousBombFired;
+
+  snap.atmPowerups[0] = _penPlayer->m_tmInvisibility;
+  snap.atmPowerups[1] = _penPlayer->m_tmInvulnerability;
+  snap.atmPowerups[2] = _penPlayer->m_tmSeriousDamage;
+  snap.atmPowerups[3] = _penPlayer->m_tmSeriousSpeed;
+
+  snap.atmPowerupsMax[0] = _penPlayer->m_tmInvisibilityMax;
+  snap.atmPowerupsMax[1] = _penPlayer->m_tmInvulnerabilityMax;
+  snap.atmPowerupsMax[2] = _penPlayer->m_tmSeriousDamageMax;
+  snap.atmPowerupsMax[3] = _penPlayer->m_tmSeriousSpeedMax;
+
+  snap.tmSpawned = _penPlayer->m_tmSpawned;
+
+#else
+  snap.ctSeriousBombs = 0;
+  snap.tmSeriousBombFired = -100.0f;
+  snap.tmSpawned = 0.0f;
+
+  for (INDEX iPowerUp = 0; iPowerUp < MAX_POWERUPS; iPowerUp++) {
+    snap.atmPowerups[iPowerUp] = 0.0f;
+    snap.atmPowerupsMax[iPowerUp] = 1.0f;
+  }
+#endif
+
+  // Boss health or enemy counter
+  snap.fBossBar = _bossTracker.Sample(_penPlayer->m_penMainMusicHolder, snap.tmTick);
+
+  // Statistics
+  snap.iScore = _penPlayer->m_psGameStats.ps_iScore;
+  snap.iMana = _penPlayer->m_iMana;
+  snap.iKills = _penPlayer->m_psGameStats.ps_iKills;
+  snap.iDeaths = _penPlayer->m_psGameStats.ps_iDeaths;
+
+#if SE1_GAME != SS_REV
+  snap.iHighScore = _penPlayer->m_iHighScore;
+#else
+  // [Cecil] TODO: Find out which stat from Revolution could be used as a high score
+  // Maybe it can read those "world stats" and retrieve the highest score per level?
+  snap.iHighScore = UpperLimit(INDEX(0));
+#endif
+
+  snap.ctUnreadMessages = _penPlayer->m_ctUnreadMessages;
+  snap.tmAnimateInbox = _penPlayer->m_tmAnimateInbox;
+
+  // View
+  snap.plView = _penPlayer->GetLerpedPlacement();
+  snap.bSnooping = FALSE;
+  snap.bSniperMask = FALSE;
+
+  // Sniper scope
+#if SE1_GAME != SS_TFE
+  snap.fRayHitDistance = _penWeapons->m_fRayHitDistance;
+  snap.fSniperFOV = Lerp(_penWeapons->m_fSniperFOVlast, _penWeapons->m_fSniperFOV, _pTimer->GetLerpFactor());
+  snap.fEnemyHealth = _penWeapons->m_fEnemyHealth;
+  snap.tmLastSniperFire = _penWeapons->m_tmLastSniperFire;
+#else
+  snap.fRayHitDistance = 0.0f;
+  snap.fSniperFOV = 90.0f;
+  snap.fEnemyHealth = 0.0f;
+  snap.tmLastSniperFire = -100.0f;
+#endif
+
+  // Player list
+  const INDEX ctPlayers = _cenPlayers.Count();
+
+  snap.aPlayers.PopAll();
+  if (ctPlayers > 0) snap.aPlayers.Push(ctPlayers);
+
+  snap.iLocalPlayer = -1;
+
+  for (INDEX iPlayer = 0; iPlayer < ctPlayers; iPlayer++) {
+    CPlayer *pen = (CPlayer *)_cenPlayers.Pointer(iPlayer);
+    HudPlayerInfo &info = snap.aPlayers[iPlayer];
+
+    info.strName = pen->GetPlayerName();
+    info.fHealth = pen->GetHealth();
+    info.fArmor = pen->m_fArmor;
+    info.iScore = pen->m_psGameStats.ps_iScore;
+    info.iMana = pen->m_iMana;
+    info.iKills = pen->m_psGameStats.ps_iKills;
+    info.iDeaths = pen->m_psGameStats.ps_iDeaths;
+    info.iLevelScore = pen->m_psLevelStats.ps_iScore;
+    info.iLevelKills = pen->m_psLevelStats.ps_iKills;
+    info.tmPing = pen->en_tmPing;
+
+    if (pen == _penPlayer) snap.iLocalPlayer = iPlayer;
+  }
+
+  // Let HUD elements gather their data
+  PrepareHudElements(snap);
+};
+
 // Prepare interface for rendering
 BOOL CHud::PrepareHUD(CPlayer *penCurrent, CDrawPort *pdpCurrent)
 {
-  static CSymbolPtr pfOpacity("hud_fOpacity");
-  static CSymbolPtr pfScaling("hud_fScaling");
-
   // Clear beforehand in case it can't reach GatherPlayers() call at the end
   // Realistically it's not supposed to be used at all if HUD preparation fails
   _cenPlayers.Clear();
@@ -104,13 +330,29 @@ BOOL CHud::PrepareHUD(CPlayer *penCurrent, CDrawPort *pdpCurrent)
   _penPlayer = penCurrent;
   _penWeapons = (CPlayerWeapons *)&*_penPlayer->m_penWeapons;
 
+  // Gather players for multiplayer
+  if (!pGetSP()->sp_bSinglePlayer) {
+    GatherPlayers();
+  }
+
+  CaptureSnapshot();
+  PrepareFrame(pdpCurrent);
+
+  return TRUE;
+};
+
+// Prepare drawing variables for rendering the current snapshot
+void CHud::PrepareFrame(CDrawPort *pdpCurrent) {
+  static CSymbolPtr pfOpacity("hud_fOpacity");
+  static CSymbolPtr pfScaling("hud_fScaling");
+
   // Get drawport with its dimensions
   _pdp = pdpCurrent;
   _vpixScreen = PIX2D(_pdp->GetWidth(), _pdp->GetHeight());
 
   // Update time
   _tmLast = _tmNow;
-  _tmNow = _pTimer->CurrentTick();
+  _tmNow = _snap.tmTick;
 
   // Limit scaling
   _fHudScaling = Clamp(pfScaling.GetFloat(), 0.05f, 2.0f);
@@ -132,15 +374,12 @@ BOOL CHud::PrepareHUD(CPlayer *penCurrent, CDrawPort *pdpCurrent)
   _ulAlphaHUD = NormFloatToByte(Clamp(pfOpacity.GetFloat(), 0.0f, 1.0f));
 
   // Setup HUD theme
-  const INDEX iCurrentTheme = Clamp(_psTheme.GetIndex(), (INDEX)0, INDEX(E_HUD_MAX - 1));
+  const INDEX iCurrentTheme = tex.PrepareTheme(Clamp(_psTheme.GetIndex(), (INDEX)0, INDEX(E_HUD_MAX - 1)));
+  _iTheme = iCurrentTheme;
   _bTSEColors = (iCurrentTheme > E_HUD_TFE);
   _bTSETheme = (iCurrentTheme >= E_HUD_TSE);
 
-  static const HudColorSet *aColorSets[E_HUD_MAX] = {
-    &_hcolTFE, &_hcolWarped, &_hcolTSE, &_hcolSSR,
-  };
-
-  pColorSet = aColorSets[iCurrentTheme];
+  ResolveColors(_athdThemes[iCurrentTheme].colors);
 
   // Set colors
   _colHUD = COL_Base();
@@ -159,29 +398,13 @@ BOOL CHud::PrepareHUD(CPlayer *penCurrent, CDrawPort *pdpCurrent)
   // Calculate relative scaling for the text font
   _fTextFontScale = (FLOAT)_pfdDisplayFont->GetHeight() / (FLOAT)_pfdCurrentText->GetHeight();
 
-  // Determine current gamemode
-  _eGameMode = E_GM_SP;
-
-  if (!pGetSP()->sp_bSinglePlayer) {
-    // Gather players for multiplayer
-    GatherPlayers();
-
-    if (pGetSP()->sp_bCooperative) {
-      _eGameMode = E_GM_COOP;
-
-    } else if (!pGetSP()->sp_bUseFrags) {
-      _eGameMode = E_GM_SCORE;
-
-    } else {
-      _eGameMode = E_GM_FRAG;
-    }
-  }
-
-  return TRUE;
+  // Current gamemode
+  _eGameMode = (EGameMode)_snap.iGameMode;
 };
 
-// Render entire interface
-void CHud::DrawHUD(const CPlayer *penCurrent, BOOL bSnooping, const CPlayer *penOwner)
+// Render entire interface using a specific theme
+template<INDEX iTheme>
+void CHud::DrawThemedHUD(void)
 {
   static CSymbolPtr pfWeapons("hud_tmWeaponsOnScreen");
   static CSymbolPtr pbLatency("hud_bShowLatency");
@@ -189,12 +412,8 @@ void CHud::DrawHUD(const CPlayer *penCurrent, BOOL bSnooping, const CPlayer *pen
   const FLOAT tmWeaponsOnScreen = pfWeapons.GetFloat();
   const INDEX bShowLatency = pbLatency.GetIndex();
 
-  // No player or no owner for snooping
-  if (penCurrent == NULL || penCurrent->GetFlags() & ENF_DELETED) return;
-  if (bSnooping && penOwner == NULL) return;
-
   // Adjust border color during snooping
-  if (bSnooping) {
+  if (_snap.bSnooping) {
     _colBorder = COL_SnoopingLight();
 
     // Darken flash and scale
@@ -206,9 +425,7 @@ void CHud::DrawHUD(const CPlayer *penCurrent, BOOL bSnooping, const CPlayer *pen
 
 #if SE1_GAME != SS_TFE
   // Render sniper mask (even while snooping)
-  CPlayerWeapons &enMyWeapons = (CPlayerWeapons &)*penOwner->m_penWeapons;
-
-  if (enMyWeapons.m_iCurrentWeapon == WEAPON_SNIPER && enMyWeapons.m_bSniping) {
+  if (_snap.bSniperMask) {
     DrawSniperMask();
   }
 #endif
@@ -221,64 +438,42 @@ void CHud::DrawHUD(const CPlayer *penCurrent, BOOL bSnooping, const CPlayer *pen
   SIconTexture *ptoWantedWeapon = NULL;
   SIconTexture *ptoCurrentAmmo = NULL;
 
-  RenderVitals();
-  RenderCurrentWeapon(&ptoWantedWeapon, &ptoCurrentAmmo);
+  RenderVitals<iTheme>();
+  RenderCurrentWeapon<iTheme>(&ptoWantedWeapon, &ptoCurrentAmmo);
 
   Rescale(0.8f);
-  RenderActiveArsenal(ptoCurrentAmmo);
+  RenderActiveArsenal<iTheme>(ptoCurrentAmmo);
   ResetScale(_fHudScaling);
 
   // If weapon change is in progress
-  if (_tmNow - _penWeapons->m_tmWeaponChangeRequired < tmWeaponsOnScreen) {
-    // Determine amount of available weapons
-    INDEX ctWeapons = 0;
-
-    for (INDEX iCount = 1; iCount < GetWeapons().Count(); iCount++) {
-      if (GetWeapons()[iCount].iWeapon != WEAPON_NONE && GetWeapons()[iCount].iWeapon != WEAPON_DOUBLECOLT
-       && GetWeapons()[iCount].bHasWeapon) {
-        ctWeapons++;
-      }
-    }
-
-    FLOAT fCol = 320.0f - (ctWeapons * units.fAdv - units.fOne) * 0.5f;
-    FLOAT fRow = _vpixBR(2) - units.fHalf - units.fNext * 3;
-
+  if (_tmNow - _snap.tmWeaponChangeRequired < tmWeaponsOnScreen) {
     // Display all available weapons
-    for (INDEX iWeapon = 0; iWeapon < GetWeapons().Count(); iWeapon++) {
-      HudWeapon &wiInfo = GetWeapons()[iWeapon];
-
-      // Skip if no weapon
-      if (wiInfo.iWeapon == WEAPON_NONE || wiInfo.iWeapon == WEAPON_DOUBLECOLT || !wiInfo.bHasWeapon) {
-        continue;
-      }
-
-      // Display weapon icon
-      COLOR colBorder = COL_WeaponBorder();
-      COLOR colIcon = COL_WeaponIcon();
+    const HudWeaponStrip &strip = UpdateWeaponStrip(ptoWantedWeapon);
+    const INDEX ctSlots = strip.aSlots.Count();
 
-      // No ammo
-      if (wiInfo.paiAmmo != NULL && wiInfo.paiAmmo->iAmmo == 0) {
-        colBorder = colIcon = COL_WeaponNoAmmo();
+    // Borders of all slots at once
+    _pdp->InitTexture(&tex.toTile, TRUE);
+    HashDrawTexture(&tex.toTile);
 
-      // Selected weapon
-      } else if (ptoWantedWeapon == wiInfo.ptoWeapon) {
-        colBorder = colIcon = COL_WeaponWanted();
-      }
+    for (INDEX iBorder = 0; iBorder < ctSlots; iBorder++) {
+      const HudWeaponStrip::Slot &slot = strip.aSlots[iBorder];
+      AddBorderQuads(slot.fCol, strip.fRow, strip.fOne, strip.fOne, slot.colBorder);
+    }
 
-      DrawBorder(fCol, fRow, units.fOne, units.fOne, colBorder);
-      DrawIcon(fCol, fRow, *wiInfo.ptoWeapon, colIcon, 1.0f, FALSE);
+    _pdp->FlushRenderingQueue();
 
-      // Advance to the next position
-      fCol += units.fAdv;
+    for (INDEX iIcon = 0; iIcon < ctSlots; iIcon++) {
+      const HudWeaponStrip::Slot &slot = strip.aSlots[iIcon];
+      DrawIcon(slot.fCol, strip.fRow, slot.ptoWeapon->ato[iTheme], slot.colIcon, 1.0f, FALSE);
     }
   }
 
   Rescale(0.5f / _fWideAdjustment);
-  RenderBars();
+  RenderBars<iTheme>();
   ResetScale(_fHudScaling);
 
   Rescale(0.6f);
-  RenderGameModeInfo();
+  RenderGameModeInfo<iTheme>();
   ResetScale(_fHudScaling);
 
   // Display local client latency
@@ -291,10 +486,10 @@ void CHud::DrawHUD(const CPlayer *penCurrent, BOOL bSnooping, const CPlayer *pen
     _pdp->SetTextCharSpacing(-2.0f * fTextScale);
 
     CTString strLatency;
-    strLatency.PrintF("%4.0fms", _penPlayer->m_tmLatency * 1000.0f);
+    strLatency.PrintF("%4.0fms", _snap.tmLatency * 1000.0f);
 
     const PIX pixFontHeight = _pfdCurrentText->GetHeight() * fTextScale + fTextScale + 1;
-    _pdp->PutTextR(strLatency, _vpixScreen(1), _vpixScreen(2) - pixFontHeight, C_WHITE | CT_OPAQUE);
+    PrintRight(strLatency, _vpixScreen(1), _vpixScreen(2) - pixFontHeight, C_WHITE | CT_OPAQUE);
   }
 
   // Restore font defaults
@@ -326,11 +521,257 @@ void CHud::DrawHUD(const CPlayer *penCurrent, BOOL bSnooping, const CPlayer *pen
       strTime.PrintF("%2d:%02d", tmNewTime->tm_hour, tmNewTime->tm_min);
     }
 
-    _pdp->PutTextR(strTime, _vpixScreen(1) - 3, 2, C_lYELLOW | CT_OPAQUE);
+    PrintRight(strTime, _vpixScreen(1) - 3, 2, C_lYELLOW | CT_OPAQUE);
   }
 #endif
 };
 
+// Time spent on rendering the HUD with each theme
+static DOUBLE _adDrawTime[E_HUD_MAX] = { 0.0 };
+static INDEX _actDrawFrames[E_HUD_MAX] = { 0 };
+
+// Stages of HUD rendering in order
+enum EHudStage {
+  E_HS_WEAPON,    // Weapon model
+  E_HS_SNAPSHOT,  // Capturing the HUD snapshot (can't be skipped)
+  E_HS_WORLD,     // Particles, player tags and the crosshair
+  E_HS_BLEND,     // Screen blending
+  E_HS_INTERFACE, // 2D interface
+
+  E_HS_MAX,
+};
+
+// Time spent on each stage of HUD rendering
+static DOUBLE _adStageTime[E_HS_MAX] = { 0.0 };
+static INDEX _actStageFrames[E_HS_MAX] = { 0 };
+
+// Print average time spent on rendering the HUD with each theme
+void ReportDrawTime(void) {
+  static const char *astrThemes[E_HUD_MAX] = { "TFE", "Warped", "TSE", "SSR" };
+
+  CPrintF(TRANS("Average HUD rendering time:\n"));
+
+  for (INDEX iTheme = 0; iTheme < E_HUD_MAX; iTheme++) {
+    const INDEX ctFrames = _actDrawFrames[iTheme];
+    if (ctFrames == 0) continue;
+
+    CPrintF("  %-6s: %7.2f us (%d frames)\n", astrThemes[iTheme], _adDrawTime[iTheme] / ctFrames * 1000000.0, ctFrames);
+
+    // Start over
+    _adDrawTime[iTheme] = 0.0;
+    _actDrawFrames[iTheme] = 0;
+  }
+
+  ReportHudElements();
+
+  static const char *astrStages[E_HS_MAX] = { "Weapon", "Snapshot", "World", "Blend", "Interface" };
+
+  CPrintF(TRANS("Average time of HUD rendering stages:\n"));
+
+  for (INDEX iStage = 0; iStage < E_HS_MAX; iStage++) {
+    const INDEX ctFrames = _actStageFrames[iStage];
+    if (ctFrames == 0) continue;
+
+    CPrintF("  %-9s: %7.2f us (%d frames)\n", astrStages[iStage], _adStageTime[iStage] / ctFrames * 1000000.0, ctFrames);
+
+    // Start over
+    _adStageTime[iStage] = 0.0;
+    _actStageFrames[iStage] = 0;
+  }
+};
+
+// Lay out the weapon selection strip again if anything it depends on has changed
+const HudWeaponStrip &CHud::UpdateWeaponStrip(SIconTexture *ptoWanted) {
+  HudWeaponStrip &strip = arWeapons.strip;
+
+  // Ammo types that have ran out
+  ULONG ulEmptyAmmo = 0;
+
+  for (INDEX iAmmo = 0; iAmmo < GetAmmo().Count(); iAmmo++) {
+    if (GetAmmo()[iAmmo].iAmmo == 0) ulEmptyAmmo |= (1UL << iAmmo);
+  }
+
+  const FLOAT fRow = _vpixBR(2) - units.fHalf - units.fNext * 3;
+
+  const BOOL bSameLayout = strip.bValid
+    && strip.iAvailableWeapons == _snap.iAvailableWeapons && strip.ulEmptyAmmo == ulEmptyAmmo
+    && strip.ptoWanted == ptoWanted && strip.fRow == fRow && strip.fAdv == units.fAdv && strip.fOne == units.fOne
+    && strip.colBorder == COL_WeaponBorder() && strip.colIcon == COL_WeaponIcon()
+    && strip.colNoAmmo == COL_WeaponNoAmmo() && strip.colWanted == COL_WeaponWanted();
+
+  if (bSameLayout) return strip;
+
+  strip.bValid = TRUE;
+  strip.iAvailableWeapons = _snap.iAvailableWeapons;
+  strip.ulEmptyAmmo = ulEmptyAmmo;
+  strip.ptoWanted = ptoWanted;
+  strip.fRow = fRow;
+  strip.fAdv = units.fAdv;
+  strip.fOne = units.fOne;
+  strip.colBorder = COL_WeaponBorder();
+  strip.colIcon = COL_WeaponIcon();
+  strip.colNoAmmo = COL_WeaponNoAmmo();
+  strip.colWanted = COL_WeaponWanted();
+
+  strip.aSlots.PopAll();
+
+  for (INDEX iWeapon = 0; iWeapon < GetWeapons().Count(); iWeapon++) {
+    HudWeapon &wiInfo = GetWeapons()[iWeapon];
+
+    // Skip if no weapon
+    if (wiInfo.iWeapon == WEAPON_NONE || wiInfo.iWeapon == WEAPON_DOUBLECOLT || !wiInfo.bHasWeapon) {
+      continue;
+    }
+
+    HudWeaponStrip::Slot &slot = strip.aSlots.Push();
+    slot.ptoWeapon = wiInfo.ptoWeapon;
+    slot.colBorder = strip.colBorder;
+    slot.colIcon = strip.colIcon;
+
+    // No ammo
+    if (wiInfo.paiAmmo != NULL && wiInfo.paiAmmo->iAmmo == 0) {
+      slot.colBorder = slot.colIcon = strip.colNoAmmo;
+
+    // Selected weapon
+    } else if (ptoWanted == wiInfo.ptoWeapon) {
+      slot.colBorder = slot.colIcon = strip.colWanted;
+    }
+  }
+
+  // Center all slots
+  const INDEX ctSlots = strip.aSlots.Count();
+  const FLOAT fStart = 320.0f - (ctSlots * units.fAdv - units.fOne) * 0.5f;
+
+  for (INDEX iSlot = 0; iSlot < ctSlots; iSlot++) {
+    strip.aSlots[iSlot].fCol = fStart + iSlot * units.fAdv;
+  }
+
+  return strip;
+};
+
+// Render entire interface
+void CHud::DrawHUD(const CPlayer *penCurrent, BOOL bSnooping, const CPlayer *penOwner)
+{
+  // No player or no owner for snooping
+  if (penCurrent == NULL || penCurrent->GetFlags() & ENF_DELETED) return;
+  if (bSnooping && penOwner == NULL) return;
+
+  _snap.bSnooping = bSnooping;
+
+#if SE1_GAME != SS_TFE
+  // Sniper mask of the owner (even while snooping)
+  CPlayerWeapons &enMyWeapons = (CPlayerWeapons &)*penOwner->m_penWeapons;
+  _snap.bSniperMask = (enMyWeapons.m_iCurrentWeapon == WEAPON_SNIPER && enMyWeapons.m_bSniping);
+#endif
+
+  RecordSnapshot(_snap);
+  RenderSnapshot();
+};
+
+// Render interface from the current snapshot
+void CHud::RenderSnapshot(void)
+{
+  typedef void (CHud::*CDrawFunc)(void);
+
+  // Render function for each theme
+  static const CDrawFunc apDrawFuncs[E_HUD_MAX] = {
+    &CHud::DrawThemedHUD<E_HUD_TFE>,
+    &CHud::DrawThemedHUD<E_HUD_WARPED>,
+    &CHud::DrawThemedHUD<E_HUD_TSE>,
+    &CHud::DrawThemedHUD<E_HUD_SSR>,
+  };
+
+  const CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+
+  (this->*apDrawFuncs[_iTheme])();
+
+  // Only count real frames
+  if (!_bReplaying) {
+    _adDrawTime[_iTheme] += (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds();
+    _actDrawFrames[_iTheme]++;
+  }
+};
+
+// Feed recorded snapshots through the HUD and measure rendering time
+void CHud::ReplaySnapshotFile(CDrawPort *pdp) {
+  const CTFileName fnmReplay = _fnmReplay;
+  _fnmReplay = CTString("");
+
+  BOOL bHashDraws = _bHashReplay;
+  _bHashReplay = FALSE;
+
+  CStaticStackArray<ULONG> aulHashes;
+
+  // Keep live value histories intact
+  HudValueHistory ahistLive[HUD_AMMO_SLOTS];
+  memcpy(ahistLive, _snap.ahistAmmo, sizeof(ahistLive));
+
+  const TIME tmLastLive = _tmLast;
+  const TIME tmNowLive = _tmNow;
+
+  _bReplaying = TRUE;
+
+  INDEX ctFrames = 0;
+  DOUBLE dTotal = 0.0;
+  DOUBLE dMin = 1e9;
+  DOUBLE dMax = 0.0;
+
+  try {
+    CTFileStream strm;
+    OpenSnapshotFile_t(strm, fnmReplay);
+
+    while (!strm.AtEOF()) {
+      _snap.Read_t(strm);
+
+      // Sniper mask needs live weapons
+      _snap.bSniperMask = FALSE;
+
+      const CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+
+      PrepareFrame(pdp);
+
+      if (bHashDraws) {
+        BeginDrawHash();
+        RenderSnapshot();
+        aulHashes.Push() = EndDrawHash();
+
+      } else {
+        RenderSnapshot();
+      }
+
+      const DOUBLE dFrame = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds();
+      dTotal += dFrame;
+      dMin = Min(dMin, dFrame);
+      dMax = Max(dMax, dFrame);
+      ctFrames++;
+    }
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot replay HUD snapshots from '%s': %s\n"), fnmReplay.str_String, strError);
+
+    // Don't compare incomplete hashes
+    EndDrawHash();
+    bHashDraws = FALSE;
+  }
+
+  _bReplaying = FALSE;
+
+  // Restore live state
+  memcpy(_snap.ahistAmmo, ahistLive, sizeof(ahistLive));
+
+  _tmLast = tmLastLive;
+  _tmNow = tmNowLive;
+
+  if (ctFrames == 0) return;
+
+  CPrintF(TRANS("Replayed %d HUD snapshots: %.2f us average, %.2f us min, %.2f us max\n"), ctFrames,
+    dTotal / ctFrames * 1000000.0, dMin * 1000000.0, dMax * 1000000.0);
+
+  if (bHashDraws) {
+    CheckDrawHashes(fnmReplay, aulHashes, pdp->GetWidth(), pdp->GetHeight(), _iTheme);
+  }
+};
+
 // Display tags above players
 void CHud::RenderPlayerTags(CPlayer *penThis, CPerspectiveProjection3D &prProjection) {
   // Tags are disabled or it's a singleplayer game
@@ -343,24 +784,18 @@ void CHud::RenderPlayerTags(CPlayer *penThis, CPerspectiveProjection3D &prProjec
   _pdp->SetFont(_pfdCurrentText);
   _pdp->SetTextScaling(fTextScale);
 
-  // Render tags for each player
-  FOREACHINDYNAMICCONTAINER(_cenPlayers, CPlayer, iten) {
-    CPlayer *pen = iten;
-
-    // Skip this player (or a prediction of it)
-    if (pen == penThis->GetPredictionTail()) continue;
+  // Gather tag data of all players
+  const INDEX ctPlayers = _cenPlayers.Count();
+  _tagBatch.Resize(ctPlayers);
 
-    const BOOL bAlive = (pen->GetFlags() & ENF_ALIVE);
+  for (INDEX iPlayer = 0; iPlayer < ctPlayers; iPlayer++) {
+    CPlayer *pen = (CPlayer *)_cenPlayers.Pointer(iPlayer);
     const FLOAT3D vPlayer = pen->GetLerpedPlacement().pl_PositionVector;
 
-    FLOATmatrix3D mThis;
-    MakeRotationMatrixFast(mThis, penThis->GetLerpedPlacement().pl_OrientationAngle);
-
-    // Calculate tag position on screen
     FLOAT3D vBoxCenter(0, 0, 0);
     FLOAT fBoxTop = 0.5f;
 
-    if (bAlive) {
+    if (pen->GetFlags() & ENF_ALIVE) {
       FLOATaabbox3D box;
       pen->GetBoundingBox(box);
       box -= pen->GetPlacement().pl_PositionVector;
@@ -372,37 +807,34 @@ void CHud::RenderPlayerTags(CPlayer *penThis, CPerspectiveProjection3D &prProjec
       fBoxTop = Max(Max(vSize(1), vSize(2)), vSize(3)) * 0.5f;
     }
 
-    const FLOAT3D vPlayerCenter = vPlayer + vBoxCenter; // Center of the target player
-    const FLOAT3D vTagOffset = FLOAT3D(0, fBoxTop, 0) * mThis; // Offset relative to the local rotation
-
-    FLOAT3D vTag(0, 0, 0);
-    prProjection.ProjectCoordinate(vPlayerCenter + vTagOffset, vTag);
+    _tagBatch.Set(iPlayer, vPlayer, vPlayer + vBoxCenter, fBoxTop, pen->GetHealth());
+  }
 
-    if (vTag(3) >= 0.0f) continue;
+  // Calculate positions, colors and sizes of all tags at once
+  HudTagView view;
+  view.Setup(prProjection, penThis->GetLerpedPlacement(), fScaling);
+  PrepareTags_Vector(_tagBatch, view);
 
-    vTag(2) = _vpixScreen(2) - vTag(2);
+  // Render tags for each player
+  for (INDEX iTag = 0; iTag < ctPlayers; iTag++) {
+    CPlayer *pen = (CPlayer *)_cenPlayers.Pointer(iTag);
 
-    // Marker color based on health level (0..100 health = 0..2 ratio)
-    const FLOAT fHealthRatio = Clamp(pen->GetHealth() * 0.02f, 0.0f, 2.0f);
-    COLOR colTag;
+    // Skip this player (or a prediction of it)
+    if (pen == penThis->GetPredictionTail()) continue;
 
-    if (fHealthRatio < 1.0f) {
-      colTag = LerpColor(C_RED, C_YELLOW, fHealthRatio);
-    } else {
-      colTag = LerpColor(C_YELLOW, C_GREEN, fHealthRatio - 1.0f);
-    }
+    // Behind the view
+    if (_tagBatch.afScreenZ[iTag] >= 0.0f) continue;
 
-    // Alpha level based on relative distance (0..32 meters = 95..191 alpha)
-    const FLOAT fDist = (vPlayer - penThis->GetLerpedPlacement().pl_PositionVector).Length();
-    const FLOAT fDistRatio = Clamp(fDist * 0.03125f, 0.0f, 1.0f);
-    UBYTE ubAlpha = 0xBF - UBYTE(fDistRatio * 96.0f);
+    const BOOL bAlive = (pen->GetFlags() & ENF_ALIVE);
+    const FLOAT3D vTag(_tagBatch.afScreenX[iTag], _vpixScreen(2) - _tagBatch.afScreenY[iTag], 0.0f);
 
-    // Marker size based on relative distance
-    const FLOAT fMarkerSize = (6.0f - fDistRatio * 3.0f) * fScaling;
+    const FLOAT fDist = _tagBatch.afDist[iTag];
+    const FLOAT fMarkerSize = _tagBatch.afMarkerSize[iTag];
+    const COLOR colTag = _tagBatch.acolTag[iTag];
 
     _pdp->InitTexture(&tex.toMarker);
     _pdp->AddTexture(vTag(1) - fMarkerSize, vTag(2) - fMarkerSize * 2,
-                     vTag(1) + fMarkerSize, vTag(2), colTag | ubAlpha);
+                     vTag(1) + fMarkerSize, vTag(2), colTag | UBYTE(_tagBatch.aiMarkerAlpha[iTag]));
     _pdp->FlushRenderingQueue();
 
     // Only marker
@@ -435,18 +867,130 @@ void CHud::RenderPlayerTags(CPlayer *penThis, CPerspectiveProjection3D &prProjec
     }
 
     // Alpha level based on relative distance (0..32 meters = 95..255 alpha)
-    ubAlpha = 0xFF - UBYTE(fDistRatio * 160.0f);
+    const UBYTE ubAlpha = _tagBatch.aiNameAlpha[iTag];
     const COLOR colName = (bAlive ? COL_PlayerNames() : COL_ValueLow());
 
     const PIX pixCharH = (_pfdCurrentText->GetHeight() - 2) * fTextScale;
-    _pdp->PutTextC(strPlayerName, vTag(1), vTag(2) - pixCharH - fMarkerSize * 2, colName | ubAlpha);
+    PrintCentered(strPlayerName, vTag(1), vTag(2) - pixCharH - fMarkerSize * 2, colName | ubAlpha);
   }
 };
 
+// Add positions of players and the boss around the viewer to the element commands
+void CHud::EmitRadar(HudCommandBuffer &cmd) {
+  const INDEX iRadar = _psRadar.GetIndex();
+  if (iRadar <= 0 || !_bShowPlayers || pGetSP()->sp_bSinglePlayer) return;
+
+  // Boss position
+  CEntity *penBoss = NULL;
+
+  if (iRadar > 1 && _penPlayer->m_penMainMusicHolder != NULL) {
+    CMusicHolder &mh = (CMusicHolder &)*_penPlayer->m_penMainMusicHolder;
+
+    if (mh.m_penBoss != NULL && mh.m_penBoss->GetFlags() & ENF_ALIVE) {
+      penBoss = mh.m_penBoss;
+    }
+  }
+
+  // Gather blips from the player list (and the boss as the last one)
+  const INDEX ctPlayers = _cenPlayers.Count();
+  const INDEX ctBlips = ctPlayers + (penBoss != NULL ? 1 : 0);
+  _blipBatch.Resize(ctBlips);
+
+  for (INDEX iPlayer = 0; iPlayer < ctPlayers; iPlayer++) {
+    CPlayer *pen = (CPlayer *)_cenPlayers.Pointer(iPlayer);
+    _blipBatch.Set(iPlayer, pen->GetLerpedPlacement().pl_PositionVector, pen->GetHealth());
+  }
+
+  if (penBoss != NULL) {
+    _blipBatch.Set(ctPlayers, penBoss->GetLerpedPlacement().pl_PositionVector, 0.0f);
+  }
+
+  // Radar area on the right side of the screen
+  const FLOAT fRadius = 48.0f * _fHudScaling;
+  const FLOAT fCenterX = (_vpixBR(1) - fRadius) * _vScaling(1);
+  const FLOAT fCenterY = (240.0f * _fWideAdjustment) * _vScaling(2);
+  const FLOAT fRadiusPix = fRadius * _vScaling(1);
+
+  // Calculate positions and colors of all blips at once
+  HudRadarView view;
+  view.Setup(_snap.plView, fCenterX, fCenterY, fRadiusPix, _psRadarRange.GetFloat());
+  PrepareBlips_Vector(_blipBatch, view);
+
+  // Radar frame
+  HudQuad aFrame[9];
+  GetBorderQuads(fCenterX / _vScaling(1), fCenterY / _vScaling(2), fRadius * 2.0f, fRadius * 2.0f, _colBorder, aFrame);
+
+  for (INDEX iQuad = 0; iQuad < 9; iQuad++) {
+    cmd.AddQuad(&tex.toTile, aFrame[iQuad], TRUE);
+  }
+
+  // All blips with the same texture
+  const FLOAT fBlipSize = 3.0f * _fHudScaling * _vScaling(1);
+  const FLOAT fBossSize = fBlipSize * 2.0f;
+
+  for (INDEX iBlip = 0; iBlip < ctBlips; iBlip++) {
+    const FLOAT fX = _blipBatch.afBlipX[iBlip];
+    const FLOAT fY = _blipBatch.afBlipY[iBlip];
+    const UBYTE ubAlpha = (_blipBatch.aiBlipAlpha[iBlip] * _ulAlphaHUD) / 255;
+
+    // Boss
+    if (iBlip == ctPlayers) {
+      cmd.AddQuad(&tex.toMarker, fX - fBossSize, fY - fBossSize, fX + fBossSize, fY + fBossSize, _colLow | ubAlpha);
+      continue;
+    }
+
+    // Viewer in the center
+    if (_cenPlayers.Pointer(iBlip) == _penLast) continue;
+
+    cmd.AddQuad(&tex.toMarker, fX - fBlipSize, fY - fBlipSize, fX + fBlipSize, fY + fBlipSize, _blipBatch.acolBlip[iBlip] | ubAlpha);
+  }
+
+  cmd.AddQuad(&tex.toMarker, fCenterX - fBlipSize, fCenterY - fBlipSize, fCenterX + fBlipSize, fCenterY + fBlipSize, COL_PlayerNames() | _ulAlphaHUD);
+};
+
+// Render all HUD elements at once
+void CHud::RenderElements(void) {
+  HudElementFrame frame;
+  frame.psnap = &_snap;
+  frame.vpixScreen = _vpixScreen;
+  frame.vScaling = _vScaling;
+  frame.vpixTL = _vpixTL;
+  frame.vpixBR = _vpixBR;
+  frame.fWideAdjustment = _fWideAdjustment;
+  frame.fHudScaling = _fHudScaling;
+  frame.ulAlpha = _ulAlphaHUD;
+  frame.iTheme = _iTheme;
+  frame.tmNow = _tmNow;
+
+  _cmdElements.Clear();
+  EmitHudElements(frame, _cmdElements);
+
+  // Text of all elements in the HUD text font
+  const FLOAT fTextScale = HEIGHT_SCALING(_pdp) * _fTextFontScale;
+
+  _pfdCurrentText->SetVariableWidth();
+  _pdp->SetFont(_pfdCurrentText);
+  _pdp->SetTextScaling(fTextScale);
+  _pdp->SetTextCharSpacing(0);
+
+  _cmdElements.Submit(_pdp, _tbText);
+};
+
+// Radar as a built-in HUD element
+static void EmitRadarElement(void *pUserData, const HudElementFrame &frame, HudCommandBuffer &cmd) {
+  ((CHud *)pUserData)->EmitRadar(cmd);
+};
+
 // Player function patch
 class CPlayerPatch : public CPlayer {
   public:
     void P_RenderHUD(RENDER_ARGS(prProjection, pdp, vLightDir, colLight, colAmbient, bRenderWeapon, iEye));
+
+    // Stages of HUD rendering
+    void RenderWeaponStage(RENDER_ARGS(prProjection, pdp, vLightDir, colLight, colAmbient, bRenderWeapon, iEye), BOOL bSniping);
+    void RenderWorldStage(CPerspectiveProjection3D &prProjection, CDrawPort *pdp, INDEX iEye, BOOL bSniping, BOOL bPrepared);
+    void RenderBlendStage(CDrawPort *pdp);
+    void RenderInterfaceStage(CDrawPort *pdp, CPlayer *penHUDPlayer, BOOL bSnooping, BOOL bPrepared);
 };
 
 // Initialize everything for drawing the HUD
@@ -509,23 +1053,21 @@ void CHud::Initialize(void) {
   // Patch HUD rendering function
   CreatePatch(pRenderHud, &CPlayerPatch::P_RenderHUD, "CPlayer::RenderHUD(...)");
 
+  // Default theme properties with theme files over them
+  SetupThemes();
+
   try {
     // Load fonts for each theme
     for (INDEX iTheme = 0; iTheme < E_HUD_MAX; iTheme++) {
-      if (iTheme <= E_HUD_TSE) {
-        _afdText[iTheme].Load_t(CTFILENAME("Fonts\\Display3-narrow.fnt"));
-        _afdNumbers[iTheme].Load_t(CTFILENAME("Fonts\\Numbers3.fnt"));
-
-      } else {
-        _afdText[iTheme].Load_t(CTFILENAME("Fonts\\Rev_HUD\\Cabin.fnt"));
-        _afdNumbers[iTheme].Load_t(CTFILENAME("Fonts\\Rev_HUD\\Numbers.fnt"));
-      }
+      _afdText[iTheme].Load_t(_athdThemes[iTheme].afnmFonts[E_HTF_TEXT]);
+      _afdNumbers[iTheme].Load_t(_athdThemes[iTheme].afnmFonts[E_HTF_NUMBERS]);
 
       _afdText[iTheme].SetCharSpacing(0);
       _afdText[iTheme].SetLineSpacing(1);
     }
 
-    tex.LoadTextures();
+    const INDEX iActiveTheme = Clamp(_psTheme.GetIndex(), (INDEX)0, INDEX(E_HUD_MAX - 1));
+    tex.LoadTextures(_iThemeTextures, iActiveTheme);
 
   } catch (char *strError) {
     FatalError(strError);
@@ -570,6 +1112,59 @@ void CHud::Initialize(void) {
 
   NEW_WEAPON(WEAPON_LASER,      &tex.toWLaser,      &aAmmo[6]);
   NEW_WEAPON(WEAPON_IRONCANNON, &tex.toWIronCannon, &aAmmo[7]);
+
+  // Built-in elements
+  HudElementDesc descRadar;
+  descRadar.strName = "Radar";
+  descRadar.pPrepare = NULL;
+  descRadar.pEmit = &EmitRadarElement;
+  descRadar.pUserData = this;
+  descRadar.fUpdateRate = 0.0f;
+  descRadar.fBudget = 50.0f;
+  AddHudElement(descRadar);
+};
+
+// Print memory used by HUD textures and fonts
+void ReportMemory(void) {
+  _HUD.tex.ReportMemory();
+
+  // Font textures are shared between themes
+  CStaticStackArray<CTextureData *> aCounted;
+  SLONG slFonts = 0;
+
+  CPrintF(TRANS("HUD fonts:\n"));
+
+  for (INDEX iFont = 0; iFont < E_HUD_MAX * 2; iFont++) {
+    CFontData &fd = (iFont < E_HUD_MAX) ? _HUD._afdText[iFont] : _HUD._afdNumbers[iFont - E_HUD_MAX];
+    CTextureData *ptd = fd.fd_ptdTextureData;
+    if (ptd == NULL) continue;
+
+    // Count each texture once
+    BOOL bCounted = FALSE;
+
+    for (INDEX iCheck = 0; iCheck < aCounted.Count(); iCheck++) {
+      if (aCounted[iCheck] == ptd) {
+        bCounted = TRUE;
+        break;
+      }
+    }
+
+    if (bCounted) continue;
+
+    aCounted.Push() = ptd;
+
+    const SLONG slFont = ptd->GetUsedMemory() + sizeof(CFontData);
+    slFonts += slFont;
+
+    CPrintF("  %s: %d KB\n", fd.fd_fnTexture.str_String, slFont / 1024);
+  }
+
+  CPrintF(TRANS("  Total : %d KB\n"), slFonts / 1024);
+};
+
+// Compare cached text widths with the drawport on the next frame
+void RequestTextWidthCheck(void) {
+  _HUD._bVerifyTextWidths = TRUE;
 };
 
 // Clean everything up before disabling the plugin
@@ -579,51 +1174,52 @@ void CHud::End(void) {
 
   GetAmmo().PopAll();
   GetWeapons().PopAll();
+
+  _bossTracker.Reset();
+
+  _aPlayerHistories.PopAll();
+  _penHistoryPlayer = NULL;
+  _tmHistoryTick = -1.0f;
+
+  // Remove built-in elements; ones added by other plugins are removed by their owners
+  RemoveHudElement("Radar");
 };
 
-void CPlayerPatch::P_RenderHUD(RENDER_ARGS(prProjection, pdp, vLightDir, colLight, colAmbient, bRenderWeapon, iEye))
-{
-  // Replace HUD everywhere or only in vanilla if entities haven't been modified
-  const BOOL bReplaceHUD = _psEnable.GetIndex() > 1 || (_psEnable.GetIndex() == 1 && !_bModdedEntities);
+// Check if a stage of HUD rendering isn't skipped
+static inline BOOL IsStageEnabled(INDEX iStage) {
+  return !(_psSkipStages.GetIndex() & (1 << iStage));
+};
 
-  // Proceed to the original function instead
-  if (!bReplaceHUD) {
-    (this->*CHud::pRenderHud)(RENDER_ARGS_RAW(prProjection, pdp, vLightDir, colLight, colAmbient, bRenderWeapon, iEye));
-    return;
-  }
+// Add time since the start of a stage to its statistics
+static inline void EndStage(INDEX iStage, const CTimerValue &tvStart) {
+  _adStageTime[iStage] += (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds();
+  _actStageFrames[iStage]++;
+};
 
+// Render the weapon model (changes the projection)
+void CPlayerPatch::RenderWeaponStage(RENDER_ARGS(prProjection, pdp, vLightDir, colLight, colAmbient, bRenderWeapon, iEye), BOOL bSniping)
+{
   static CSymbolPtr pbRenderModels("gfx_bRenderModels");
   static CSymbolPtr pbShowWeapon("hud_bShowWeapon");
-  static CSymbolPtr pbShowInterface("hud_bShowInfo");
-  static CSymbolPtr ptmSnoopingTime("plr_tmSnoopingTime");
 
-  // Save intended view placement before rendering the weapon
-  const CPlacement3D plViewOld = prProjection.ViewerPlacementR();
+  // Don't render the weapon while sniping
+  if (CHud::pRenderWeaponModel_opt == NULL || !pbShowWeapon.GetIndex() || !pbRenderModels.GetIndex() || bSniping) return;
 
   CPlayerWeapons &enWeapons = (CPlayerWeapons &)*m_penWeapons;
 
-#if SE1_GAME == SS_TFE
-  const BOOL bSniping = FALSE;
+#if SE1_VER < SE1_107
+  (enWeapons.*CHud::pRenderWeaponModel_opt)(prProjection, pdp, vLightDir, colLight, colAmbient, bRenderWeapon);
 #else
-  const BOOL bSniping = enWeapons.m_bSniping;
+  (enWeapons.*CHud::pRenderWeaponModel_opt)(prProjection, pdp, vLightDir, colLight, colAmbient, bRenderWeapon, iEye);
 #endif
+};
 
-  // Don't render the weapon while sniping
-  if (CHud::pRenderWeaponModel_opt != NULL && pbShowWeapon.GetIndex() && pbRenderModels.GetIndex() && !bSniping)
-  {
-    #if SE1_VER < SE1_107
-      (enWeapons.*CHud::pRenderWeaponModel_opt)(prProjection, pdp, vLightDir, colLight, colAmbient, bRenderWeapon);
-    #else
-      (enWeapons.*CHud::pRenderWeaponModel_opt)(prProjection, pdp, vLightDir, colLight, colAmbient, bRenderWeapon, iEye);
-    #endif
-  }
-
+// Render particles, player tags and the crosshair using the view projection
+void CPlayerPatch::RenderWorldStage(CPerspectiveProjection3D &prProjection, CDrawPort *pdp, INDEX iEye, BOOL bSniping, BOOL bPrepared)
+{
 #if SE1_GAME != SS_TFE
   if (CHud::pRenderChainsawParticles_opt != NULL && m_iViewState == PVT_PLAYEREYES)
   {
-    prProjection.ViewerPlacementL() = plViewOld;
-    prProjection.Prepare();
-
     CAnyProjection3D apr;
     apr = prProjection;
     Stereo_AdjustProjection(*apr, iEye, 1);
@@ -635,37 +1231,9 @@ void CPlayerPatch::P_RenderHUD(RENDER_ARGS(prProjection, pdp, vLightDir, colLigh
   }
 #endif
 
-  // Prepare new HUD
-  BOOL bSnooping = FALSE;
-  CPlayer *penHUDPlayer = this;
-
-  if (penHUDPlayer->IsPredicted()) {
-    penHUDPlayer = (CPlayer *)penHUDPlayer->GetPredictor();
-  }
-
-  // Check if snooping is needed
-  const TIME tmDelta = _pTimer->CurrentTick() - enWeapons.m_tmSnoopingStarted;
-  const FLOAT tmSnooping = ptmSnoopingTime.Exists() ? ptmSnoopingTime.GetFloat() : 1.0f;
-
-  if (tmDelta < tmSnooping) {
-    ASSERT(enWeapons.m_penTargeting != NULL);
-    penHUDPlayer = (CPlayer *)&*enWeapons.m_penTargeting;
-    bSnooping = TRUE;
-  }
-
-  // Can't use the HUD if it can't be prepared
-  const BOOL bPrepared = _HUD.PrepareHUD(penHUDPlayer, pdp);
-
-  if (bPrepared) {
-    // Display tags above players in coop, in demos or while observing
-    const BOOL bDemo = (_psTagsInDemos.GetIndex() && _pNetwork->IsPlayingDemo());
-    const BOOL bObserving = (_psTagsForObservers.GetIndex() && _pNetwork->IsNetworkEnabled() && !IWorld::AnyLocalPlayers());
-
-    if (CHud::pGetSP()->sp_bCooperative || bDemo || bObserving) {
-      prProjection.ViewerPlacementL() = plViewOld;
-      prProjection.Prepare();
-      _HUD.RenderPlayerTags(this, prProjection);
-    }
+  // Display tags above players
+  if (bPrepared && _HUD._bShowPlayers) {
+    _HUD.RenderPlayerTags(this, prProjection);
   }
 
   CPlacement3D plView;
@@ -683,9 +1251,14 @@ void CPlayerPatch::P_RenderHUD(RENDER_ARGS(prProjection, pdp, vLightDir, colLigh
   // Render crosshair while not sniping
   if (CHud::pRenderCrosshair_opt != NULL && !bSniping)
   {
+    CPlayerWeapons &enWeapons = (CPlayerWeapons &)*m_penWeapons;
     (enWeapons.*CHud::pRenderCrosshair_opt)(prProjection, pdp, plView);
   }
+};
 
+// Blend the screen with damage and world glaring
+void CPlayerPatch::RenderBlendStage(CDrawPort *pdp)
+{
   // Toggleable red screen on damage
   static CSymbolPtr pbRedScreen("axs_bRedScreenOnDamage");
 
@@ -730,9 +1303,131 @@ void CPlayerPatch::P_RenderHUD(RENDER_ARGS(prProjection, pdp, vLightDir, colLigh
 
   // Do all queued screen blendings
   pdp->BlendScreen();
+};
+
+// Render the interface and everything else that's drawn over it
+void CPlayerPatch::RenderInterfaceStage(CDrawPort *pdp, CPlayer *penHUDPlayer, BOOL bSnooping, BOOL bPrepared)
+{
+  static CSymbolPtr pbShowInterface("hud_bShowInfo");
 
   // Draw new HUD
   if (bPrepared && pbShowInterface.GetIndex()) {
     _HUD.DrawHUD(penHUDPlayer, bSnooping, this);
   }
+
+  // Radar and elements added by other plugins
+  if (bPrepared && pbShowInterface.GetIndex()) {
+    _HUD.RenderElements();
+  }
+
+  // Vitals and arsenal of all players for casters
+  if (bPrepared && _psCasterOverview.GetIndex() && !CHud::pGetSP()->sp_bSinglePlayer) {
+    _HUD.RenderCasterOverview();
+  }
+
+  // Check text widths with the current drawport
+  if (_HUD._bVerifyTextWidths) {
+    _HUD._bVerifyTextWidths = FALSE;
+
+    CFontData *apfd[E_HUD_MAX * 2 + 2] = { _pfdConsoleFont, _pfdDisplayFont };
+
+    for (INDEX iTheme = 0; iTheme < E_HUD_MAX; iTheme++) {
+      apfd[2 + iTheme] = &_HUD._afdText[iTheme];
+      apfd[2 + E_HUD_MAX + iTheme] = &_HUD._afdNumbers[iTheme];
+    }
+
+    VerifyTextWidths(pdp, apfd, E_HUD_MAX * 2 + 2);
+  }
+
+  // Replay requested snapshots over the current frame
+  if (_HUD._fnmReplay != "") {
+    _HUD.ReplaySnapshotFile(pdp);
+  }
+};
+
+void CPlayerPatch::P_RenderHUD(RENDER_ARGS(prProjection, pdp, vLightDir, colLight, colAmbient, bRenderWeapon, iEye))
+{
+  // Replace HUD everywhere or only in vanilla if entities haven't been modified
+  const BOOL bReplaceHUD = _psEnable.GetIndex() > 1 || (_psEnable.GetIndex() == 1 && !_bModdedEntities);
+
+  // Proceed to the original function instead
+  if (!bReplaceHUD) {
+    (this->*CHud::pRenderHud)(RENDER_ARGS_RAW(prProjection, pdp, vLightDir, colLight, colAmbient, bRenderWeapon, iEye));
+    return;
+  }
+
+  static CSymbolPtr ptmSnoopingTime("plr_tmSnoopingTime");
+
+  // Save intended view placement before rendering the weapon
+  const CPlacement3D plViewOld = prProjection.ViewerPlacementR();
+
+  CPlayerWeapons &enWeapons = (CPlayerWeapons &)*m_penWeapons;
+
+#if SE1_GAME == SS_TFE
+  const BOOL bSniping = FALSE;
+#else
+  const BOOL bSniping = enWeapons.m_bSniping;
+#endif
+
+  // Weapon model
+  if (IsStageEnabled(E_HS_WEAPON)) {
+    const CTimerValue tvStage = _pTimer->GetHighPrecisionTimer();
+    RenderWeaponStage(RENDER_ARGS_RAW(prProjection, pdp, vLightDir, colLight, colAmbient, bRenderWeapon, iEye), bSniping);
+    EndStage(E_HS_WEAPON, tvStage);
+  }
+
+  // Restore the view projection once for everything that's rendered in the world
+  prProjection.ViewerPlacementL() = plViewOld;
+  prProjection.Prepare();
+
+  // Prepare new HUD
+  const CTimerValue tvSnapshot = _pTimer->GetHighPrecisionTimer();
+
+  BOOL bSnooping = FALSE;
+  CPlayer *penHUDPlayer = this;
+
+  if (penHUDPlayer->IsPredicted()) {
+    penHUDPlayer = (CPlayer *)penHUDPlayer->GetPredictor();
+  }
+
+  // Check if snooping is needed
+  const TIME tmDelta = _pTimer->CurrentTick() - enWeapons.m_tmSnoopingStarted;
+  const FLOAT tmSnooping = ptmSnoopingTime.Exists() ? ptmSnoopingTime.GetFloat() : 1.0f;
+
+  if (tmDelta < tmSnooping) {
+    ASSERT(enWeapons.m_penTargeting != NULL);
+    penHUDPlayer = (CPlayer *)&*enWeapons.m_penTargeting;
+    bSnooping = TRUE;
+  }
+
+  // Can't use the HUD if it can't be prepared
+  const BOOL bPrepared = _HUD.PrepareHUD(penHUDPlayer, pdp);
+
+  // Display positions of other players in coop, in demos or while observing
+  const BOOL bDemo = (_psTagsInDemos.GetIndex() && _pNetwork->IsPlayingDemo());
+  const BOOL bObserving = (_psTagsForObservers.GetIndex() && _pNetwork->IsNetworkEnabled() && !IWorld::AnyLocalPlayers());
+  _HUD._bShowPlayers = (CHud::pGetSP()->sp_bCooperative || bDemo || bObserving);
+
+  EndStage(E_HS_SNAPSHOT, tvSnapshot);
+
+  // Particles, player tags and the crosshair
+  if (IsStageEnabled(E_HS_WORLD)) {
+    const CTimerValue tvStage = _pTimer->GetHighPrecisionTimer();
+    RenderWorldStage(prProjection, pdp, iEye, bSniping, bPrepared);
+    EndStage(E_HS_WORLD, tvStage);
+  }
+
+  // Damage and glaring
+  if (IsStageEnabled(E_HS_BLEND)) {
+    const CTimerValue tvStage = _pTimer->GetHighPrecisionTimer();
+    RenderBlendStage(pdp);
+    EndStage(E_HS_BLEND, tvStage);
+  }
+
+  // 2D interface
+  if (IsStageEnabled(E_HS_INTERFACE)) {
+    const CTimerValue tvStage = _pTimer->GetHighPrecisionTimer();
+    RenderInterfaceStage(pdp, penHUDPlayer, bSnooping, bPrepared);
+    EndStage(E_HS_INTERFACE, tvStage);
+  }
 };
@@ -21,7 +21,16 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #endif
 
 #include "Themes.h"
+#include "ThemeFiles.h"
 #include "WeaponArsenal.h"
+#include "TextBatch.h"
+#include "TagKernel.h"
+#include "HudSnapshot.h"
+#include "CasterOverview.h"
+#include "BossTracker.h"
+#include "HudElements.h"
+#include "FontMetrics.h"
+#include "DrawHash.h"
 
 #include <EntitiesV/StdH/StdH.h>
 #include <EntitiesV/PlayerWeapons.h>
@@ -99,6 +108,7 @@ class CHud {
     FLOAT _fCustomScaling;
 
     ULONG _ulAlphaHUD;
+    INDEX _iTheme; // Theme selected for the current frame
     BOOL _bTSEColors;
     BOOL _bTSETheme;
 
@@ -123,6 +133,33 @@ class CHud {
     CFontData *_pfdCurrentNumbers;
     FLOAT _fTextFontScale;
 
+    // Batch for text that's printed many times per frame
+    CHudTextBatch _tbText;
+
+    // Tags above players processed in bulk
+    HudTagBatch _tagBatch;
+
+    // Radar blips processed in bulk
+    HudBlipBatch _blipBatch;
+
+    // Boss bar value sampled once per tick
+    HudBossTracker _bossTracker;
+
+    // Values read from the game for the current frame
+    HudSnapshot _snap;
+
+    // Overview of all players for casters
+    HudCasterRoster _roster;
+
+    // Commands of all HUD elements for the current frame
+    HudCommandBuffer _cmdElements;
+
+    BOOL _bShowPlayers; // Display positions of other players
+    BOOL _bReplaying; // Rendering recorded snapshots
+    CTFileName _fnmReplay; // Snapshots to replay on the next frame
+    BOOL _bHashReplay; // Check draw hashes of replayed snapshots
+    BOOL _bVerifyTextWidths; // Compare cached text widths on the next frame
+
     // Other
     TIME _tmNow;
     TIME _tmLast;
@@ -150,13 +187,20 @@ class CHud {
     } _cttHUD;
 
     HudTextureSet tex;
-    const HudColorSet *pColorSet;
+    HudColorSet _colSet; // Colors of the current frame
+    COLOR _colSnoopingLight;
+    COLOR _colSnoopingDark;
     HudArsenal arWeapons;
 
   public:
     CHud() {
       _tmNow = -1.0f;
       _tmLast = -1.0f;
+      _iTheme = 0;
+      _bShowPlayers = FALSE;
+      _bReplaying = FALSE;
+      _bHashReplay = FALSE;
+      _bVerifyTextWidths = FALSE;
     };
 
     // Get ammo from the arsenal
@@ -188,9 +232,10 @@ class CHud {
       const PIX pixChar = _pfdCurrentNumbers->GetWidth() + _pfdCurrentNumbers->GetCharSpacing() + 1;
       units.fChar = pixChar * fScale;
 
-      units.fOne  = 32 * fScale;
-      units.fAdv  = 36 * fScale;
-      units.fNext = 40 * fScale;
+      const FLOAT *afUnits = _athdThemes[_iTheme].afUnits;
+      units.fOne  = afUnits[E_HTU_ONE]  * fScale;
+      units.fAdv  = afUnits[E_HTU_ADV]  * fScale;
+      units.fNext = afUnits[E_HTU_NEXT] * fScale;
       units.fHalf = units.fOne * 0.5f;
     };
 
@@ -217,8 +262,10 @@ class CHud {
       FLOAT fMediumHigh, FLOAT fLowMedium, BOOL bSmooth);
 
     // Calculate shake amount and color value depending on value change
-    COLOR AddShaker(const PIX pixAmount, const INDEX iCurrentValue, INDEX &iLastValue,
-                    FLOAT &tmChanged, FLOAT &fMoverX, FLOAT &fMoverY);
+    COLOR AddShaker(const PIX pixAmount, const HudValueHistory &hist, FLOAT &fMoverX, FLOAT &fMoverY);
+
+    // Get number to display for a value that may be counting towards the current one
+    INDEX GetCounterValue(const HudValueHistory &hist);
 
     // Get current color from local color transitions table
     COLOR GetCurrentColor(FLOAT fNormValue);
@@ -226,21 +273,52 @@ class CHud {
     // Gather all players in the array
     void GatherPlayers(void);
 
-    // Fill array with players sorted by a specific statistic
-    void SetAllPlayersStats(CDynamicContainer<CPlayer> &cen, INDEX iSortKey);
+    // Fill array with players from the snapshot sorted by a specific statistic
+    void SortPlayers(CStaticStackArray<HudPlayerInfo *> &apSorted, INDEX iSortKey);
 
     // Update weapon and ammo tables with current info
     void UpdateWeaponArsenal(void);
 
+    // Gather everything that's needed for rendering from the game
+    void CaptureSnapshot(void);
+
     // Prepare interface for rendering
     BOOL PrepareHUD(CPlayer *penCurrent, CDrawPort *pdpCurrent);
 
+    // Prepare drawing variables for rendering the current snapshot
+    void PrepareFrame(CDrawPort *pdpCurrent);
+
     // Render entire interface
     void DrawHUD(const CPlayer *penCurrent, BOOL bSnooping, const CPlayer *penOwner);
 
+    // Render interface from the current snapshot
+    void RenderSnapshot(void);
+
+    // Lay out the weapon selection strip again if anything it depends on has changed
+    const HudWeaponStrip &UpdateWeaponStrip(SIconTexture *ptoWanted);
+
+    // Render entire interface using a specific theme
+    template<INDEX iTheme>
+    void DrawThemedHUD(void);
+
+    // Feed recorded snapshots through the HUD and measure rendering time
+    void ReplaySnapshotFile(CDrawPort *pdp);
+
     // Display tags above players
     void RenderPlayerTags(CPlayer *penThis, CPerspectiveProjection3D &prProjection);
 
+    // Add positions of players and the boss around the viewer to the element commands
+    void EmitRadar(HudCommandBuffer &cmd);
+
+    // Render all HUD elements at once
+    void RenderElements(void);
+
+    // Gather vitals and arsenal of all players once per tick
+    void CaptureCasterRoster(void);
+
+    // Display vitals and arsenal of all players in a grid
+    void RenderCasterOverview(void);
+
     // Initialize everything for drawing the HUD
     void Initialize(void);
 
@@ -253,9 +331,24 @@ class CHud {
     // Draw border using a tile texture
     void DrawBorder(FLOAT fX, FLOAT fY, FLOAT fW, FLOAT fH, COLOR colTiles);
 
+    // Add border quads to the rendering queue with the tile texture already set
+    void AddBorderQuads(FLOAT fX, FLOAT fY, FLOAT fW, FLOAT fH, COLOR colTiles);
+
+    // Calculate quads of a border that uses a tile texture
+    void GetBorderQuads(FLOAT fX, FLOAT fY, FLOAT fW, FLOAT fH, COLOR colTiles, HudQuad aQuads[9]);
+
     // Draw icon texture
     void DrawIcon(FLOAT fX, FLOAT fY, CTextureObject &toIcon, COLOR colDefault, FLOAT fNormValue, BOOL bBlink);
 
+    // Print text aligned to the right using cached text widths
+    void PrintRight(const CTString &strText, PIX pixX, PIX pixY, COLOR col);
+
+    // Print text centered horizontally using cached text widths
+    void PrintCentered(const CTString &strText, PIX pixX, PIX pixY, COLOR col);
+
+    // Print text centered on both axes using cached text widths
+    void PrintCenteredXY(const CTString &strText, PIX pixX, PIX pixY, COLOR col);
+
     // Draw text
     void DrawString(FLOAT fX, FLOAT fY, const CTString &strText, COLOR colDefault, FLOAT fNormValue);
 
@@ -283,16 +376,20 @@ class CHud {
       E_GM_FRAG,
     } _eGameMode;
 
-    void RenderVitals(void);
-    void RenderCurrentWeapon(SIconTexture **pptoWantedWeapon, SIconTexture **pptoCurrentAmmo);
-    void RenderActiveArsenal(SIconTexture *ptoAmmo);
-    void RenderBars(void);
-    void RenderGameModeInfo(void);
+    // Parts are specialized for each theme (see HudThemeTraits)
+    template<INDEX iTheme> void RenderVitals(void);
+    template<INDEX iTheme> void RenderCurrentWeapon(SIconTexture **pptoWantedWeapon, SIconTexture **pptoCurrentAmmo);
+    template<INDEX iTheme> void RenderActiveArsenal(SIconTexture *ptoAmmo);
+    template<INDEX iTheme> void RenderBars(void);
+    template<INDEX iTheme> void RenderGameModeInfo(void);
     void RenderCheats(void);
 
   // HUD colors
   public:
 
+    // Resolve colors of the current theme and custom colors once per frame
+    inline void ResolveColors(const HudColorSet &colTheme);
+
     // Base colors
     inline COLOR COL_Base(void);
     inline COLOR COL_Icon(void);
@@ -324,6 +421,15 @@ class CHud {
 // Main HUD structure
 extern CHud _HUD;
 
+// Print average time spent on rendering the HUD with each theme
+void ReportDrawTime(void);
+
+// Print memory used by HUD textures and fonts
+void ReportMemory(void);
+
+// Compare cached text widths with the drawport on the next frame
+void RequestTextWidthCheck(void);
+
 // Define color getting methods
 #include "Colors.inl"
 
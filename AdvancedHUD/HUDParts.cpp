@@ -21,27 +21,28 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #define TOP_ARMOR  100
 #define TOP_HEALTH 100
 
+template<INDEX iTheme>
 void CHud::RenderVitals(void) {
   // Prepare and draw health info
-  FLOAT fValue = ClampDn(_penPlayer->GetHealth(), 0.0f);
+  FLOAT fValue = ClampDn(_snap.fHealth, 0.0f);
   FLOAT fNormValue = fValue / TOP_HEALTH;
 
   // Adjust border width based on which value is bigger
-  const FLOAT fArmor = _penPlayer->m_fArmor;
+  const FLOAT fArmor = _snap.fArmor;
   const FLOAT fMaxHealthArmor = Max(fValue, fArmor);
   FLOAT fBorderWidth = Clamp((FLOAT)floor(log10(fMaxHealthArmor) + 1.0f), 3.0f, 5.0f);
 
-  if (_psTheme.GetIndex() == E_HUD_SSR) {
+  if (HudThemeTraits<iTheme>::bRevStyle) {
     fBorderWidth = 3.0f;
   }
 
   CTString strValue;
-  strValue.PrintF("%d", (SLONG)ceil(fValue));
+  strValue.PrintF("%d", GetCounterValue(_snap.histHealth));
 
   PrepareColorTransitions(_colMax, _colTop, _colMid, _colLow, 0.5f, 0.25f, FALSE);
 
   FLOAT fMoverX, fMoverY;
-  COLOR col = AddShaker(5, fValue, _penLast->m_iLastHealth, _penLast->m_tmHealthChanged, fMoverX, fMoverY);
+  COLOR col = AddShaker(5, _snap.histHealth, fMoverX, fMoverY);
 
   if (col == NONE) col = GetCurrentColor(fNormValue);
 
@@ -49,7 +50,7 @@ void CHud::RenderVitals(void) {
   FLOAT fRow = _vpixBR(2) - units.fHalf;
 
   DrawBorder(fCol + fMoverX, fRow + fMoverY, units.fOne, units.fOne, _colBorder);
-  DrawIcon(fCol + fMoverX, fRow + fMoverY, tex.toHealth, _colIconStd, fNormValue, TRUE);
+  DrawIcon(fCol + fMoverX, fRow + fMoverY, tex.toHealth.ato[iTheme], _colIconStd, fNormValue, TRUE);
 
   fCol += units.fAdv + units.fChar * (fBorderWidth * 0.5f) - units.fHalf;
 
@@ -61,14 +62,14 @@ void CHud::RenderVitals(void) {
 
   fValue = fArmor;
   fNormValue = fValue / TOP_ARMOR;
-  strValue.PrintF("%d", (SLONG)ceil(fValue));
+  strValue.PrintF("%d", GetCounterValue(_snap.histArmor));
 
   PrepareColorTransitions(_colMax, _colTop, _colMid, C_lGRAY, 0.5f, 0.25f, FALSE);
 
   fCol = _vpixTL(1) + units.fHalf;
   fRow = _vpixBR(2) - (units.fNext + units.fHalf);
 
-  AddShaker(3, fValue, _penLast->m_iLastArmor, _penLast->m_tmArmorChanged, fMoverX, fMoverY);
+  AddShaker(3, _snap.histArmor, fMoverX, fMoverY);
 
   fCol += fMoverX;
   fRow += fMoverY;
@@ -76,13 +77,13 @@ void CHud::RenderVitals(void) {
   DrawBorder(fCol, fRow, units.fOne, units.fOne, _colBorder);
 
   if (fValue <= 50.5f) {
-    DrawIcon(fCol, fRow, tex.atoArmor[0], _colIconStd, fNormValue, FALSE);
+    DrawIcon(fCol, fRow, tex.atoArmor[0].ato[iTheme], _colIconStd, fNormValue, FALSE);
 
   } else if (fValue <= 100.5f) {
-    DrawIcon(fCol, fRow, tex.atoArmor[1], _colIconStd, fNormValue, FALSE);
+    DrawIcon(fCol, fRow, tex.atoArmor[1].ato[iTheme], _colIconStd, fNormValue, FALSE);
 
   } else {
-    DrawIcon(fCol, fRow, tex.atoArmor[2], _colIconStd, fNormValue, FALSE);
+    DrawIcon(fCol, fRow, tex.atoArmor[2].ato[iTheme], _colIconStd, fNormValue, FALSE);
   }
 
   fCol -= fMoverX;
@@ -93,13 +94,16 @@ void CHud::RenderVitals(void) {
   DrawString(fCol, fRow, strValue, GetCurrentColor(fNormValue), fNormValue);
 };
 
+template<INDEX iTheme>
 void CHud::RenderCurrentWeapon(SIconTexture **pptoWantedWeapon, SIconTexture **pptoCurrentAmmo) {
+  const BOOL bTSEColors = HudThemeTraits<iTheme>::bTSEColors;
+
   // Prepare and draw ammo and weapon info
   SIconTexture *ptoAmmo = NULL;
   SIconTexture *ptoCurrent = NULL;
   SIconTexture *ptoWanted = NULL;
-  INDEX iCurrentWeapon = _penWeapons->m_iCurrentWeapon;
-  INDEX iWantedWeapon  = _penWeapons->m_iWantedWeapon;
+  INDEX iCurrentWeapon = _snap.iCurrentWeapon;
+  INDEX iWantedWeapon  = _snap.iWantedWeapon;
 
   // Determine corresponding ammo and weapon texture component
   HudWeapon *pWeaponInfo = NULL;
@@ -129,31 +133,31 @@ void CHud::RenderCurrentWeapon(SIconTexture **pptoWantedWeapon, SIconTexture **p
   FLOAT fRow = _vpixBR(2) - units.fHalf;
 
   // Draw weapons with ammo
-  if (ptoAmmo != NULL && !pGetSP()->sp_bInfiniteAmmo) {
+  if (ptoAmmo != NULL && !_snap.bInfiniteAmmo) {
     // Get amount of ammo
-    INDEX iMaxValue = (_penWeapons->*pGetMaxAmmo)();
-    INDEX iValue = (_penWeapons->*pGetAmmo)();
+    INDEX iMaxValue = _snap.iCurrentMaxAmmo;
+    INDEX iValue = _snap.iCurrentAmmo;
     FLOAT fNormValue = (FLOAT)iValue / (FLOAT)iMaxValue;
 
     CTString strValue;
-    strValue.PrintF("%d", iValue);
+    strValue.PrintF("%d", GetCounterValue(_snap.histAmmo));
 
-    PrepareColorTransitions(_colMax, _colTop, _colMid, _colLow, (_bTSEColors ? 0.30f : 0.5f), (_bTSEColors ? 0.15f : 0.25f), FALSE);
+    PrepareColorTransitions(_colMax, _colTop, _colMid, _colLow, (bTSEColors ? 0.30f : 0.5f), (bTSEColors ? 0.15f : 0.25f), FALSE);
     BOOL bDrawAmmoIcon = _fCustomScaling <= 1.0f;
 
     // Draw weapon and its ammo
     FLOAT fMoverX, fMoverY;
-    COLOR col = AddShaker(4, iValue, _penLast->m_iLastAmmo, _penLast->m_tmAmmoChanged, fMoverX, fMoverY);
+    COLOR col = AddShaker(4, _snap.histAmmo, fMoverX, fMoverY);
 
     // Override with the current color
-    if (_bTSEColors || col == NONE) {
+    if (bTSEColors || col == NONE) {
       col = GetCurrentColor(fNormValue);
     }
 
     fCol -= units.fAdv + units.fChar * 1.5f - units.fHalf;
 
     DrawBorder(fCol + fMoverX, fRow + fMoverY, units.fOne, units.fOne, _colBorder);
-    DrawIcon(fCol + fMoverX, fRow + fMoverY, *ptoCurrent, _colIconStd, fNormValue, !bDrawAmmoIcon);
+    DrawIcon(fCol + fMoverX, fRow + fMoverY, ptoCurrent->ato[iTheme], _colIconStd, fNormValue, !bDrawAmmoIcon);
 
     fCol += units.fAdv + units.fChar * 1.5f - units.fHalf;
     DrawBorder(fCol, fRow, units.fChar * 3, units.fOne, _colBorder);
@@ -162,16 +166,17 @@ void CHud::RenderCurrentWeapon(SIconTexture **pptoWantedWeapon, SIconTexture **p
     if (bDrawAmmoIcon) {
       fCol += units.fAdv + units.fChar * 1.5f - units.fHalf;
       DrawBorder(fCol, fRow, units.fOne, units.fOne, _colBorder);
-      DrawIcon(fCol, fRow, *ptoAmmo, _colIconStd, fNormValue, TRUE);
+      DrawIcon(fCol, fRow, ptoAmmo->ato[iTheme], _colIconStd, fNormValue, TRUE);
     }
 
   // Draw weapons without ammo
   } else if (ptoCurrent != NULL) {
     DrawBorder(fCol, fRow, units.fOne, units.fOne, _colBorder);
-    DrawIcon(fCol, fRow, *ptoCurrent, _colIconStd, 1.0f, FALSE);
+    DrawIcon(fCol, fRow, ptoCurrent->ato[iTheme], _colIconStd, 1.0f, FALSE);
   }
 };
 
+template<INDEX iTheme>
 void CHud::RenderActiveArsenal(SIconTexture *ptoAmmo) {
   PrepareColorTransitions(_colMax, _colTop, _colMid, _colLow, 0.5f, 0.25f, FALSE);
 
@@ -186,11 +191,11 @@ void CHud::RenderActiveArsenal(SIconTexture *ptoAmmo) {
   // Display stored bombs
   #define BOMB_FIRE_TIME 1.5f
 
-  INDEX iBombCount = _penPlayer->m_iSeriousBombCount;
+  INDEX iBombCount = _snap.ctSeriousBombs;
   BOOL bBombFiring = FALSE;
 
   // Active Serious Bomb
-  if (_penPlayer->m_tmSeriousBombFired + BOMB_FIRE_TIME > _pTimer->GetLerpedCurrentTick()) {
+  if (_snap.tmSeriousBombFired + BOMB_FIRE_TIME > _snap.tmLerped) {
     iBombCount = ClampUp(INDEX(iBombCount + 1), (INDEX)3);
     bBombFiring = TRUE;
   }
@@ -203,14 +208,14 @@ void CHud::RenderActiveArsenal(SIconTexture *ptoAmmo) {
     COLOR colBombBar = (iBombCount == 1) ? _colLow : _colTop;
 
     if (bBombFiring) {
-      FLOAT fFactor = (_pTimer->GetLerpedCurrentTick() - _penPlayer->m_tmSeriousBombFired) / BOMB_FIRE_TIME;
+      FLOAT fFactor = (_snap.tmLerped - _snap.tmSeriousBombFired) / BOMB_FIRE_TIME;
       colBombBorder = LerpColor(colBombBorder, _colLow, fFactor);
       colBombIcon = LerpColor(colBombIcon, _colLow, fFactor);
       colBombBar = LerpColor(colBombBar, _colLow, fFactor);
     }
 
     DrawBorder(fCol, fRow, units.fOne, units.fOne, colBombBorder);
-    DrawIcon(fCol, fRow, tex.toASeriousBomb, colBombIcon, fNormValue, FALSE);
+    DrawIcon(fCol, fRow, tex.toASeriousBomb.ato[iTheme], colBombIcon, fNormValue, FALSE);
     DrawBar(fCol + fBarPos, fRow, units.fOne * 0.2f, units.fOne - 2, E_BD_DOWN, colBombBar, fNormValue);
 
     // Make space for bombs
@@ -219,7 +224,7 @@ void CHud::RenderActiveArsenal(SIconTexture *ptoAmmo) {
 #endif
 
   // Display available ammo
-  if (!pGetSP()->sp_bInfiniteAmmo && _psShowAmmoRow.GetIndex()) {
+  if (!_snap.bInfiniteAmmo && _psShowAmmoRow.GetIndex()) {
     for (INDEX iAmmo = GetAmmo().Count() - 1; iAmmo >= 0; iAmmo--) {
       HudAmmo &ai = GetAmmo()[iAmmo];
       ASSERT(ai.iAmmo >= 0);
@@ -242,12 +247,12 @@ void CHud::RenderActiveArsenal(SIconTexture *ptoAmmo) {
       FLOAT fNormValue = (FLOAT)ai.iAmmo / (FLOAT)ai.iMaxAmmo;
 
       FLOAT fMoverX, fMoverY;
-      COLOR col = AddShaker(4, ai.iAmmo, ai.iLastAmmo, ai.tmAmmoChanged, fMoverX, fMoverY);
+      COLOR col = AddShaker(4, _snap.ahistAmmo[iAmmo], fMoverX, fMoverY);
 
       if (col == NONE) col = GetCurrentColor(fNormValue);
 
       DrawBorder(fCol, fRow + fMoverY, units.fOne, units.fOne, _colBorder);
-      DrawIcon(fCol, fRow + fMoverY, *ai.ptoAmmo, colIcon, fNormValue, FALSE);
+      DrawIcon(fCol, fRow + fMoverY, ai.ptoAmmo->ato[iTheme], colIcon, fNormValue, FALSE);
       DrawBar(fCol + fBarPos, fRow + fMoverY, units.fOne * 0.2f, units.fOne - 2, E_BD_DOWN, col, fNormValue);
 
       // Advance to the next position
@@ -263,29 +268,22 @@ void CHud::RenderActiveArsenal(SIconTexture *ptoAmmo) {
   // Display active powerups
   PrepareColorTransitions(_colMax, _colTop, _colMid, _colLow, 0.66f, 0.33f, FALSE);
 
-  // Arrange into arrays
-  TIME ptmPowerups[] = {
-    _penPlayer->m_tmInvisibility,
-    _penPlayer->m_tmInvulnerability,
-    _penPlayer->m_tmSeriousDamage,
-    _penPlayer->m_tmSeriousSpeed,
-  };
-
-  TIME ptmPowerupsMax[] = {
-    _penPlayer->m_tmInvisibilityMax,
-    _penPlayer->m_tmInvulnerabilityMax,
-    _penPlayer->m_tmSeriousDamageMax,
-    _penPlayer->m_tmSeriousSpeedMax,
-  };
+  // Copy to modify them
+  TIME ptmPowerups[MAX_POWERUPS];
+  const TIME *ptmPowerupsMax = _snap.atmPowerupsMax;
+
+  for (INDEX iCopy = 0; iCopy < MAX_POWERUPS; iCopy++) {
+    ptmPowerups[iCopy] = _snap.atmPowerups[iCopy];
+  }
 
   // Count spawn invulnerability as normal invulnerability
   static CSymbolPtr piSpawnInvul("plr_iSpawnInvulIndicator");
 
   const BOOL bSpawnInvul = (piSpawnInvul.Exists() && piSpawnInvul.GetIndex() > 0);
-  const TIME tmSpawnInvul = pGetSP()->sp_tmSpawnInvulnerability;
+  const TIME tmSpawnInvul = _snap.tmSpawnInvul;
 
   if (bSpawnInvul && tmSpawnInvul > 0.0f) {
-    const TIME tmRemaining = _penPlayer->m_tmSpawned + tmSpawnInvul;
+    const TIME tmRemaining = _snap.tmSpawned + tmSpawnInvul;
     ptmPowerups[1] = Max(ptmPowerups[1], tmRemaining);
   }
 
@@ -300,11 +298,11 @@ void CHud::RenderActiveArsenal(SIconTexture *ptoAmmo) {
 
     // Draw icon and a little bar
     DrawBorder(fCol, fRow, units.fOne, units.fOne, _colBorder);
-    DrawIcon(fCol, fRow, tex.atoPowerups[iPowerUp], _colIconStd, fNormValue, TRUE);
+    DrawIcon(fCol, fRow, tex.atoPowerups[iPowerUp].ato[iTheme], _colIconStd, fNormValue, TRUE);
     DrawBar(fCol + fBarPos, fRow, units.fOne * 0.2f, units.fOne - 2, E_BD_DOWN, GetCurrentColor(fNormValue), fNormValue);
 
-    // Play sound if icon is flashing
-    if (pPlayPowerUpSound_opt != NULL && fNormValue <= _cttHUD.ctt_fLowMedium * 0.5f)
+    // Play sound if icon is flashing (not during replays)
+    if (!_bReplaying && pPlayPowerUpSound_opt != NULL && fNormValue <= _cttHUD.ctt_fLowMedium * 0.5f)
     {
       INDEX iLastTime = INDEX(_tmLast * 4);
       INDEX iCurrentTime = INDEX(_tmNow * 4);
@@ -320,14 +318,13 @@ void CHud::RenderActiveArsenal(SIconTexture *ptoAmmo) {
 #endif
 };
 
+template<INDEX iTheme>
 void CHud::RenderBars(void) {
   // Draw oxygen info
   BOOL bOxygenOnScreen = FALSE;
-  FLOAT fValue = _penPlayer->en_tmMaxHoldBreath - (_pTimer->CurrentTick() - _penPlayer->en_tmLastBreathed);
+  FLOAT fValue = _snap.tmAirLeft;
 
-  const BOOL bConnected = (pIsConnected_opt != NULL) ? (_penPlayer->*pIsConnected_opt)() : TRUE;
-
-  if (bConnected && _penPlayer->GetFlags() & ENF_ALIVE && fValue < 30.0f) { 
+  if (_snap.bConnected && _snap.bAlive && fValue < 30.0f) {
     FLOAT fCol = 320.0f + units.fHalf;
     FLOAT fRow = _vpixTL(2) + units.fOne + units.fNext;
 
@@ -342,71 +339,40 @@ void CHud::RenderBars(void) {
     DrawBar(fCol, fRow, fBarSize * 0.975f, units.fOne * 0.9375f, E_BD_LEFT, GetCurrentColor(fNormValue), fNormValue);
 
     DrawBorder(fColIcon, fRow, units.fOne, units.fOne, _colBorder);
-    DrawIcon(fColIcon, fRow, tex.toOxygen, _colIconStd, fNormValue, TRUE);
+    DrawIcon(fColIcon, fRow, tex.toOxygen.ato[iTheme], _colIconStd, fNormValue, TRUE);
 
     bOxygenOnScreen = TRUE;
   }
 
   // Draw boss energy
-  if (_penPlayer->m_penMainMusicHolder != NULL) {
-    CMusicHolder &mh = (CMusicHolder &)*_penPlayer->m_penMainMusicHolder;
-    FLOAT fNormValue = 0;
-
-    if (mh.m_penBoss != NULL && mh.m_penBoss->GetFlags() & ENF_ALIVE) {
-      CEnemyBase &eb = (CEnemyBase &)*mh.m_penBoss;
-      ASSERT(eb.m_fMaxHealth > 0);
+  const FLOAT fNormValue = _snap.fBossBar;
 
-      fValue = eb.GetHealth();
-      fNormValue = fValue / eb.m_fMaxHealth;
+  if (fNormValue > 0) {
+    if (HudThemeTraits<iTheme>::bTSETheme) {
+      PrepareColorTransitions(_colMax, _colMax, _colTop, _colLow, 0.5f, 0.25f, FALSE);
+    } else {
+      PrepareColorTransitions(_colMax, _colTop, _colMid, _colLow, 0.5f, 0.25f, FALSE);
     }
 
-    if (mh.m_penCounter != NULL) {
-      CEntity *penCounter = mh.m_penCounter;
-
-      // Find CEnemyCounter::m_iCount and CEnemyCounter::m_iCountFrom
-      static CPropertyPtr pptrCountCurr(penCounter);
-      static CPropertyPtr pptrCountFrom(penCounter);
-
-      BOOL bProps = pptrCountCurr.ByVariable("CEnemyCounter", "m_iCount")
-                 && pptrCountFrom.ByVariable("CEnemyCounter", "m_iCountFrom");
+    FLOAT fCol = 320.0f + units.fHalf;
+    FLOAT fRow = _vpixTL(2) + units.fOne + units.fNext;
 
-      if (bProps) {
-        INDEX iCountCurr = ENTITYPROPERTY(penCounter, pptrCountCurr.Offset(), INDEX);
-        INDEX iCountFrom = ENTITYPROPERTY(penCounter, pptrCountFrom.Offset(), INDEX);
+    FLOAT fBarSize = units.fOne * 16.0f;
+    FLOAT fColIcon = fCol - (fBarSize * 0.5f) - units.fAdv + units.fHalf;
 
-        if (iCountCurr > 0) {
-          fValue = iCountCurr;
-          fNormValue = fValue / iCountFrom;
-        }
-      }
+    if (bOxygenOnScreen) {
+      fRow += units.fNext;
     }
 
-    if (fNormValue > 0) {
-      if (_bTSETheme) {
-        PrepareColorTransitions(_colMax, _colMax, _colTop, _colLow, 0.5f, 0.25f, FALSE);
-      } else {
-        PrepareColorTransitions(_colMax, _colTop, _colMid, _colLow, 0.5f, 0.25f, FALSE);
-      }
-
-      FLOAT fCol = 320.0f + units.fHalf;
-      FLOAT fRow = _vpixTL(2) + units.fOne + units.fNext;
-
-      FLOAT fBarSize = units.fOne * 16.0f;
-      FLOAT fColIcon = fCol - (fBarSize * 0.5f) - units.fAdv + units.fHalf;
-
-      if (bOxygenOnScreen) {
-        fRow += units.fNext;
-      }
-
-      DrawBorder(fCol, fRow, fBarSize, units.fOne, _colBorder);
-      DrawBar(fCol, fRow, fBarSize * 0.995f, units.fOne * 0.9375f, E_BD_LEFT, GetCurrentColor(fNormValue), fNormValue);
+    DrawBorder(fCol, fRow, fBarSize, units.fOne, _colBorder);
+    DrawBar(fCol, fRow, fBarSize * 0.995f, units.fOne * 0.9375f, E_BD_LEFT, GetCurrentColor(fNormValue), fNormValue);
 
-      DrawBorder(fColIcon, fRow, units.fOne, units.fOne, _colBorder);
-      DrawIcon(fColIcon, fRow, tex.toHealth, _colIconStd, fNormValue, FALSE);
-    }
+    DrawBorder(fColIcon, fRow, units.fOne, units.fOne, _colBorder);
+    DrawIcon(fColIcon, fRow, tex.toHealth.ato[iTheme], _colIconStd, fNormValue, FALSE);
   }
 };
 
+template<INDEX iTheme>
 void CHud::RenderGameModeInfo(void) {
   static CSymbolPtr pbMessages("hud_bShowMessages");
   static CSymbolPtr piPlayers("hud_iShowPlayers");
@@ -416,7 +382,7 @@ void CHud::RenderGameModeInfo(void) {
   const INDEX iShowPlayers = piPlayers.GetIndex();
 
   // Display lives counter
-  const BOOL bShowLives = _psShowLives.GetIndex() && pGetSP()->sp_ctCredits > 0;
+  const BOOL bShowLives = _psShowLives.GetIndex() && _snap.ctCredits > 0;
 
 #if SE1_GAME == SS_TFE
   const INDEX bShowMatchInfo = _psShowMatchInfo.GetIndex();
@@ -428,7 +394,8 @@ void CHud::RenderGameModeInfo(void) {
   // Display details for PvE games
   const EGameMode eMode = _eGameMode;
   const BOOL bCoopDetails = (eMode == E_GM_SP || eMode == E_GM_COOP);
-  const BOOL bRev = (_psTheme.GetIndex() == E_HUD_SSR);
+  const BOOL bRev = HudThemeTraits<iTheme>::bRevStyle;
+  const BOOL bTSETheme = HudThemeTraits<iTheme>::bTSETheme;
   const COLOR colDefault = COL_PlayerNames();
 
   COLOR colMana, colFrags, colDeaths, colHealth, colArmor;
@@ -475,25 +442,33 @@ void CHud::RenderGameModeInfo(void) {
       eKey = E_SK_NAME;
     }
 
-    CDynamicContainer<CPlayer> cenSorted;
-    SetAllPlayersStats(cenSorted, eKey);
+    CStaticStackArray<HudPlayerInfo *> apSorted;
+    SortPlayers(apSorted, eKey);
 
     // Show ping next to player names
     const INDEX iShowPing = _psShowPlayerPing.GetIndex();
 
-    // Go through all players
-    INDEX iPlayer = 0;
+    // Local player in the list
+    const HudPlayerInfo *pLocal = NULL;
+
+    if (_snap.iLocalPlayer >= 0) {
+      pLocal = &_snap.aPlayers[_snap.iLocalPlayer];
+    }
+
+    // Lay out the entire player list in one text batch
+    _tbText.Begin(_pdp);
 
-    FOREACHINDYNAMICCONTAINER(cenSorted, CPlayer, iten) {
-      CPlayer *penPlayer = iten;
+    // Go through all players
+    for (INDEX iPlayer = 0; iPlayer < apSorted.Count(); iPlayer++) {
+      const HudPlayerInfo &info = *apSorted[iPlayer];
 
       // Get player stats as strings
-      const INDEX iScore = penPlayer->m_psGameStats.ps_iScore;
-      const INDEX iMana = penPlayer->m_iMana;
-      const INDEX iFrags = penPlayer->m_psGameStats.ps_iKills;
-      const INDEX iDeaths = penPlayer->m_psGameStats.ps_iDeaths;
-      const INDEX iHealth = ClampDn((INDEX)ceil(penPlayer->GetHealth()), 0L);
-      const INDEX iArmor = ClampDn((INDEX)ceil(penPlayer->m_fArmor), 0L);
+      const INDEX iScore = info.iScore;
+      const INDEX iMana = info.iMana;
+      const INDEX iFrags = info.iKills;
+      const INDEX iDeaths = info.iDeaths;
+      const INDEX iHealth = ClampDn((INDEX)ceil(info.fHealth), 0L);
+      const INDEX iArmor = ClampDn((INDEX)ceil(info.fArmor), 0L);
 
       CTString strScore, strMana, strFrags, strDeaths, strHealth, strArmor, strPing;
       strScore.PrintF("%d", iScore);
@@ -505,7 +480,7 @@ void CHud::RenderGameModeInfo(void) {
 
       // Display ping
       if (iShowPing > 0) {
-        const INDEX iPing = ClampDn(INDEX(penPlayer->en_tmPing * 1000), (INDEX)0);
+        const INDEX iPing = ClampDn(INDEX(info.tmPing * 1000), (INDEX)0);
 
         // Ping colors by level
         static const CTString astrPingColors[] = {
@@ -545,28 +520,28 @@ void CHud::RenderGameModeInfo(void) {
       colHealth = C_mlRED;
       colMana = colScore = colFrags = colDeaths = colArmor = C_lGRAY;
 
-      if (iMana > _penPlayer->m_iMana) {
+      if (iMana > _snap.iMana) {
         bMaxMana = FALSE;
         colMana = C_WHITE;
       }
 
-      if (iScore > _penPlayer->m_psGameStats.ps_iScore) {
+      if (iScore > _snap.iScore) {
         bMaxScore = FALSE;
         colScore = C_WHITE;
       }
 
-      if (iFrags > _penPlayer->m_psGameStats.ps_iKills) {
+      if (iFrags > _snap.iKills) {
         bMaxFrags = FALSE;
         colFrags = C_WHITE;
       }
 
-      if (iDeaths > _penPlayer->m_psGameStats.ps_iDeaths) {
+      if (iDeaths > _snap.iDeaths) {
         bMaxDeaths = FALSE;
         colDeaths = C_WHITE;
       }
 
       // Current player
-      if (penPlayer == _penPlayer) {
+      if (&info == pLocal) {
         colScore = colMana = colFrags = colDeaths = colDefault;
       }
 
@@ -611,7 +586,7 @@ void CHud::RenderGameModeInfo(void) {
 
         // Display player ping and make space for it
         if (iShowPing > 0) {
-          _pdp->PutTextR(strPing, pixOffsetX * _vScaling(1), pixInfoY, C_WHITE | _ulAlphaHUD);
+          _tbText.AddText(strPing, pixOffsetX * _vScaling(1), pixInfoY, C_WHITE | _ulAlphaHUD, CHudTextBatch::E_TA_RIGHT);
 
           pixOffsetX -= (iShowPing > 1) ? 12 : 28;
         }
@@ -622,45 +597,53 @@ void CHud::RenderGameModeInfo(void) {
         CTString strName;
 
         if (_psDecoratedNames.GetIndex()) {
-          strName = penPlayer->GetPlayerName();
+          strName = info.strName;
         } else {
-          strName = penPlayer->GetPlayerName().Undecorated();
+          strName = info.strName.Undecorated();
         }
 
         // Display player stats
+        #define TA_L CHudTextBatch::E_TA_LEFT
+        #define TA_C CHudTextBatch::E_TA_CENTER
+        #define TA_R CHudTextBatch::E_TA_RIGHT
+
         if (eMode == E_GM_COOP) {
-          _pdp->PutTextR(strName,   PLAYER_INFO_X(8), pixInfoY, colScore   | _ulAlphaHUD);
-          _pdp->PutTextC(strHealth, PLAYER_INFO_X(6), pixInfoY, colHealth  | _ulAlphaHUD);
-          _pdp->PutText("/",        PLAYER_INFO_X(4), pixInfoY, colDefault | _ulAlphaHUD);
-          _pdp->PutTextC(strArmor,  PLAYER_INFO_X(2), pixInfoY, colArmor   | _ulAlphaHUD);
+          _tbText.AddText(strName,   PLAYER_INFO_X(8), pixInfoY, colScore   | _ulAlphaHUD, TA_R);
+          _tbText.AddText(strHealth, PLAYER_INFO_X(6), pixInfoY, colHealth  | _ulAlphaHUD, TA_C);
+          _tbText.AddText("/",       PLAYER_INFO_X(4), pixInfoY, colDefault | _ulAlphaHUD, TA_L);
+          _tbText.AddText(strArmor,  PLAYER_INFO_X(2), pixInfoY, colArmor   | _ulAlphaHUD, TA_C);
 
         } else if (eMode == E_GM_SCORE) {
-          _pdp->PutTextR(strName,  PLAYER_INFO_X(12), pixInfoY, colDefault | _ulAlphaHUD);
-          _pdp->PutTextC(strScore, PLAYER_INFO_X(8),  pixInfoY, colScore   | _ulAlphaHUD);
-          _pdp->PutText("/",       PLAYER_INFO_X(5),  pixInfoY, colDefault | _ulAlphaHUD);
-          _pdp->PutTextC(strMana,  PLAYER_INFO_X(2),  pixInfoY, colMana    | _ulAlphaHUD);
+          _tbText.AddText(strName,  PLAYER_INFO_X(12), pixInfoY, colDefault | _ulAlphaHUD, TA_R);
+          _tbText.AddText(strScore, PLAYER_INFO_X(8),  pixInfoY, colScore   | _ulAlphaHUD, TA_C);
+          _tbText.AddText("/",      PLAYER_INFO_X(5),  pixInfoY, colDefault | _ulAlphaHUD, TA_L);
+          _tbText.AddText(strMana,  PLAYER_INFO_X(2),  pixInfoY, colMana    | _ulAlphaHUD, TA_C);
 
         } else {
-          _pdp->PutTextR(strName,   PLAYER_INFO_X(8), pixInfoY, colDefault | _ulAlphaHUD);
-          _pdp->PutTextC(strFrags,  PLAYER_INFO_X(6), pixInfoY, colFrags   | _ulAlphaHUD);
-          _pdp->PutText("/",        PLAYER_INFO_X(4), pixInfoY, colDefault | _ulAlphaHUD);
-          _pdp->PutTextC(strDeaths, PLAYER_INFO_X(2), pixInfoY, colDeaths  | _ulAlphaHUD);
+          _tbText.AddText(strName,   PLAYER_INFO_X(8), pixInfoY, colDefault | _ulAlphaHUD, TA_R);
+          _tbText.AddText(strFrags,  PLAYER_INFO_X(6), pixInfoY, colFrags   | _ulAlphaHUD, TA_C);
+          _tbText.AddText("/",       PLAYER_INFO_X(4), pixInfoY, colDefault | _ulAlphaHUD, TA_L);
+          _tbText.AddText(strDeaths, PLAYER_INFO_X(2), pixInfoY, colDeaths  | _ulAlphaHUD, TA_C);
         }
+
+        #undef TA_L
+        #undef TA_C
+        #undef TA_R
       }
 
       // Summarize score for coop
       iScoreSum += iScore;
-
-      // Next player in the list
-      iPlayer++;
     }
 
+    // Render the player list
+    _tbText.Flush(_pdp);
+
     if ((eMode == E_GM_SCORE || eMode == E_GM_FRAG) && bShowMatchInfo) {
       CTString strLimitsInfo = "";
 
       // Draw remaining time
-      if (pGetSP()->sp_iTimeLimit > 0) {
-        FLOAT fTimeLeft = ClampDn(pGetSP()->sp_iTimeLimit * 60.0f - _pNetwork->GetGameTime(), (TIME)0.0);
+      if (_snap.iTimeLimit > 0) {
+        FLOAT fTimeLeft = ClampDn(_snap.iTimeLimit * 60.0f - _snap.tmGameTime, (TIME)0.0);
         strLimitsInfo.PrintF("%s^cFFFFFF%s: %s\n", strLimitsInfo, LOCALIZE("TIME LEFT"), TimeToString(fTimeLeft));
       }
 
@@ -668,18 +651,18 @@ void CHud::RenderGameModeInfo(void) {
       INDEX iMaxFrags = LowerLimit(INDEX(0));
       INDEX iMaxScore = LowerLimit(INDEX(0));
 
-      {FOREACHINDYNAMICCONTAINER(_cenPlayers, CPlayer, itenStats) {
-        iMaxFrags = Max(iMaxFrags, itenStats->m_psLevelStats.ps_iKills);
-        iMaxScore = Max(iMaxScore, itenStats->m_psLevelStats.ps_iScore);
-      }}
+      for (INDEX iStats = 0; iStats < _snap.aPlayers.Count(); iStats++) {
+        iMaxFrags = Max(iMaxFrags, _snap.aPlayers[iStats].iLevelKills);
+        iMaxScore = Max(iMaxScore, _snap.aPlayers[iStats].iLevelScore);
+      }
 
-      if (pGetSP()->sp_iFragLimit > 0) {
-        INDEX iFragsLeft = ClampDn(pGetSP()->sp_iFragLimit-iMaxFrags, INDEX(0));
+      if (_snap.iFragLimit > 0) {
+        INDEX iFragsLeft = ClampDn(_snap.iFragLimit-iMaxFrags, INDEX(0));
         strLimitsInfo.PrintF("%s^cFFFFFF%s: %d\n", strLimitsInfo, LOCALIZE("FRAGS LEFT"), iFragsLeft);
       }
 
-      if (pGetSP()->sp_iScoreLimit > 0) {
-        INDEX iScoreLeft = ClampDn(pGetSP()->sp_iScoreLimit-iMaxScore, INDEX(0));
+      if (_snap.iScoreLimit > 0) {
+        INDEX iScoreLeft = ClampDn(_snap.iScoreLimit-iMaxScore, INDEX(0));
         strLimitsInfo.PrintF("%s^cFFFFFF%s: %d\n", strLimitsInfo, LOCALIZE("SCORE LEFT"), iScoreLeft);
       }
 
@@ -691,6 +674,8 @@ void CHud::RenderGameModeInfo(void) {
       // [Cecil] Screen edge offset
       const PIX pixInfoX = _vpixTL(1);
       const PIX pixInfoY = _vpixTL(2) + units.fNext * 2;
+
+      HashDrawText(_pfdCurrentText, _pdp->dp_fTextScaling, strLimitsInfo, pixInfoX * _vScaling(1), pixInfoY * _vScaling(1), C_WHITE | CT_OPAQUE);
       _pdp->PutText(strLimitsInfo, pixInfoX * _vScaling(1), pixInfoY * _vScaling(1), C_WHITE | CT_OPAQUE);
     }
 
@@ -709,16 +694,16 @@ void CHud::RenderGameModeInfo(void) {
 
   // Prepare outputs depending on gamemode
   FLOAT fWidthAdj = 8;
-  INDEX iScore = _penPlayer->m_psGameStats.ps_iScore;
-  INDEX iMana = _penPlayer->m_iMana;
+  INDEX iScore = _snap.iScore;
+  INDEX iMana = _snap.iMana;
 
   if (eMode == E_GM_FRAG) {
     if (!bShowMatchInfo) {
       fWidthAdj = 4;
     }
 
-    iScore = _penPlayer->m_psGameStats.ps_iKills;
-    iMana = _penPlayer->m_psGameStats.ps_iDeaths;
+    iScore = _snap.iKills;
+    iMana = _snap.iDeaths;
 
   // Show score in coop
   } else if (eMode == E_GM_COOP) {
@@ -736,7 +721,7 @@ void CHud::RenderGameModeInfo(void) {
   DrawBorder(fCol, fRow, units.fOne, units.fOne, _colBorder);
   DrawBorder(fCol + fAdv, fRow, units.fChar * fWidthAdj, units.fOne, _colBorder);
   DrawString(fCol + fAdv, fRow, strValue, (bRev ? _colTop : colScore), 1.0f);
-  DrawIcon(fCol, fRow, tex.toFrags, (_bTSETheme ? C_WHITE : colScore), 1.0f, FALSE);
+  DrawIcon(fCol, fRow, tex.toFrags.ato[iTheme], (bTSETheme ? C_WHITE : colScore), 1.0f, FALSE);
 
   // Deathmatch
   if (eMode == E_GM_SCORE || eMode == E_GM_FRAG) {
@@ -748,23 +733,17 @@ void CHud::RenderGameModeInfo(void) {
     DrawBorder(fCol, fRow, units.fOne, units.fOne, _colBorder);
     DrawBorder(fCol + fAdv, fRow, units.fChar * fWidthAdj, units.fOne, _colBorder);
     DrawString(fCol + fAdv, fRow, strValue, (bRev ? _colTop : colMana), 1.0f);
-    DrawIcon(fCol, fRow, tex.toDeaths, (_bTSETheme ? C_WHITE : colMana), 1.0f, FALSE);
+    DrawIcon(fCol, fRow, tex.toDeaths.ato[iTheme], (bTSETheme ? C_WHITE : colMana), 1.0f, FALSE);
 
   // Singleplayer or cooperative
   } else if (bCoopDetails) {
     // Draw high score
     if (_psShowHighScore.GetIndex())
     {
-    #if SE1_GAME != SS_REV
-      const INDEX iHighScore = _penPlayer->m_iHighScore;
-    #else
-      // [Cecil] TODO: Find out which stat from Revolution could be used as a high score
-      // Maybe it can read those "world stats" and retrieve the highest score per level?
-      const INDEX iHighScore = UpperLimit(INDEX(0));
-    #endif
+      const INDEX iHighScore = _snap.iHighScore;
 
-      strValue.PrintF("%d", Max(iHighScore, _penPlayer->m_psGameStats.ps_iScore));
-      BOOL bBeating = _penPlayer->m_psGameStats.ps_iScore > iHighScore;
+      strValue.PrintF("%d", Max(iHighScore, _snap.iScore));
+      BOOL bBeating = _snap.iScore > iHighScore;
 
       fCol = 320.0f + units.fHalf;
       fRow = _vpixTL(2) + units.fHalf;
@@ -774,7 +753,7 @@ void CHud::RenderGameModeInfo(void) {
       DrawString(fCol, fRow, strValue, GetCurrentColor(!bBeating), !bBeating);
 
       DrawBorder(fCol - fAdv, fRow, units.fOne, units.fOne, _colBorder);
-      DrawIcon(fCol - fAdv, fRow, tex.toHiScore, _colIconStd, 1.0f, FALSE);
+      DrawIcon(fCol - fAdv, fRow, tex.toHiScore.ato[iTheme], _colIconStd, 1.0f, FALSE);
     }
 
     // Adjustable start of messages
@@ -785,8 +764,8 @@ void CHud::RenderGameModeInfo(void) {
       // Rescale
       const FLOAT fUndoScale = Rescale(1.75f);
 
-      const INDEX iValue = ClampDn(pGetSP()->sp_ctCreditsLeft, (INDEX)0);
-      const FLOAT fNormValue = (FLOAT)iValue / (FLOAT)pGetSP()->sp_ctCredits;
+      const INDEX iValue = ClampDn(_snap.ctCreditsLeft, (INDEX)0);
+      const FLOAT fNormValue = (FLOAT)iValue / (FLOAT)_snap.ctCredits;
 
       strValue.PrintF("%d", iValue);
 
@@ -807,8 +786,8 @@ void CHud::RenderGameModeInfo(void) {
     }
 
     // Draw unread messages
-    if (bShowMessages && _penPlayer->m_ctUnreadMessages > 0) {
-      strValue.PrintF("%d", _penPlayer->m_ctUnreadMessages);
+    if (bShowMessages && _snap.ctUnreadMessages > 0) {
+      strValue.PrintF("%d", _snap.ctUnreadMessages);
 
       fCol = _vpixBR(1) - units.fHalf - units.fChar * 4;
       fAdv = units.fAdv + units.fChar * 2 - units.fHalf;
@@ -816,7 +795,7 @@ void CHud::RenderGameModeInfo(void) {
       const FLOAT tmIn = 0.5f;
       const FLOAT tmOut = 0.5f;
       const FLOAT tmStay = 2.0f;
-      FLOAT tmDelta = _pTimer->GetLerpedCurrentTick() - _penPlayer->m_tmAnimateInbox;
+      FLOAT tmDelta = _snap.tmLerped - _snap.tmAnimateInbox;
       COLOR colMessageBorder = _colBorder;
       COLOR colMessageIcon = _colHUD;
 
@@ -839,14 +818,14 @@ void CHud::RenderGameModeInfo(void) {
       DrawBorder(fCol, fRow, units.fOne, units.fOne, colMessageBorder);
       DrawBorder(fCol + fAdv, fRow, units.fChar * 4, units.fOne, colMessageBorder);
       DrawString(fCol + fAdv, fRow, strValue, colMessageIcon, 1.0f);
-      DrawIcon(fCol, fRow, tex.toMessage, (_bTSETheme ? C_WHITE : colMessageIcon), 0.0f, TRUE);
+      DrawIcon(fCol, fRow, tex.toMessage.ato[iTheme], (bTSETheme ? C_WHITE : colMessageIcon), 0.0f, TRUE);
     }
   }
 };
 
 void CHud::RenderCheats(void) {
   // Render active cheats while in singleplayer
-  if (pGetSP()->sp_ctMaxPlayers != 1) return;
+  if (_snap.ctMaxPlayers != 1) return;
 
   ULONG ulAlpha = sin(_tmNow * 16) * 96 + 128;
   PIX pixFontHeight = _pfdConsoleFont->fd_pixCharHeight;
@@ -866,22 +845,35 @@ void CHud::RenderCheats(void) {
   #define CHEAT_LINE_Y (_vpixScreen(2) - pixFontHeight * (iLine++))
 
   if (pfTrans.GetFloat() > 1.0f) {
-    _pdp->PutTextR("turbo", _vpixScreen(1) - 1, CHEAT_LINE_Y, colCheat);
+    PrintRight("turbo", _vpixScreen(1) - 1, CHEAT_LINE_Y, colCheat);
   }
 
   if (pbInvisible.GetIndex()) {
-    _pdp->PutTextR("invisible", _vpixScreen(1) - 1, CHEAT_LINE_Y, colCheat);
+    PrintRight("invisible", _vpixScreen(1) - 1, CHEAT_LINE_Y, colCheat);
   }
 
   if (pbGhost.GetIndex()) {
-    _pdp->PutTextR("ghost", _vpixScreen(1) - 1, CHEAT_LINE_Y, colCheat);
+    PrintRight("ghost", _vpixScreen(1) - 1, CHEAT_LINE_Y, colCheat);
   }
 
   if (pbFly.GetIndex()) {
-    _pdp->PutTextR("fly", _vpixScreen(1) - 1, CHEAT_LINE_Y, colCheat);
+    PrintRight("fly", _vpixScreen(1) - 1, CHEAT_LINE_Y, colCheat);
   }
 
   if (pbGod.GetIndex()) {
-    _pdp->PutTextR("god", _vpixScreen(1) - 1, CHEAT_LINE_Y, colCheat);
+    PrintRight("god", _vpixScreen(1) - 1, CHEAT_LINE_Y, colCheat);
   }
 };
+
+// Specialize parts of the HUD for each theme
+#define INSTANTIATE_HUD_PARTS(_Theme) \
+  template void CHud::RenderVitals<_Theme>(void); \
+  template void CHud::RenderCurrentWeapon<_Theme>(SIconTexture **, SIconTexture **); \
+  template void CHud::RenderActiveArsenal<_Theme>(SIconTexture *); \
+  template void CHud::RenderBars<_Theme>(void); \
+  template void CHud::RenderGameModeInfo<_Theme>(void);
+
+INSTANTIATE_HUD_PARTS(E_HUD_TFE);
+INSTANTIATE_HUD_PARTS(E_HUD_WARPED);
+INSTANTIATE_HUD_PARTS(E_HUD_TSE);
+INSTANTIATE_HUD_PARTS(E_HUD_SSR);
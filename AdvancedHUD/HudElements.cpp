@@ -0,0 +1,272 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "HUD.h"
+
+// Element added to the HUD
+struct HudElement {
+  HudElementDesc desc;
+  CTString strName; // Own copy of the name
+
+  TIME tmPrepared; // Game tick of the last preparation
+  DOUBLE dPrepareTime; // Time of the last preparation that hasn't been counted yet
+  DOUBLE dDebt; // Time over the budget that still needs to be skipped
+
+  // Commands from the last emission that are repeated while skipping
+  CStaticStackArray<HudQuadCommand> aLastQuads;
+  CStaticStackArray<HudTextCommand> aLastTexts;
+
+  // Statistics
+  DOUBLE dTime;
+  DOUBLE dMaxTime;
+  INDEX ctFrames;
+  INDEX ctOverBudget;
+  INDEX ctSkipped;
+
+  HudElement(const HudElementDesc &descSet) : desc(descSet), strName(descSet.strName),
+    tmPrepared(-1.0f), dPrepareTime(0.0), dDebt(0.0),
+    dTime(0.0), dMaxTime(0.0), ctFrames(0), ctOverBudget(0), ctSkipped(0)
+  {
+    desc.strName = strName.str_String;
+  };
+};
+
+// All elements in order of addition
+static CDynamicContainer<HudElement> _cElements;
+
+// Add quad with an entire texture
+void HudCommandBuffer::AddQuad(CTextureObject *pto, FLOAT fI0, FLOAT fJ0, FLOAT fI1, FLOAT fJ1, COLOR col) {
+  HudQuadCommand &cmd = aQuads.Push();
+  cmd.pto = pto;
+  cmd.bClamp = FALSE;
+
+  HudQuad &quad = cmd.quad;
+  quad.fI0 = fI0; quad.fJ0 = fJ0; quad.fI1 = fI1; quad.fJ1 = fJ1;
+  quad.fU0 = 0.0f; quad.fV0 = 0.0f; quad.fU1 = 1.0f; quad.fV1 = 1.0f;
+  quad.col = col;
+};
+
+// Add quad with a part of the texture
+void HudCommandBuffer::AddQuad(CTextureObject *pto, const HudQuad &quad, BOOL bClamp) {
+  HudQuadCommand &cmd = aQuads.Push();
+  cmd.pto = pto;
+  cmd.bClamp = bClamp;
+  cmd.quad = quad;
+};
+
+// Add text line
+void HudCommandBuffer::AddText(const CTString &strText, FLOAT fX, FLOAT fY, COLOR col, INDEX iAlign) {
+  HudTextCommand &cmd = aTexts.Push();
+  cmd.strText = strText;
+  cmd.fX = fX;
+  cmd.fY = fY;
+  cmd.col = col;
+  cmd.iAlign = iAlign;
+};
+
+// Remove all commands
+void HudCommandBuffer::Clear(void) {
+  aQuads.PopAll();
+  aTexts.PopAll();
+};
+
+// Draw all quads in order, coalescing consecutive quads with the same texture, then all text in one batch using the current drawport font
+void HudCommandBuffer::Submit(CDrawPort *pdp, CHudTextBatch &tbText) {
+  const INDEX ctQuads = aQuads.Count();
+  BOOL bQueued = FALSE;
+  CTextureObject *ptoQueued = NULL;
+  BOOL bClampQueued = FALSE;
+
+  for (INDEX iQuad = 0; iQuad < ctQuads; iQuad++) {
+    const HudQuadCommand &cmd = aQuads[iQuad];
+
+    // Switch texture only when it changes
+    if (!bQueued || cmd.pto != ptoQueued || cmd.bClamp != bClampQueued) {
+      if (bQueued) pdp->FlushRenderingQueue();
+
+      pdp->InitTexture(cmd.pto, cmd.bClamp);
+      HashDrawTexture(cmd.pto);
+      ptoQueued = cmd.pto;
+      bClampQueued = cmd.bClamp;
+      bQueued = TRUE;
+    }
+
+    const HudQuad &q = cmd.quad;
+    HashDrawQuad(q);
+    pdp->AddTexture(q.fI0, q.fJ0, q.fI1, q.fJ1, q.fU0, q.fV0, q.fU1, q.fV1, q.col);
+  }
+
+  if (bQueued) pdp->FlushRenderingQueue();
+
+  const INDEX ctTexts = aTexts.Count();
+  if (ctTexts == 0) return;
+
+  tbText.Begin(pdp);
+
+  for (INDEX iText = 0; iText < ctTexts; iText++) {
+    const HudTextCommand &cmd = aTexts[iText];
+    tbText.AddText(cmd.strText, cmd.fX, cmd.fY, cmd.col, (CHudTextBatch::EAlign)cmd.iAlign);
+  }
+
+  tbText.Flush(pdp);
+};
+
+// Find element by its name
+static HudElement *FindHudElement(const char *strName) {
+  for (INDEX iElement = 0; iElement < _cElements.Count(); iElement++) {
+    HudElement *pel = _cElements.Pointer(iElement);
+    if (pel->strName == strName) return pel;
+  }
+
+  return NULL;
+};
+
+// Add new element to the HUD (fails if the name is already taken)
+BOOL AddHudElement(const HudElementDesc &desc) {
+  if (desc.strName == NULL || desc.pEmit == NULL) {
+    CPrintF(TRANS("Cannot add a HUD element without a name or an emit function!\n"));
+    return FALSE;
+  }
+
+  if (FindHudElement(desc.strName) != NULL) {
+    CPrintF(TRANS("HUD element '%s' already exists!\n"), desc.strName);
+    return FALSE;
+  }
+
+  _cElements.Add(new HudElement(desc));
+  return TRUE;
+};
+
+// Remove element from the HUD by its name
+BOOL RemoveHudElement(const char *strName) {
+  HudElement *pel = FindHudElement(strName);
+  if (pel == NULL) return FALSE;
+
+  _cElements.Remove(pel);
+  delete pel;
+  return TRUE;
+};
+
+// Let elements gather data if they need to be updated
+void PrepareHudElements(const HudSnapshot &snap) {
+  for (INDEX iElement = 0; iElement < _cElements.Count(); iElement++) {
+    HudElement &el = *_cElements.Pointer(iElement);
+    if (el.desc.pPrepare == NULL) continue;
+
+    // Catch up after skipping
+    if (el.dDebt > 0.0) continue;
+
+    // Timer has been reset
+    if (snap.tmTick < el.tmPrepared) el.tmPrepared = -1.0f;
+
+    // Already up to date
+    const TIME tmInterval = (el.desc.fUpdateRate > 0.0f) ? 1.0f / el.desc.fUpdateRate : 0.0f;
+    if (snap.tmTick == el.tmPrepared || snap.tmTick - el.tmPrepared < tmInterval) continue;
+
+    const CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+
+    el.desc.pPrepare(el.desc.pUserData, snap);
+    el.tmPrepared = snap.tmTick;
+
+    // Count towards the next emitted frame
+    el.dPrepareTime += (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds();
+  }
+};
+
+// Let elements add their commands for the current frame
+void EmitHudElements(const HudElementFrame &frame, HudCommandBuffer &cmd) {
+  for (INDEX iElement = 0; iElement < _cElements.Count(); iElement++) {
+    HudElement &el = *_cElements.Pointer(iElement);
+    const DOUBLE dBudget = el.desc.fBudget * 0.000001;
+
+    // Repeat the last frame of the element until it's back within its budget
+    if (el.dDebt > 0.0) {
+      el.dDebt -= dBudget;
+      el.ctSkipped++;
+
+      const INDEX ctQuads = el.aLastQuads.Count();
+      const INDEX ctTexts = el.aLastTexts.Count();
+
+      for (INDEX iQuad = 0; iQuad < ctQuads; iQuad++) {
+        cmd.aQuads.Push() = el.aLastQuads[iQuad];
+      }
+
+      for (INDEX iText = 0; iText < ctTexts; iText++) {
+        cmd.aTexts.Push() = el.aLastTexts[iText];
+      }
+      continue;
+    }
+
+    const INDEX iFirstQuad = cmd.aQuads.Count();
+    const INDEX iFirstText = cmd.aTexts.Count();
+    const CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+
+    el.desc.pEmit(el.desc.pUserData, frame, cmd);
+
+    const DOUBLE dTime = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds() + el.dPrepareTime;
+    el.dPrepareTime = 0.0;
+
+    // Remember commands for skipped frames
+    el.aLastQuads.PopAll();
+    el.aLastTexts.PopAll();
+
+    for (INDEX iQuad = iFirstQuad; iQuad < cmd.aQuads.Count(); iQuad++) {
+      el.aLastQuads.Push() = cmd.aQuads[iQuad];
+    }
+
+    for (INDEX iText = iFirstText; iText < cmd.aTexts.Count(); iText++) {
+      el.aLastTexts.Push() = cmd.aTexts[iText];
+    }
+
+    el.dTime += dTime;
+    el.dMaxTime = Max(el.dMaxTime, dTime);
+    el.ctFrames++;
+
+    // Skip as many frames as it takes to pay off the extra time
+    if (dBudget > 0.0 && dTime > dBudget) {
+      el.dDebt = dTime - dBudget;
+      el.ctOverBudget++;
+    }
+  }
+};
+
+// Print time spent by each element and reset it
+void ReportHudElements(void) {
+  for (INDEX iElement = 0; iElement < _cElements.Count(); iElement++) {
+    HudElement &el = *_cElements.Pointer(iElement);
+    if (el.ctFrames == 0) continue;
+
+    CPrintF(TRANS("  %-6s: %7.2f us, %.2f us max, %d of %d frames over %.0f us, %d skipped\n"), el.strName.str_String,
+      el.dTime / el.ctFrames * 1000000.0, el.dMaxTime * 1000000.0, el.ctOverBudget, el.ctFrames, el.desc.fBudget, el.ctSkipped);
+
+    // Start over
+    el.dTime = 0.0;
+    el.dMaxTime = 0.0;
+    el.ctFrames = 0;
+    el.ctOverBudget = 0;
+    el.ctSkipped = 0;
+  }
+};
+
+// Exported for other plugins
+BOOL AdvancedHUD_AddElement(const HudElementDesc *pDesc) {
+  return AddHudElement(*pDesc);
+};
+
+BOOL AdvancedHUD_RemoveElement(const char *strName) {
+  return RemoveHudElement(strName);
+};
@@ -0,0 +1,119 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#ifndef CECIL_INCL_HUDELEMENTS_H
+#define CECIL_INCL_HUDELEMENTS_H
+
+#ifdef PRAGMA_ONCE
+  #pragma once
+#endif
+
+struct HudSnapshot;
+class CHudTextBatch;
+
+// Textured quad in screen pixels
+struct HudQuad {
+  FLOAT fI0, fJ0, fI1, fJ1;
+  FLOAT fU0, fV0, fU1, fV1;
+  COLOR col;
+};
+
+// Quad that needs to be drawn with a specific texture
+struct HudQuadCommand {
+  CTextureObject *pto; // NULL for a plain fill
+  BOOL bClamp;
+  HudQuad quad;
+};
+
+// Text line that needs to be printed in the HUD text font
+struct HudTextCommand {
+  CTString strText;
+  FLOAT fX;
+  FLOAT fY;
+  COLOR col;
+  INDEX iAlign; // CHudTextBatch::EAlign
+};
+
+// Drawing commands from all HUD elements that are submitted at once
+struct HudCommandBuffer {
+  CStaticStackArray<HudQuadCommand> aQuads;
+  CStaticStackArray<HudTextCommand> aTexts;
+
+  // Add quad with an entire texture
+  void AddQuad(CTextureObject *pto, FLOAT fI0, FLOAT fJ0, FLOAT fI1, FLOAT fJ1, COLOR col);
+
+  // Add quad with a part of the texture
+  void AddQuad(CTextureObject *pto, const HudQuad &quad, BOOL bClamp = FALSE);
+
+  // Add text line
+  void AddText(const CTString &strText, FLOAT fX, FLOAT fY, COLOR col, INDEX iAlign = 0);
+
+  // Remove all commands
+  void Clear(void);
+
+  // Draw all quads in order, coalescing consecutive quads with the same texture, then all text in one batch using the current drawport font
+  void Submit(CDrawPort *pdp, CHudTextBatch &tbText);
+};
+
+// Drawing variables of the current frame for HUD elements
+struct HudElementFrame {
+  const HudSnapshot *psnap;
+  PIX2D vpixScreen;
+  FLOAT2D vScaling; // Pixels per HUD unit (640x480 screen)
+  PIX2D vpixTL; // HUD boundaries in HUD units
+  PIX2D vpixBR;
+  FLOAT fWideAdjustment;
+  FLOAT fHudScaling;
+  ULONG ulAlpha;
+  INDEX iTheme;
+  TIME tmNow;
+};
+
+// Gather data from the game at the element's update rate
+typedef void (*FHudElementPrepare)(void *pUserData, const HudSnapshot &snap);
+
+// Add drawing commands of the element for the current frame
+typedef void (*FHudElementEmit)(void *pUserData, const HudElementFrame &frame, HudCommandBuffer &cmd);
+
+// Description of an element that can be added to the HUD
+struct HudElementDesc {
+  const char *strName;
+  FHudElementPrepare pPrepare; // Optional
+  FHudElementEmit pEmit;
+  void *pUserData;
+  FLOAT fUpdateRate; // Preparations per second (0 for every game tick)
+  FLOAT fBudget; // Average time per frame in microseconds (0 for unlimited)
+};
+
+// Add new element to the HUD (fails if the name is already taken)
+BOOL AddHudElement(const HudElementDesc &desc);
+
+// Remove element from the HUD by its name
+BOOL RemoveHudElement(const char *strName);
+
+// Let elements gather data if they need to be updated
+void PrepareHudElements(const HudSnapshot &snap);
+
+// Let elements add their commands for the current frame
+void EmitHudElements(const HudElementFrame &frame, HudCommandBuffer &cmd);
+
+// Print time spent by each element and reset it
+void ReportHudElements(void);
+
+// Exported for other plugins
+extern "C" __declspec(dllexport) BOOL AdvancedHUD_AddElement(const HudElementDesc *pDesc);
+extern "C" __declspec(dllexport) BOOL AdvancedHUD_RemoveElement(const char *strName);
+
+#endif
@@ -0,0 +1,176 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "HUD.h"
+
+// Current snapshot format
+static const INDEX _iSnapshotVersion = 3;
+
+// Stream for recording snapshots
+static CTFileStream _strmRecording;
+static BOOL _bRecording = FALSE;
+static INDEX _ctRecorded = 0;
+
+// Read and write plain values
+#define WRITE_VALUE(_Value) strm.Write_t(&(_Value), sizeof(_Value))
+#define READ_VALUE(_Value) strm.Read_t(&(_Value), sizeof(_Value))
+
+void HudPlayerInfo::Write_t(CTStream &strm) const {
+  strm << strName;
+  WRITE_VALUE(fHealth);
+  WRITE_VALUE(fArmor);
+  WRITE_VALUE(iScore);
+  WRITE_VALUE(iMana);
+  WRITE_VALUE(iKills);
+  WRITE_VALUE(iDeaths);
+  WRITE_VALUE(iLevelScore);
+  WRITE_VALUE(iLevelKills);
+  WRITE_VALUE(tmPing);
+};
+
+void HudPlayerInfo::Read_t(CTStream &strm) {
+  strm >> strName;
+  READ_VALUE(fHealth);
+  READ_VALUE(fArmor);
+  READ_VALUE(iScore);
+  READ_VALUE(iMana);
+  READ_VALUE(iKills);
+  READ_VALUE(iDeaths);
+  READ_VALUE(iLevelScore);
+  READ_VALUE(iLevelKills);
+  READ_VALUE(tmPing);
+};
+
+// Apply some macro to each plain value of a snapshot
+#define SNAPSHOT_VALUES(_Macro) \
+  _Macro(tmTick); _Macro(tmLerped); _Macro(tmGameTime); \
+  _Macro(iGameMode); _Macro(bInfiniteAmmo); _Macro(ctMaxPlayers); _Macro(ctCredits); _Macro(ctCreditsLeft); \
+  _Macro(iTimeLimit); _Macro(iFragLimit); _Macro(iScoreLimit); _Macro(tmSpawnInvul); \
+  _Macro(fHealth); _Macro(fArmor); _Macro(bAlive); _Macro(bConnected); _Macro(tmAirLeft); _Macro(tmLatency); \
+  _Macro(iCurrentWeapon); _Macro(iWantedWeapon); _Macro(iAvailableWeapons); \
+  _Macro(iCurrentAmmo); _Macro(iCurrentMaxAmmo); _Macro(aiAmmo); _Macro(aiMaxAmmo); _Macro(tmWeaponChangeRequired); \
+  _Macro(histHealth); _Macro(histArmor); _Macro(histAmmo); _Macro(ahistAmmo); \
+  _Macro(ctSeriousBombs); _Macro(tmSeriousBombFired); _Macro(atmPowerups); _Macro(atmPowerupsMax); _Macro(tmSpawned); \
+  _Macro(fBossBar); \
+  _Macro(iScore); _Macro(iMana); _Macro(iKills); _Macro(iDeaths); _Macro(iHighScore); \
+  _Macro(ctUnreadMessages); _Macro(tmAnimateInbox); \
+  _Macro(plView); _Macro(bSnooping); _Macro(bSniperMask); \
+  _Macro(fRayHitDistance); _Macro(fSniperFOV); _Macro(fEnemyHealth); _Macro(tmLastSniperFire); \
+  _Macro(iLocalPlayer);
+
+// Write snapshot into a stream
+void HudSnapshot::Write_t(CTStream &strm) const {
+  strm.WriteID_t("SNAP");
+  SNAPSHOT_VALUES(WRITE_VALUE);
+
+  const INDEX ctPlayers = aPlayers.Count();
+  strm << ctPlayers;
+
+  for (INDEX i = 0; i < ctPlayers; i++) {
+    aPlayers[i].Write_t(strm);
+  }
+};
+
+// Read snapshot from a stream
+void HudSnapshot::Read_t(CTStream &strm) {
+  strm.ExpectID_t("SNAP");
+  SNAPSHOT_VALUES(READ_VALUE);
+
+  INDEX ctPlayers;
+  strm >> ctPlayers;
+
+  if (ctPlayers < 0 || ctPlayers > NET_MAXGAMEPLAYERS) {
+    ThrowF_t(TRANS("Invalid amount of players in a snapshot: %d"), ctPlayers);
+  }
+
+  aPlayers.PopAll();
+  if (ctPlayers > 0) aPlayers.Push(ctPlayers);
+
+  for (INDEX i = 0; i < ctPlayers; i++) {
+    aPlayers[i].Read_t(strm);
+  }
+};
+
+// Open a file with recorded snapshots and check its header
+void OpenSnapshotFile_t(CTFileStream &strm, const CTFileName &fnm) {
+  strm.Open_t(fnm);
+  strm.ExpectID_t("AHSN");
+
+  INDEX iVersion;
+  strm >> iVersion;
+
+  if (iVersion != _iSnapshotVersion) {
+    ThrowF_t(TRANS("Unsupported snapshot version: %d"), iVersion);
+  }
+};
+
+// Start recording HUD snapshots into a file
+void StartSnapshotRecording(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const CTString &strFile = *NEXT_ARG(CTString *);
+
+  StopSnapshotRecording();
+
+  try {
+    _strmRecording.Create_t(CTFileName(strFile));
+    _strmRecording.WriteID_t("AHSN");
+    _strmRecording << _iSnapshotVersion;
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot start recording HUD snapshots: %s\n"), strError);
+    return;
+  }
+
+  _bRecording = TRUE;
+  _ctRecorded = 0;
+
+  CPrintF(TRANS("Recording HUD snapshots into '%s'...\n"), strFile.str_String);
+};
+
+// Stop recording HUD snapshots
+void StopSnapshotRecording(void) {
+  if (!_bRecording) return;
+
+  _strmRecording.Close();
+  _bRecording = FALSE;
+
+  CPrintF(TRANS("Recorded %d HUD snapshots\n"), _ctRecorded);
+};
+
+// Record a snapshot if the recording is active
+void RecordSnapshot(const HudSnapshot &snap) {
+  if (!_bRecording) return;
+
+  try {
+    snap.Write_t(_strmRecording);
+    _ctRecorded++;
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot record HUD snapshot: %s\n"), strError);
+    StopSnapshotRecording();
+  }
+};
+
+// Replay HUD snapshots from a file the next time the HUD is rendered
+void ReplaySnapshots(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const CTString &strFile = *NEXT_ARG(CTString *);
+
+  _HUD._fnmReplay = CTFileName(strFile);
+  _HUD._bHashReplay = FALSE;
+  CPrintF(TRANS("HUD snapshots from '%s' will be replayed on the next frame\n"), strFile.str_String);
+};
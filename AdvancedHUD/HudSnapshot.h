@@ -0,0 +1,176 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#ifndef CECIL_INCL_HUDSNAPSHOT_H
+#define CECIL_INCL_HUDSNAPSHOT_H
+
+#ifdef PRAGMA_ONCE
+  #pragma once
+#endif
+
+// Amount of ammo types in the arsenal
+#define HUD_AMMO_SLOTS 8
+
+// Statistics of one player in the player list
+struct HudPlayerInfo {
+  CTString strName; // Decorated name
+  FLOAT fHealth;
+  FLOAT fArmor;
+  INDEX iScore;
+  INDEX iMana;
+  INDEX iKills;
+  INDEX iDeaths;
+  INDEX iLevelScore;
+  INDEX iLevelKills;
+  FLOAT tmPing;
+
+  void Write_t(CTStream &strm) const;
+  void Read_t(CTStream &strm);
+};
+
+// Values of a number from the last two changes, updated once per tick
+struct HudValueHistory {
+  INDEX iPrev; // Value before the last change
+  INDEX iCurr; // Current value
+  TIME tmChanged; // When the value has changed
+
+  HudValueHistory() : iPrev(0), iCurr(0), tmChanged(-9) {};
+
+  // Start over from some value
+  inline void Reset(INDEX iValue, TIME tmSetChanged) {
+    iPrev = iValue;
+    iCurr = iValue;
+    tmChanged = tmSetChanged;
+  };
+
+  // Record value of the current tick
+  inline void Update(INDEX iValue, TIME tmTick) {
+    if (iValue != iCurr) {
+      iPrev = iCurr;
+      iCurr = iValue;
+      tmChanged = tmTick;
+
+    } else {
+      // In case of loading (timer got reset)
+      tmChanged = ClampUp(tmChanged, tmTick);
+    }
+  };
+
+  // Get value between the last two over some time after the change
+  inline FLOAT Interpolate(TIME tmNow, TIME tmDuration) const {
+    const FLOAT fFactor = Clamp((tmNow - tmChanged) / tmDuration, 0.0f, 1.0f);
+    return Lerp((FLOAT)iPrev, (FLOAT)iCurr, fFactor);
+  };
+};
+
+// Everything the HUD reads from the game for rendering one frame
+struct HudSnapshot {
+  // Time
+  TIME tmTick; // Current game tick
+  TIME tmLerped; // Interpolated game tick
+  TIME tmGameTime; // Time since the start of the game
+
+  // Session
+  INDEX iGameMode; // CHud::EGameMode
+  BOOL bInfiniteAmmo;
+  INDEX ctMaxPlayers;
+  INDEX ctCredits;
+  INDEX ctCreditsLeft;
+  INDEX iTimeLimit;
+  INDEX iFragLimit;
+  INDEX iScoreLimit;
+  TIME tmSpawnInvul;
+
+  // Vitals
+  FLOAT fHealth;
+  FLOAT fArmor;
+  BOOL bAlive;
+  BOOL bConnected;
+  TIME tmAirLeft; // Time until the player starts drowning
+  TIME tmLatency;
+
+  // Arsenal
+  INDEX iCurrentWeapon;
+  INDEX iWantedWeapon;
+  INDEX iAvailableWeapons;
+  INDEX iCurrentAmmo;
+  INDEX iCurrentMaxAmmo;
+  INDEX aiAmmo[HUD_AMMO_SLOTS];
+  INDEX aiMaxAmmo[HUD_AMMO_SLOTS];
+  TIME tmWeaponChangeRequired;
+
+  // Changes of displayed values
+  HudValueHistory histHealth;
+  HudValueHistory histArmor;
+  HudValueHistory histAmmo; // Current weapon
+  HudValueHistory ahistAmmo[HUD_AMMO_SLOTS]; // Ammo row
+
+  // Powerups
+  INDEX ctSeriousBombs;
+  TIME tmSeriousBombFired;
+  TIME atmPowerups[MAX_POWERUPS];
+  TIME atmPowerupsMax[MAX_POWERUPS];
+  TIME tmSpawned;
+
+  // Boss health or enemy counter (0 if none)
+  FLOAT fBossBar;
+
+  // Statistics of the HUD owner
+  INDEX iScore;
+  INDEX iMana;
+  INDEX iKills;
+  INDEX iDeaths;
+  INDEX iHighScore;
+  INDEX ctUnreadMessages;
+  TIME tmAnimateInbox;
+
+  // View
+  CPlacement3D plView;
+  BOOL bSnooping;
+  BOOL bSniperMask;
+
+  // Sniper scope
+  FLOAT fRayHitDistance;
+  FLOAT fSniperFOV; // Interpolated
+  FLOAT fEnemyHealth; // Health ratio of the enemy in sight
+  TIME tmLastSniperFire;
+
+  // All players in the game
+  CStaticStackArray<HudPlayerInfo> aPlayers;
+  INDEX iLocalPlayer; // HUD owner in the player list (-1 if not there)
+
+  // Write snapshot into a stream
+  void Write_t(CTStream &strm) const;
+
+  // Read snapshot from a stream
+  void Read_t(CTStream &strm);
+};
+
+// Open a file with recorded snapshots and check its header
+void OpenSnapshotFile_t(CTFileStream &strm, const CTFileName &fnm);
+
+// Start recording HUD snapshots into a file
+void StartSnapshotRecording(SHELL_FUNC_ARGS);
+
+// Stop recording HUD snapshots
+void StopSnapshotRecording(void);
+
+// Record a snapshot if the recording is active
+void RecordSnapshot(const HudSnapshot &snap);
+
+// Replay HUD snapshots from a file the next time the HUD is rendered
+void ReplaySnapshots(SHELL_FUNC_ARGS);
+
+#endif
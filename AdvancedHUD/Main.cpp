@@ -24,18 +24,18 @@ CLASSICSPATCH_DEFINE_PLUGIN(k_EPluginFlagGame | k_EPluginFlagEditor, CORE_PATCH_
 // Check if playing with modified entities
 BOOL _bModdedEntities = FALSE;
 
+// How textures of inactive themes are loaded (EThemeTextures)
+INDEX _iThemeTextures = 0;
+
 CPluginSymbol _psEnable(SSF_PERSISTENT | SSF_USER, INDEX(1));
 
 // Select default theme
-#if SE1_GAME == SS_TFE
-  CPluginSymbol _psTheme(SSF_PERSISTENT | SSF_USER, (INDEX)E_HUD_TFE);
-#else
-  CPluginSymbol _psTheme(SSF_PERSISTENT | SSF_USER, (INDEX)E_HUD_TSE);
-#endif
+CPluginSymbol _psTheme(SSF_PERSISTENT | SSF_USER, (INDEX)HUD_DEFAULT_THEME);
 
 CPluginSymbol _psScreenEdgeX(SSF_PERSISTENT | SSF_USER, INDEX(5));
 CPluginSymbol _psScreenEdgeY(SSF_PERSISTENT | SSF_USER, INDEX(5));
 CPluginSymbol _psIconShake(SSF_PERSISTENT | SSF_USER, INDEX(1));
+CPluginSymbol _psSmoothCounters(SSF_PERSISTENT | SSF_USER, INDEX(0));
 
 #if SE1_GAME == SS_TFE
   // TFE specific
@@ -58,6 +58,13 @@ CPluginSymbol _psShowLives(SSF_PERSISTENT | SSF_USER, INDEX(1));
 CPluginSymbol _psPlayerTags(SSF_PERSISTENT | SSF_USER, INDEX(2));
 CPluginSymbol _psTagsInDemos(SSF_PERSISTENT | SSF_USER, INDEX(1));
 CPluginSymbol _psTagsForObservers(SSF_PERSISTENT | SSF_USER, INDEX(1));
+CPluginSymbol _psCasterOverview(SSF_PERSISTENT | SSF_USER, INDEX(0));
+
+CPluginSymbol _psRadar(SSF_PERSISTENT | SSF_USER, INDEX(0));
+CPluginSymbol _psRadarRange(SSF_PERSISTENT | SSF_USER, FLOAT(64.0f));
+
+// Stages of HUD rendering to skip for profiling (bit per stage)
+CPluginSymbol _psSkipStages(SSF_USER, INDEX(0));
 
 // HUD colorization (no alpha channel)
 CPluginSymbol _psColorize(SSF_PERSISTENT | SSF_USER, INDEX(0));
@@ -83,6 +90,9 @@ CLASSICSPATCH_PLUGIN_STARTUP(CIniConfig &props, PluginEvents_t &events)
     _bModdedEntities = !props.GetBoolValue("", "SameHook", false);
   }
 
+  // Reduce memory used by themes that aren't active
+  _iThemeTextures = props.GetIntValue("", "ThemeTextures", 0);
+
   // Custom symbols
   _psEnable.Register("ahud_bEnable");
   _psTheme.Register("ahud_iTheme");
@@ -90,6 +100,7 @@ CLASSICSPATCH_PLUGIN_STARTUP(CIniConfig &props, PluginEvents_t &events)
   _psScreenEdgeX.Register("ahud_iScreenEdgeX");
   _psScreenEdgeY.Register("ahud_iScreenEdgeY");
   _psIconShake.Register("ahud_bIconShake");
+  _psSmoothCounters.Register("ahud_bSmoothCounters");
 
   #if SE1_GAME == SS_TFE
     // TFE specific
@@ -112,6 +123,11 @@ CLASSICSPATCH_PLUGIN_STARTUP(CIniConfig &props, PluginEvents_t &events)
   _psPlayerTags.Register("ahud_iPlayerTags");
   _psTagsInDemos.Register("ahud_bTagsInDemos");
   _psTagsForObservers.Register("ahud_bTagsForObservers");
+  _psCasterOverview.Register("ahud_bCasterOverview");
+
+  _psRadar.Register("ahud_iRadar");
+  _psRadarRange.Register("ahud_fRadarRange");
+  _psSkipStages.Register("ahud_iSkipStages");
 
   _psColorize.Register("ahud_bColorize");
   _psColorPreset.Register("ahud_strColorPreset");
@@ -126,6 +142,15 @@ CLASSICSPATCH_PLUGIN_STARTUP(CIniConfig &props, PluginEvents_t &events)
   _psColorMid.Register("ahud_iColorMid");
   _psColorLow.Register("ahud_iColorLow");
 
+  GetPluginAPI()->RegisterMethod(TRUE, "void", "ahud_BenchmarkTags",    "void",     &BenchmarkTags);
+  GetPluginAPI()->RegisterMethod(TRUE, "void", "ahud_ReportDrawTime",   "void",     &ReportDrawTime);
+  GetPluginAPI()->RegisterMethod(TRUE, "void", "ahud_ReportMemory",     "void",     &ReportMemory);
+  GetPluginAPI()->RegisterMethod(TRUE, "void", "ahud_VerifyTextWidths", "void",     &RequestTextWidthCheck);
+  GetPluginAPI()->RegisterMethod(TRUE, "void", "ahud_RecordSnapshots",  "CTString", &StartSnapshotRecording);
+  GetPluginAPI()->RegisterMethod(TRUE, "void", "ahud_StopRecording",    "void",     &StopSnapshotRecording);
+  GetPluginAPI()->RegisterMethod(TRUE, "void", "ahud_ReplaySnapshots",  "CTString", &ReplaySnapshots);
+  GetPluginAPI()->RegisterMethod(TRUE, "void", "ahud_CheckDrawHashes",  "CTString", &ReplayDrawHashes);
+
   // Initialize the HUD itself
   _HUD.Initialize();
 };
@@ -133,6 +158,9 @@ CLASSICSPATCH_PLUGIN_STARTUP(CIniConfig &props, PluginEvents_t &events)
 // Module cleanup
 CLASSICSPATCH_PLUGIN_SHUTDOWN(CIniConfig &props)
 {
+  // Finish unsaved snapshots
+  StopSnapshotRecording();
+
   // Clean up the HUD
   _HUD.End();
 };
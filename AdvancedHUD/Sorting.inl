@@ -16,51 +16,51 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 // Comparison methods for qsort()
 
 static int qsort_CompareNames(const void *ppPEN0, const void *ppPEN1) {
-  CPlayer &en0 = **(CPlayer **)ppPEN0;
-  CPlayer &en1 = **(CPlayer **)ppPEN1;
-  CTString strName0 = en0.GetPlayerName().Undecorated();
-  CTString strName1 = en1.GetPlayerName().Undecorated();
+  const HudPlayerInfo &en0 = **(HudPlayerInfo **)ppPEN0;
+  const HudPlayerInfo &en1 = **(HudPlayerInfo **)ppPEN1;
+  CTString strName0 = en0.strName.Undecorated();
+  CTString strName1 = en1.strName.Undecorated();
 
   return strnicmp(strName0, strName1, 8);
 };
 
 static int qsort_CompareScores(const void *ppPEN0, const void *ppPEN1) {
-  CPlayer &en0 = **(CPlayer **)ppPEN0;
-  CPlayer &en1 = **(CPlayer **)ppPEN1;
-  SLONG sl0 = en0.m_psGameStats.ps_iScore;
-  SLONG sl1 = en1.m_psGameStats.ps_iScore;
+  const HudPlayerInfo &en0 = **(HudPlayerInfo **)ppPEN0;
+  const HudPlayerInfo &en1 = **(HudPlayerInfo **)ppPEN1;
+  SLONG sl0 = en0.iScore;
+  SLONG sl1 = en1.iScore;
   return Sgn(sl1 - sl0);
 };
 
 static int qsort_CompareHealth(const void *ppPEN0, const void *ppPEN1) {
-  CPlayer &en0 = **(CPlayer **)ppPEN0;
-  CPlayer &en1 = **(CPlayer **)ppPEN1;
-  SLONG sl0 = (SLONG)ceil(en0.GetHealth());
-  SLONG sl1 = (SLONG)ceil(en1.GetHealth());
+  const HudPlayerInfo &en0 = **(HudPlayerInfo **)ppPEN0;
+  const HudPlayerInfo &en1 = **(HudPlayerInfo **)ppPEN1;
+  SLONG sl0 = (SLONG)ceil(en0.fHealth);
+  SLONG sl1 = (SLONG)ceil(en1.fHealth);
   return Sgn(sl1 - sl0);
 };
 
 static int qsort_CompareManas(const void *ppPEN0, const void *ppPEN1) {
-  CPlayer &en0 = **(CPlayer **)ppPEN0;
-  CPlayer &en1 = **(CPlayer **)ppPEN1;
-  SLONG sl0 = en0.m_iMana;
-  SLONG sl1 = en1.m_iMana;
+  const HudPlayerInfo &en0 = **(HudPlayerInfo **)ppPEN0;
+  const HudPlayerInfo &en1 = **(HudPlayerInfo **)ppPEN1;
+  SLONG sl0 = en0.iMana;
+  SLONG sl1 = en1.iMana;
   return Sgn(sl1 - sl0);
 };
 
 static int qsort_CompareDeaths(const void *ppPEN0, const void *ppPEN1) {
-  CPlayer &en0 = **(CPlayer **)ppPEN0;
-  CPlayer &en1 = **(CPlayer **)ppPEN1;
-  SLONG sl0 = en0.m_psGameStats.ps_iDeaths;
-  SLONG sl1 = en1.m_psGameStats.ps_iDeaths;
+  const HudPlayerInfo &en0 = **(HudPlayerInfo **)ppPEN0;
+  const HudPlayerInfo &en1 = **(HudPlayerInfo **)ppPEN1;
+  SLONG sl0 = en0.iDeaths;
+  SLONG sl1 = en1.iDeaths;
   return Sgn(sl1 - sl0);
 };
 
 static int qsort_CompareFrags(const void *ppPEN0, const void *ppPEN1) {
-  CPlayer &en0 = **(CPlayer **)ppPEN0;
-  CPlayer &en1 = **(CPlayer **)ppPEN1;
-  SLONG sl0 = en0.m_psGameStats.ps_iKills;
-  SLONG sl1 = en1.m_psGameStats.ps_iKills;
+  const HudPlayerInfo &en0 = **(HudPlayerInfo **)ppPEN0;
+  const HudPlayerInfo &en1 = **(HudPlayerInfo **)ppPEN1;
+  SLONG sl0 = en0.iKills;
+  SLONG sl1 = en1.iKills;
 
   if (sl0 < sl1) {
     return +1;
@@ -19,12 +19,16 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 // Check if playing with modified entities
 extern BOOL _bModdedEntities;
 
+// How textures of inactive themes are loaded
+extern INDEX _iThemeTextures;
+
 extern CPluginSymbol _psEnable;
 extern CPluginSymbol _psTheme;
 
 extern CPluginSymbol _psScreenEdgeX;
 extern CPluginSymbol _psScreenEdgeY;
 extern CPluginSymbol _psIconShake;
+extern CPluginSymbol _psSmoothCounters;
 
 #if SE1_GAME == SS_TFE
   // TFE specific
@@ -47,6 +51,11 @@ extern CPluginSymbol _psShowLives;
 extern CPluginSymbol _psPlayerTags;
 extern CPluginSymbol _psTagsInDemos;
 extern CPluginSymbol _psTagsForObservers;
+extern CPluginSymbol _psCasterOverview;
+
+extern CPluginSymbol _psRadar;
+extern CPluginSymbol _psRadarRange;
+extern CPluginSymbol _psSkipStages;
 
 extern CPluginSymbol _psColorize;
 extern CPluginSymbol _psColorBase;
@@ -0,0 +1,413 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "TagKernel.h"
+
+#if AHUD_TAGS_SSE
+  #include <emmintrin.h>
+#endif
+
+// Distance between probing points of the projection
+#define PROBE_STEP (8.0f)
+
+// Prepare viewer setup for a prepared projection and the player that's viewing it
+void HudTagView::Setup(CPerspectiveProjection3D &pr, const CPlacement3D &plViewer, FLOAT fSetScaling) {
+  pprProjection = &pr;
+  vViewer = plViewer.pl_PositionVector;
+  fScaling = fSetScaling;
+
+  FLOATmatrix3D mViewer;
+  MakeRotationMatrixFast(mViewer, plViewer.pl_OrientationAngle);
+  vUp = FLOAT3D(0, 1, 0) * mViewer;
+
+  // Depth, horizontal and vertical positions multiplied by depth are linear in world space,
+  // so the projection can be reconstructed from a few points in front of the view
+  const CPlacement3D &plView = pr.ViewerPlacementR();
+
+  FLOAT3D vDir;
+  AnglesToDirectionVector(plView.pl_OrientationAngle, vDir);
+  vOrigin = plView.pl_PositionVector + vDir * (PROBE_STEP * 2.0f);
+
+  const FLOAT3D avProbes[5] = {
+    vOrigin,
+    vOrigin + FLOAT3D(PROBE_STEP, 0, 0),
+    vOrigin + FLOAT3D(0, PROBE_STEP, 0),
+    vOrigin + FLOAT3D(0, 0, PROBE_STEP),
+    vOrigin + FLOAT3D(5.0f, -3.0f, 2.0f), // For verification
+  };
+
+  FLOAT3D avScreen[5];
+  bBulkProjection = FALSE;
+
+  for (INDEX iProbe = 0; iProbe < 5; iProbe++) {
+    pr.ProjectCoordinate(avProbes[iProbe], avScreen[iProbe]);
+
+    // Too close to the view plane to be reliable
+    if (Abs(avScreen[iProbe](3)) < 0.5f) return;
+  }
+
+  for (INDEX iAxis = 0; iAxis < 3; iAxis++) {
+    const FLOAT3D &v0 = avScreen[0];
+    const FLOAT3D &v1 = avScreen[iAxis + 1];
+
+    afProjX[iAxis] = (v1(1) * v1(3) - v0(1) * v0(3)) / PROBE_STEP;
+    afProjY[iAxis] = (v1(2) * v1(3) - v0(2) * v0(3)) / PROBE_STEP;
+    afProjZ[iAxis] = (v1(3) - v0(3)) / PROBE_STEP;
+  }
+
+  afProjX[3] = avScreen[0](1) * avScreen[0](3);
+  afProjY[3] = avScreen[0](2) * avScreen[0](3);
+  afProjZ[3] = avScreen[0](3);
+
+  // Make sure the reconstructed projection matches the real one
+  const FLOAT3D vCheck = avProbes[4] - vOrigin;
+  const FLOAT fZ = afProjZ[0] * vCheck(1) + afProjZ[1] * vCheck(2) + afProjZ[2] * vCheck(3) + afProjZ[3];
+  const FLOAT fX = (afProjX[0] * vCheck(1) + afProjX[1] * vCheck(2) + afProjX[2] * vCheck(3) + afProjX[3]) / fZ;
+  const FLOAT fY = (afProjY[0] * vCheck(1) + afProjY[1] * vCheck(2) + afProjY[2] * vCheck(3) + afProjY[3]) / fZ;
+
+  const FLOAT3D &vExpected = avScreen[4];
+  bBulkProjection = (Abs(fX - vExpected(1)) < 0.5f && Abs(fY - vExpected(2)) < 0.5f
+                  && Abs(fZ - vExpected(3)) < 0.01f * Abs(vExpected(3)));
+};
+
+// Reset arrays for a certain amount of tags (padded for vector processing)
+void HudTagBatch::Resize(INDEX ct) {
+  ctTags = ct;
+  const INDEX ctPadded = (ct + 3) & ~3;
+
+  #define RESIZE_STREAM(_Stream) \
+    _Stream.PopAll(); \
+    if (ctPadded > 0) memset(_Stream.Push(ctPadded), 0, ctPadded * sizeof(_Stream[0]));
+
+  RESIZE_STREAM(afPosX);
+  RESIZE_STREAM(afPosY);
+  RESIZE_STREAM(afPosZ);
+  RESIZE_STREAM(afCenterX);
+  RESIZE_STREAM(afCenterY);
+  RESIZE_STREAM(afCenterZ);
+  RESIZE_STREAM(afTop);
+  RESIZE_STREAM(afHealth);
+
+  RESIZE_STREAM(afScreenX);
+  RESIZE_STREAM(afScreenY);
+  RESIZE_STREAM(afScreenZ);
+  RESIZE_STREAM(afDist);
+  RESIZE_STREAM(afMarkerSize);
+  RESIZE_STREAM(acolTag);
+  RESIZE_STREAM(aiMarkerAlpha);
+  RESIZE_STREAM(aiNameAlpha);
+
+  #undef RESIZE_STREAM
+};
+
+// Compute screen positions, distances, colors, alpha levels and marker sizes of all tags
+void PrepareTags_Scalar(HudTagBatch &tags, const HudTagView &view) {
+  for (INDEX i = 0; i < tags.ctTags; i++) {
+    const FLOAT3D vPos(tags.afPosX[i], tags.afPosY[i], tags.afPosZ[i]);
+    const FLOAT3D vCenter(tags.afCenterX[i], tags.afCenterY[i], tags.afCenterZ[i]);
+
+    // Calculate tag position on screen
+    FLOAT3D vTag;
+    view.pprProjection->ProjectCoordinate(vCenter + view.vUp * tags.afTop[i], vTag);
+
+    tags.afScreenX[i] = vTag(1);
+    tags.afScreenY[i] = vTag(2);
+    tags.afScreenZ[i] = vTag(3);
+
+    // Marker color based on health level (0..100 health = 0..2 ratio), from red to yellow to green
+    const FLOAT fHealthRatio = Clamp(tags.afHealth[i] * 0.02f, 0.0f, 2.0f);
+    const UBYTE ubR = UBYTE(Clamp(2.0f - fHealthRatio, 0.0f, 1.0f) * 255.0f);
+    const UBYTE ubG = UBYTE(ClampUp(fHealthRatio, 1.0f) * 255.0f);
+    tags.acolTag[i] = RGBToColor(ubR, ubG, 0);
+
+    // Alpha levels and marker size based on relative distance (0..32 meters)
+    const FLOAT fDist = (vPos - view.vViewer).Length();
+    const FLOAT fDistRatio = Clamp(fDist * 0.03125f, 0.0f, 1.0f);
+
+    tags.afDist[i] = fDist;
+    tags.aiMarkerAlpha[i] = 0xBF - INDEX(fDistRatio * 96.0f);
+    tags.aiNameAlpha[i] = 0xFF - INDEX(fDistRatio * 160.0f);
+    tags.afMarkerSize[i] = (6.0f - fDistRatio * 3.0f) * view.fScaling;
+  }
+};
+
+// Same as above but processes multiple tags at a time (falls back to scalar if unavailable)
+void PrepareTags_Vector(HudTagBatch &tags, const HudTagView &view) {
+#if AHUD_TAGS_SSE
+  if (!view.bBulkProjection) {
+    PrepareTags_Scalar(tags, view);
+    return;
+  }
+
+  #define SPLAT _mm_set1_ps
+
+  const __m128 vOrgX = SPLAT(view.vOrigin(1)), vOrgY = SPLAT(view.vOrigin(2)), vOrgZ = SPLAT(view.vOrigin(3));
+  const __m128 vUpX  = SPLAT(view.vUp(1)),     vUpY  = SPLAT(view.vUp(2)),     vUpZ  = SPLAT(view.vUp(3));
+  const __m128 vEyeX = SPLAT(view.vViewer(1)), vEyeY = SPLAT(view.vViewer(2)), vEyeZ = SPLAT(view.vViewer(3));
+
+  const __m128 vPX0 = SPLAT(view.afProjX[0]), vPX1 = SPLAT(view.afProjX[1]), vPX2 = SPLAT(view.afProjX[2]), vPX3 = SPLAT(view.afProjX[3]);
+  const __m128 vPY0 = SPLAT(view.afProjY[0]), vPY1 = SPLAT(view.afProjY[1]), vPY2 = SPLAT(view.afProjY[2]), vPY3 = SPLAT(view.afProjY[3]);
+  const __m128 vPZ0 = SPLAT(view.afProjZ[0]), vPZ1 = SPLAT(view.afProjZ[1]), vPZ2 = SPLAT(view.afProjZ[2]), vPZ3 = SPLAT(view.afProjZ[3]);
+
+  const __m128 v0 = _mm_setzero_ps();
+  const __m128 v1 = SPLAT(1.0f);
+  const __m128 v2 = SPLAT(2.0f);
+  const __m128 v3 = SPLAT(3.0f);
+  const __m128 v6 = SPLAT(6.0f);
+  const __m128 v255 = SPLAT(255.0f);
+  const __m128 vHealthMul = SPLAT(0.02f);
+  const __m128 vDistMul = SPLAT(0.03125f);
+  const __m128 vMarkerAlphaMul = SPLAT(96.0f);
+  const __m128 vNameAlphaMul = SPLAT(160.0f);
+  const __m128 vScaling = SPLAT(view.fScaling);
+
+  const __m128i viMarkerAlpha = _mm_set1_epi32(0xBF);
+  const __m128i viNameAlpha = _mm_set1_epi32(0xFF);
+
+  #undef SPLAT
+
+  for (INDEX i = 0; i < tags.ctTags; i += 4) {
+    // Tag position relative to the projection origin
+    const __m128 vTop = _mm_loadu_ps(&tags.afTop[i]);
+    const __m128 vX = _mm_add_ps(_mm_sub_ps(_mm_loadu_ps(&tags.afCenterX[i]), vOrgX), _mm_mul_ps(vUpX, vTop));
+    const __m128 vY = _mm_add_ps(_mm_sub_ps(_mm_loadu_ps(&tags.afCenterY[i]), vOrgY), _mm_mul_ps(vUpY, vTop));
+    const __m128 vZ = _mm_add_ps(_mm_sub_ps(_mm_loadu_ps(&tags.afCenterZ[i]), vOrgZ), _mm_mul_ps(vUpZ, vTop));
+
+    // Project onto the screen
+    const __m128 vDepth = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vPZ0, vX), _mm_mul_ps(vPZ1, vY)), _mm_add_ps(_mm_mul_ps(vPZ2, vZ), vPZ3));
+    const __m128 vScrX  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vPX0, vX), _mm_mul_ps(vPX1, vY)), _mm_add_ps(_mm_mul_ps(vPX2, vZ), vPX3));
+    const __m128 vScrY  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vPY0, vX), _mm_mul_ps(vPY1, vY)), _mm_add_ps(_mm_mul_ps(vPY2, vZ), vPY3));
+    const __m128 vInvDepth = _mm_div_ps(v1, vDepth);
+
+    _mm_storeu_ps(&tags.afScreenX[i], _mm_mul_ps(vScrX, vInvDepth));
+    _mm_storeu_ps(&tags.afScreenY[i], _mm_mul_ps(vScrY, vInvDepth));
+    _mm_storeu_ps(&tags.afScreenZ[i], vDepth);
+
+    // Marker color based on health level
+    const __m128 vHealth = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(&tags.afHealth[i]), vHealthMul), v0), v2);
+    const __m128i viR = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_sub_ps(v2, vHealth), v1), v255));
+    const __m128i viG = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(vHealth, v1), v255));
+    const __m128i viColor = _mm_or_si128(_mm_slli_epi32(viR, 24), _mm_slli_epi32(viG, 16));
+
+    _mm_storeu_si128((__m128i *)&tags.acolTag[i], viColor);
+
+    // Distance to the viewer
+    const __m128 vDX = _mm_sub_ps(_mm_loadu_ps(&tags.afPosX[i]), vEyeX);
+    const __m128 vDY = _mm_sub_ps(_mm_loadu_ps(&tags.afPosY[i]), vEyeY);
+    const __m128 vDZ = _mm_sub_ps(_mm_loadu_ps(&tags.afPosZ[i]), vEyeZ);
+    const __m128 vDist = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vDX, vDX), _mm_mul_ps(vDY, vDY)), _mm_mul_ps(vDZ, vDZ)));
+    const __m128 vDistRatio = _mm_min_ps(_mm_max_ps(_mm_mul_ps(vDist, vDistMul), v0), v1);
+
+    _mm_storeu_ps(&tags.afDist[i], vDist);
+
+    // Alpha levels and marker size based on relative distance
+    const __m128i viMarker = _mm_sub_epi32(viMarkerAlpha, _mm_cvttps_epi32(_mm_mul_ps(vDistRatio, vMarkerAlphaMul)));
+    const __m128i viName = _mm_sub_epi32(viNameAlpha, _mm_cvttps_epi32(_mm_mul_ps(vDistRatio, vNameAlphaMul)));
+
+    _mm_storeu_si128((__m128i *)&tags.aiMarkerAlpha[i], viMarker);
+    _mm_storeu_si128((__m128i *)&tags.aiNameAlpha[i], viName);
+    _mm_storeu_ps(&tags.afMarkerSize[i], _mm_mul_ps(_mm_sub_ps(v6, _mm_mul_ps(vDistRatio, v3)), vScaling));
+  }
+
+#else
+  PrepareTags_Scalar(tags, view);
+#endif
+};
+
+// Prepare radar setup for a viewer and a radar area on screen
+void HudRadarView::Setup(const CPlacement3D &plViewer, FLOAT fSetCenterX, FLOAT fSetCenterY, FLOAT fSetRadius, FLOAT fRange) {
+  fViewerX = plViewer.pl_PositionVector(1);
+  fViewerZ = plViewer.pl_PositionVector(3);
+
+  const ANGLE aHeading = plViewer.pl_OrientationAngle(1);
+  fSin = Sin(aHeading);
+  fCos = Cos(aHeading);
+
+  fCenterX = fSetCenterX;
+  fCenterY = fSetCenterY;
+  fRadius = fSetRadius;
+  fScale = fSetRadius / ClampDn(fRange, 1.0f);
+};
+
+// Reset arrays for a certain amount of blips (padded for vector processing)
+void HudBlipBatch::Resize(INDEX ct) {
+  ctBlips = ct;
+  const INDEX ctPadded = (ct + 3) & ~3;
+
+  #define RESIZE_STREAM(_Stream) \
+    _Stream.PopAll(); \
+    if (ctPadded > 0) memset(_Stream.Push(ctPadded), 0, ctPadded * sizeof(_Stream[0]));
+
+  RESIZE_STREAM(afPosX);
+  RESIZE_STREAM(afPosZ);
+  RESIZE_STREAM(afHealth);
+
+  RESIZE_STREAM(afBlipX);
+  RESIZE_STREAM(afBlipY);
+  RESIZE_STREAM(acolBlip);
+  RESIZE_STREAM(aiBlipAlpha);
+
+  #undef RESIZE_STREAM
+};
+
+// Compute screen positions, colors and alpha levels of all radar blips
+void PrepareBlips_Scalar(HudBlipBatch &blips, const HudRadarView &view) {
+  for (INDEX i = 0; i < blips.ctBlips; i++) {
+    const FLOAT fDX = blips.afPosX[i] - view.fViewerX;
+    const FLOAT fDZ = blips.afPosZ[i] - view.fViewerZ;
+
+    // Rotate into the viewer's space (right and forward)
+    FLOAT fRight = (fDX * view.fCos - fDZ * view.fSin) * view.fScale;
+    FLOAT fForward = (-fDX * view.fSin - fDZ * view.fCos) * view.fScale;
+
+    // Pin blips that are out of range to the edge
+    const FLOAT fLength = Sqrt(fRight * fRight + fForward * fForward);
+    const FLOAT fFit = ClampUp(view.fRadius / ClampDn(fLength, 0.001f), 1.0f);
+
+    blips.afBlipX[i] = view.fCenterX + fRight * fFit;
+    blips.afBlipY[i] = view.fCenterY - fForward * fFit;
+    blips.aiBlipAlpha[i] = (fFit < 1.0f) ? 0x7F : 0xFF;
+
+    // Blip color based on health level, same as player tags
+    const FLOAT fHealthRatio = Clamp(blips.afHealth[i] * 0.02f, 0.0f, 2.0f);
+    const UBYTE ubR = UBYTE(Clamp(2.0f - fHealthRatio, 0.0f, 1.0f) * 255.0f);
+    const UBYTE ubG = UBYTE(ClampUp(fHealthRatio, 1.0f) * 255.0f);
+    blips.acolBlip[i] = RGBToColor(ubR, ubG, 0);
+  }
+};
+
+// Same as above but processes multiple blips at a time (falls back to scalar if unavailable)
+void PrepareBlips_Vector(HudBlipBatch &blips, const HudRadarView &view) {
+#if AHUD_TAGS_SSE
+  #define SPLAT _mm_set1_ps
+
+  const __m128 vEyeX = SPLAT(view.fViewerX), vEyeZ = SPLAT(view.fViewerZ);
+  const __m128 vSin = SPLAT(view.fSin), vCos = SPLAT(view.fCos);
+  const __m128 vCenterX = SPLAT(view.fCenterX), vCenterY = SPLAT(view.fCenterY);
+  const __m128 vRadius = SPLAT(view.fRadius);
+  const __m128 vScale = SPLAT(view.fScale);
+
+  const __m128 v0 = _mm_setzero_ps();
+  const __m128 v1 = SPLAT(1.0f);
+  const __m128 v2 = SPLAT(2.0f);
+  const __m128 v255 = SPLAT(255.0f);
+  const __m128 vMinLength = SPLAT(0.001f);
+  const __m128 vHealthMul = SPLAT(0.02f);
+
+  const __m128i viInRange = _mm_set1_epi32(0xFF);
+  const __m128i viOutOfRange = _mm_set1_epi32(0x7F);
+
+  #undef SPLAT
+
+  for (INDEX i = 0; i < blips.ctBlips; i += 4) {
+    const __m128 vDX = _mm_sub_ps(_mm_loadu_ps(&blips.afPosX[i]), vEyeX);
+    const __m128 vDZ = _mm_sub_ps(_mm_loadu_ps(&blips.afPosZ[i]), vEyeZ);
+
+    // Rotate into the viewer's space (right and forward)
+    const __m128 vRight = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(vDX, vCos), _mm_mul_ps(vDZ, vSin)), vScale);
+    const __m128 vForward = _mm_mul_ps(_mm_sub_ps(v0, _mm_add_ps(_mm_mul_ps(vDX, vSin), _mm_mul_ps(vDZ, vCos))), vScale);
+
+    // Pin blips that are out of range to the edge
+    const __m128 vLength = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vRight, vRight), _mm_mul_ps(vForward, vForward)));
+    const __m128 vFit = _mm_min_ps(_mm_div_ps(vRadius, _mm_max_ps(vLength, vMinLength)), v1);
+
+    _mm_storeu_ps(&blips.afBlipX[i], _mm_add_ps(vCenterX, _mm_mul_ps(vRight, vFit)));
+    _mm_storeu_ps(&blips.afBlipY[i], _mm_sub_ps(vCenterY, _mm_mul_ps(vForward, vFit)));
+
+    const __m128i viPinned = _mm_castps_si128(_mm_cmplt_ps(vFit, v1));
+    const __m128i viAlpha = _mm_or_si128(_mm_and_si128(viPinned, viOutOfRange), _mm_andnot_si128(viPinned, viInRange));
+    _mm_storeu_si128((__m128i *)&blips.aiBlipAlpha[i], viAlpha);
+
+    // Blip color based on health level
+    const __m128 vHealth = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(&blips.afHealth[i]), vHealthMul), v0), v2);
+    const __m128i viR = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_sub_ps(v2, vHealth), v1), v255));
+    const __m128i viG = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(vHealth, v1), v255));
+
+    _mm_storeu_si128((__m128i *)&blips.acolBlip[i], _mm_or_si128(_mm_slli_epi32(viR, 24), _mm_slli_epi32(viG, 16)));
+  }
+
+#else
+  PrepareBlips_Scalar(blips, view);
+#endif
+};
+
+// Measure tag preparation for synthetic players
+void BenchmarkTags(void) {
+  // Viewer in the center of the world looking forward
+  const CPlacement3D plViewer(FLOAT3D(0, 0, 0), ANGLE3D(0, 0, 0));
+
+  CPerspectiveProjection3D pr;
+  pr.FOVL() = AngleDeg(90.0f);
+  pr.ScreenBBoxL() = FLOATaabbox2D(FLOAT2D(0.0f, 0.0f), FLOAT2D(640.0f, 480.0f));
+  pr.AspectRatioL() = 1.0f;
+  pr.FrontClipDistanceL() = 0.3f;
+  pr.ViewerPlacementL() = plViewer;
+  pr.ObjectPlacementL() = CPlacement3D(FLOAT3D(0, 0, 0), ANGLE3D(0, 0, 0));
+  pr.Prepare();
+
+  HudTagView view;
+  view.Setup(pr, plViewer, 1.0f);
+
+  CPrintF(TRANS("Player tag preparation (%s):\n"), (view.bBulkProjection && AHUD_TAGS_SSE) ? "SSE" : TRANS("scalar fallback"));
+
+  static const INDEX actPlayers[] = { 64, 256 };
+  const INDEX ctIterations = 1000;
+
+  HudTagBatch tags;
+  CStaticStackArray<FLOAT> afExpectedX;
+
+  for (INDEX iTest = 0; iTest < ARRAYCOUNT(actPlayers); iTest++) {
+    const INDEX ctPlayers = actPlayers[iTest];
+    tags.Resize(ctPlayers);
+
+    // Spread players in front of the viewer
+    for (INDEX i = 0; i < ctPlayers; i++) {
+      const FLOAT3D vPos(FLOAT(i % 16) * 4.0f - 32.0f, FLOAT(i / 16 % 4) * 2.0f, -8.0f - FLOAT(i / 64) * 16.0f - FLOAT(i % 7));
+      tags.Set(i, vPos, vPos + FLOAT3D(0, 1, 0), 1.0f, FLOAT(i % 250));
+    }
+
+    CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+
+    for (INDEX iScalar = 0; iScalar < ctIterations; iScalar++) {
+      PrepareTags_Scalar(tags, view);
+    }
+
+    const DOUBLE dScalar = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds();
+
+    // Remember results of the reference path
+    afExpectedX.PopAll();
+    memcpy(afExpectedX.Push(ctPlayers), &tags.afScreenX[0], ctPlayers * sizeof(FLOAT));
+
+    tvStart = _pTimer->GetHighPrecisionTimer();
+
+    for (INDEX iVector = 0; iVector < ctIterations; iVector++) {
+      PrepareTags_Vector(tags, view);
+    }
+
+    const DOUBLE dVector = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds();
+
+    // Compare both paths
+    FLOAT fMaxDiff = 0.0f;
+
+    for (INDEX iCheck = 0; iCheck < ctPlayers; iCheck++) {
+      fMaxDiff = Max(fMaxDiff, Abs(tags.afScreenX[iCheck] - afExpectedX[iCheck]));
+    }
+
+    CPrintF(TRANS("  %3d players: scalar %7.2f us, vector %7.2f us (x%.2f), max deviation %.3f px\n"), ctPlayers,
+      dScalar / ctIterations * 1000000.0, dVector / ctIterations * 1000000.0, dScalar / ClampDn(dVector, 1e-9), fMaxDiff);
+  }
+};
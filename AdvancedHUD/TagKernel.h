@@ -0,0 +1,137 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#ifndef CECIL_INCL_TAGKERNEL_H
+#define CECIL_INCL_TAGKERNEL_H
+
+#ifdef PRAGMA_ONCE
+  #pragma once
+#endif
+
+// Process four tags at a time using SSE
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE__)
+  #define AHUD_TAGS_SSE 1
+#else
+  #define AHUD_TAGS_SSE 0
+#endif
+
+// Viewer setup shared by all tags in a batch
+struct HudTagView {
+  CPerspectiveProjection3D *pprProjection; // Projection for the scalar path
+  FLOAT3D vViewer; // Player position for distances
+  FLOAT3D vUp; // Tag offset direction relative to the player's rotation
+  FLOAT fScaling; // Marker size scaling
+
+  // Projection in the form of (X / Z, Y / Z, Z), where each value is (A * (vPoint - vOrigin) + B)
+  FLOAT3D vOrigin;
+  FLOAT afProjX[4];
+  FLOAT afProjY[4];
+  FLOAT afProjZ[4];
+  BOOL bBulkProjection; // Projection has been converted into a bulk form
+
+  // Prepare viewer setup for a prepared projection and the player that's viewing it
+  void Setup(CPerspectiveProjection3D &pr, const CPlacement3D &plViewer, FLOAT fSetScaling);
+};
+
+// Tag data for all players in a structure-of-arrays layout
+struct HudTagBatch {
+  INDEX ctTags;
+
+  // Input
+  CStaticStackArray<FLOAT> afPosX, afPosY, afPosZ; // Player positions
+  CStaticStackArray<FLOAT> afCenterX, afCenterY, afCenterZ; // Bounding box centers
+  CStaticStackArray<FLOAT> afTop; // Tag height above the center
+  CStaticStackArray<FLOAT> afHealth;
+
+  // Output
+  CStaticStackArray<FLOAT> afScreenX, afScreenY, afScreenZ;
+  CStaticStackArray<FLOAT> afDist;
+  CStaticStackArray<FLOAT> afMarkerSize;
+  CStaticStackArray<COLOR> acolTag; // Marker color without alpha
+  CStaticStackArray<INDEX> aiMarkerAlpha;
+  CStaticStackArray<INDEX> aiNameAlpha;
+
+  HudTagBatch() : ctTags(0) {};
+
+  // Reset arrays for a certain amount of tags (padded for vector processing)
+  void Resize(INDEX ct);
+
+  // Set input values for one tag
+  inline void Set(INDEX i, const FLOAT3D &vPos, const FLOAT3D &vCenter, FLOAT fTop, FLOAT fHealth) {
+    afPosX[i] = vPos(1);
+    afPosY[i] = vPos(2);
+    afPosZ[i] = vPos(3);
+    afCenterX[i] = vCenter(1);
+    afCenterY[i] = vCenter(2);
+    afCenterZ[i] = vCenter(3);
+    afTop[i] = fTop;
+    afHealth[i] = fHealth;
+  };
+};
+
+// Radar setup shared by all blips in a batch
+struct HudRadarView {
+  FLOAT fViewerX, fViewerZ; // Viewer position on the horizontal plane
+  FLOAT fSin, fCos; // Viewer heading
+  FLOAT fCenterX, fCenterY; // Radar center on screen
+  FLOAT fRadius; // Radar radius in pixels
+  FLOAT fScale; // Pixels per meter
+
+  // Prepare radar setup for a viewer and a radar area on screen
+  void Setup(const CPlacement3D &plViewer, FLOAT fSetCenterX, FLOAT fSetCenterY, FLOAT fSetRadius, FLOAT fRange);
+};
+
+// Radar blips in a structure-of-arrays layout
+struct HudBlipBatch {
+  INDEX ctBlips;
+
+  // Input
+  CStaticStackArray<FLOAT> afPosX, afPosZ; // Positions on the horizontal plane
+  CStaticStackArray<FLOAT> afHealth;
+
+  // Output
+  CStaticStackArray<FLOAT> afBlipX, afBlipY; // Blip positions on screen
+  CStaticStackArray<COLOR> acolBlip; // Blip color without alpha
+  CStaticStackArray<INDEX> aiBlipAlpha; // Lower for blips that are out of range
+
+  HudBlipBatch() : ctBlips(0) {};
+
+  // Reset arrays for a certain amount of blips (padded for vector processing)
+  void Resize(INDEX ct);
+
+  // Set input values for one blip
+  inline void Set(INDEX i, const FLOAT3D &vPos, FLOAT fHealth) {
+    afPosX[i] = vPos(1);
+    afPosZ[i] = vPos(3);
+    afHealth[i] = fHealth;
+  };
+};
+
+// Compute screen positions, distances, colors, alpha levels and marker sizes of all tags
+void PrepareTags_Scalar(HudTagBatch &tags, const HudTagView &view);
+
+// Same as above but processes multiple tags at a time (falls back to scalar if unavailable)
+void PrepareTags_Vector(HudTagBatch &tags, const HudTagView &view);
+
+// Compute screen positions, colors and alpha levels of all radar blips
+void PrepareBlips_Scalar(HudBlipBatch &blips, const HudRadarView &view);
+
+// Same as above but processes multiple blips at a time (falls back to scalar if unavailable)
+void PrepareBlips_Vector(HudBlipBatch &blips, const HudRadarView &view);
+
+// Measure tag preparation for synthetic players
+void BenchmarkTags(void);
+
+#endif
@@ -0,0 +1,234 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "TextBatch.h"
+#include "FontMetrics.h"
+#include "DrawHash.h"
+
+// Parse up to a certain amount of hexadecimal digits and return how many have been read
+static ULONG ParseHex(const char *str, INDEX ctMaxDigits, INDEX &ctParsed) {
+  ULONG ulValue = 0;
+  ctParsed = 0;
+
+  while (ctParsed < ctMaxDigits) {
+    const char ch = str[ctParsed];
+    ULONG ulDigit;
+
+    if (ch >= '0' && ch <= '9') {
+      ulDigit = ch - '0';
+    } else if (ch >= 'a' && ch <= 'f') {
+      ulDigit = ch - 'a' + 10;
+    } else if (ch >= 'A' && ch <= 'F') {
+      ulDigit = ch - 'A' + 10;
+    } else {
+      break;
+    }
+
+    ulValue = (ulValue << 4) | ulDigit;
+    ctParsed++;
+  }
+
+  return ulValue;
+};
+
+// Check if the text uses features that only the drawport can reproduce
+static BOOL NeedsDrawPort(const CTString &strText, INDEX iTextMode) {
+  const char *str = strText.str_String;
+
+  for (INDEX i = 0; str[i] != '\0'; i++) {
+    // Multiple lines
+    if (str[i] == '\n') return TRUE;
+
+    // Italic and blinking text
+    if (iTextMode != -1 && str[i] == '^') {
+      const char chCode = str[i + 1];
+      if (chCode == 'i' || chCode == 'f') return TRUE;
+
+      // Skip escaped character
+      if (chCode != '\0') i++;
+    }
+  }
+
+  return FALSE;
+};
+
+// Start a new batch using current text settings of a drawport
+void CHudTextBatch::Begin(CDrawPort *pdp) {
+  ASSERT(tb_aGlyphs.Count() == 0 && tb_aDeferred.Count() == 0);
+
+  tb_pfd = pdp->dp_FontData;
+  tb_fScalingX = pdp->dp_fTextScaling * pdp->dp_fTextAspect;
+  tb_fScalingY = pdp->dp_fTextScaling;
+  tb_pixCharSpacing = pdp->dp_pixTextCharSpacing;
+  tb_iTextMode = pdp->dp_iTextMode;
+  tb_padv = &GetGlyphAdvances(pdp);
+
+  // Switch font texture
+  if (tb_toFont.GetData() != tb_pfd->fd_ptdTextureData) {
+    tb_toFont.SetData(tb_pfd->fd_ptdTextureData);
+  }
+};
+
+// Calculate width of a text line the same way the drawport does
+PIX CHudTextBatch::GetTextWidth(const CTString &strText) const {
+  ASSERT(tb_padv != NULL);
+  return GetCachedTextWidth(*tb_padv, strText, tb_iTextMode);
+};
+
+// Lay out glyphs of a text line
+void CHudTextBatch::AddText(const CTString &strText, FLOAT fX, FLOAT fY, COLOR col, EAlign eAlign) {
+  ASSERT(tb_pfd != NULL);
+
+  // Align the same way as the drawport
+  PIX pixX = fX;
+  const PIX pixY = fY;
+
+  if (eAlign == E_TA_RIGHT) {
+    pixX -= GetTextWidth(strText);
+  } else if (eAlign == E_TA_CENTER) {
+    pixX -= GetTextWidth(strText) / 2;
+  }
+
+  // Hash the same way as text printed by the drawport
+  HashDrawText(tb_pfd, tb_fScalingY, strText, pixX, pixY, col);
+
+  // Let the drawport print it after the batch
+  if (NeedsDrawPort(strText, tb_iTextMode)) {
+    Deferred &def = tb_aDeferred.Push();
+    def.strText = strText;
+    def.pixX = pixX;
+    def.pixY = pixY;
+    def.col = col;
+    return;
+  }
+
+  CTextureData *ptd = (CTextureData *)tb_toFont.GetData();
+  const FLOAT fCorrU = 1.0f / (FLOAT)ptd->GetPixWidth();
+  const FLOAT fCorrV = 1.0f / (FLOAT)ptd->GetPixHeight();
+
+  const SLONG fixScalingX = FloatToInt(tb_fScalingX * 65536.0f);
+  const PIX pixCharH = tb_pfd->fd_pixCharHeight;
+  const FLOAT fCharH = pixCharH * tb_fScalingY;
+
+  const UBYTE ubDefaultAlpha = (col & CT_AMASK);
+  COLOR colCurrent = col;
+  BOOL bBold = FALSE;
+
+  PIX pixCharStart = 0;
+  PIX pixCharEnd = tb_pfd->fd_pixCharWidth;
+
+  const char *str = strText.str_String;
+
+  for (INDEX i = 0; str[i] != '\0'; i++) {
+    UBYTE ch = str[i];
+
+    // Apply special codes
+    if (ch == '^' && tb_iTextMode != -1) {
+      const BOOL bApply = (tb_iTextMode == 1);
+      INDEX ctParsed;
+      ch = str[++i];
+
+      switch (ch) {
+        case 'c': {
+          const ULONG ulRGB = ParseHex(str + i + 1, 6, ctParsed);
+          i += ctParsed;
+
+          if (bApply) colCurrent = (ulRGB << 8) | (colCurrent & CT_AMASK);
+        } continue;
+
+        case 'a': {
+          const ULONG ulAlpha = ParseHex(str + i + 1, 2, ctParsed);
+          i += ctParsed;
+
+          if (bApply) colCurrent = (colCurrent & ~CT_AMASK) | ((ulAlpha * ubDefaultAlpha) / 255);
+        } continue;
+
+        case 'b': if (bApply) { bBold = TRUE; } continue;
+        case 'B': bBold = FALSE; continue;
+
+        case 'r': colCurrent = col; bBold = FALSE; continue;
+        case 'C': colCurrent = (col & ~CT_AMASK) | (colCurrent & CT_AMASK); continue;
+        case 'A': colCurrent = (colCurrent & ~CT_AMASK) | ubDefaultAlpha; continue;
+
+        case 'o': case 'F': case 'I':
+          continue;
+
+        case '\0': i--; continue;
+      }
+
+    } else if (ch == '\t') {
+      continue;
+    }
+
+    const CFontCharData &fcd = tb_pfd->fd_fcdFontCharData[ch];
+
+    // Proportional font
+    if (!tb_pfd->fd_bFixedWidth) {
+      pixCharStart = fcd.fcd_pixStart;
+      pixCharEnd   = fcd.fcd_pixEnd;
+    }
+
+    const PIX pixCharW = pixCharEnd - pixCharStart;
+
+    Glyph &gl = tb_aGlyphs.Push();
+    gl.fI0 = pixX;
+    gl.fJ0 = pixY;
+    gl.fI1 = pixX + pixCharW * tb_fScalingX;
+    gl.fJ1 = pixY + fCharH;
+    gl.fU0 = (fcd.fcd_pixXOffset + pixCharStart) * fCorrU;
+    gl.fV0 = (fcd.fcd_pixYOffset) * fCorrV;
+    gl.fU1 = (fcd.fcd_pixXOffset + pixCharEnd) * fCorrU;
+    gl.fV1 = (fcd.fcd_pixYOffset + pixCharH) * fCorrV;
+    gl.col = colCurrent;
+
+    // Bold characters are drawn twice with a one pixel shift
+    if (bBold) {
+      Glyph &glBold = tb_aGlyphs.Push();
+      glBold = tb_aGlyphs[tb_aGlyphs.Count() - 2];
+      glBold.fI0 += 1.0f;
+      glBold.fI1 += 1.0f;
+    }
+
+    pixX += ((pixCharW * fixScalingX) >> 16) + tb_pixCharSpacing;
+  }
+};
+
+// Render all collected text and clear the batch
+void CHudTextBatch::Flush(CDrawPort *pdp) {
+  // Submit all glyphs at once
+  const INDEX ctGlyphs = tb_aGlyphs.Count();
+
+  if (ctGlyphs > 0) {
+    pdp->InitTexture(&tb_toFont);
+
+    for (INDEX i = 0; i < ctGlyphs; i++) {
+      const Glyph &gl = tb_aGlyphs[i];
+      pdp->AddTexture(gl.fI0, gl.fJ0, gl.fI1, gl.fJ1, gl.fU0, gl.fV0, gl.fU1, gl.fV1, gl.col);
+    }
+
+    pdp->FlushRenderingQueue();
+    tb_aGlyphs.PopAll();
+  }
+
+  // Print the rest of the text with the same font
+  for (INDEX i = 0; i < tb_aDeferred.Count(); i++) {
+    const Deferred &def = tb_aDeferred[i];
+    pdp->PutText(def.strText, def.pixX, def.pixY, def.col);
+  }
+
+  tb_aDeferred.PopAll();
+};
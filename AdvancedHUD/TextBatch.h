@@ -0,0 +1,86 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#ifndef CECIL_INCL_TEXTBATCH_H
+#define CECIL_INCL_TEXTBATCH_H
+
+#ifdef PRAGMA_ONCE
+  #pragma once
+#endif
+
+struct HudGlyphAdvances;
+
+// Collects glyphs of many strings in one font and submits them in one go
+class CHudTextBatch {
+  public:
+    // Text alignment relative to the position
+    enum EAlign {
+      E_TA_LEFT   = 0,
+      E_TA_CENTER = 1,
+      E_TA_RIGHT  = 2,
+    };
+
+    // One character quad
+    struct Glyph {
+      FLOAT fI0, fJ0, fI1, fJ1;
+      FLOAT fU0, fV0, fU1, fV1;
+      COLOR col;
+    };
+
+    // String that can't be laid out by the batch and has to be printed by the drawport
+    struct Deferred {
+      CTString strText;
+      PIX pixX;
+      PIX pixY;
+      COLOR col;
+    };
+
+  private:
+    CFontData *tb_pfd; // Font of the current batch
+    const HudGlyphAdvances *tb_padv; // Character advances for the current font and scaling
+    CTextureObject tb_toFont; // Font texture
+    FLOAT tb_fScalingX; // Horizontal glyph scaling (with aspect ratio)
+    FLOAT tb_fScalingY; // Vertical glyph scaling
+    PIX tb_pixCharSpacing; // Space between characters
+    INDEX tb_iTextMode; // Special code handling mode
+
+    CStaticStackArray<Glyph> tb_aGlyphs;
+    CStaticStackArray<Deferred> tb_aDeferred;
+
+  public:
+    CHudTextBatch() : tb_pfd(NULL), tb_padv(NULL), tb_fScalingX(1.0f), tb_fScalingY(1.0f),
+      tb_pixCharSpacing(0), tb_iTextMode(1)
+    {
+    };
+
+    // Start a new batch using current text settings of a drawport
+    void Begin(CDrawPort *pdp);
+
+    // Calculate width of a text line the same way the drawport does
+    PIX GetTextWidth(const CTString &strText) const;
+
+    // Lay out glyphs of a text line
+    void AddText(const CTString &strText, FLOAT fX, FLOAT fY, COLOR col, EAlign eAlign = E_TA_LEFT);
+
+    // Render all collected text and clear the batch
+    void Flush(CDrawPort *pdp);
+
+    // Amount of collected glyphs
+    inline INDEX Count(void) const {
+      return tb_aGlyphs.Count();
+    };
+};
+
+#endif
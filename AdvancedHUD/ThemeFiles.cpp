@@ -0,0 +1,294 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "HUD.h"
+
+// Compiled theme format
+#define THEME_BLOB_ID 0x43544841 // "AHTC"
+static const INDEX _iThemeBlobVersion = 1;
+
+// Property names in theme definitions (in order of values in HudColorSet)
+static const char *_astrColorNames[] = {
+  "Base", "Icon", "Names", "AmmoSelected", "AmmoDepleted",
+  "ValueOverTop", "ValueTop", "ValueMid", "ValueLow",
+  "ScopeMask", "ScopeDetails", "ScopeLedIdle", "ScopeLedFire",
+  "WeaponBorder", "WeaponIcon", "WeaponNoAmmo", "WeaponWanted",
+};
+
+static const char *_astrUnitNames[E_HTU_MAX] = { "One", "Advance", "Next" };
+static const char *_astrFontNames[E_HTF_MAX] = { "Text", "Numbers" };
+
+#define CT_THEME_COLORS INDEX(sizeof(HudColorSet) / sizeof(COLOR))
+
+// Find name in a list
+static INDEX FindName(const char **astrNames, INDEX ctNames, const CTString &strName) {
+  for (INDEX i = 0; i < ctNames; i++) {
+    if (strName == astrNames[i]) return i;
+  }
+
+  return -1;
+};
+
+// Read an entire file at once
+static void ReadWholeFile_t(const CTFileName &fnm, CStaticArray<UBYTE> &aData) {
+  CTFileStream strm;
+  strm.Open_t(fnm);
+
+  const SLONG slSize = strm.GetStreamSize();
+  aData.Clear();
+  if (slSize <= 0) return;
+
+  aData.New(slSize);
+  strm.Read_t(&aData[0], slSize);
+};
+
+// Add string to the table of a theme that's being compiled and return its offset
+static INDEX AddString(CStaticStackArray<char> &achStrings, const CTString &str) {
+  const INDEX iOffset = achStrings.Count();
+  const INDEX ctChars = str.Length() + 1;
+
+  char *pch = achStrings.Push(ctChars);
+  memcpy(pch, str.str_String, ctChars);
+
+  return iOffset;
+};
+
+// Compile theme definition into a blob
+static void CompileTheme_t(const CStaticArray<UBYTE> &aSource, ULONG ulCRC, CStaticStackArray<UBYTE> &aBlob) {
+  HudThemeBlob hdr;
+  memset(&hdr, 0, sizeof(hdr));
+
+  hdr.ulID = THEME_BLOB_ID;
+  hdr.iVersion = _iThemeBlobVersion;
+  hdr.ulSourceCRC = ulCRC;
+  hdr.slSourceSize = aSource.Count();
+  hdr.iTheme = -1;
+  hdr.iIconDir = -1;
+
+  for (INDEX iFont = 0; iFont < E_HTF_MAX; iFont++) {
+    hdr.aiFonts[iFont] = -1;
+  }
+
+  CStaticStackArray<INDEX> aiIcons;
+  CStaticStackArray<char> achStrings;
+
+  // Go through each line
+  const INDEX ctSource = aSource.Count();
+  INDEX iChar = 0;
+  INDEX iLine = 0;
+
+  while (iChar < ctSource) {
+    CTString strLine = "";
+    iLine++;
+
+    while (iChar < ctSource && aSource[iChar] != '\n') {
+      const char ch = aSource[iChar++];
+      if (ch != '\r') strLine.InsertChar(strLine.Length(), ch);
+    }
+
+    iChar++;
+
+    // Split into a property, its name and a value
+    CTString astrTokens[3];
+    INDEX ctTokens = 0;
+
+    const char *pch = strLine.str_String;
+
+    while (*pch != '\0' && ctTokens < 3) {
+      while (*pch == ' ' || *pch == '\t') pch++;
+      if (*pch == '\0') break;
+
+      // Comment
+      if (pch[0] == '/' && pch[1] == '/') break;
+
+      CTString &strToken = astrTokens[ctTokens++];
+
+      while (*pch != '\0' && *pch != ' ' && *pch != '\t') {
+        strToken.InsertChar(strToken.Length(), *pch++);
+      }
+    }
+
+    if (ctTokens == 0) continue;
+
+    const CTString &strKey = astrTokens[0];
+
+    if (strKey == "Theme" && ctTokens == 2) {
+      hdr.iTheme = FindName(_astrThemeNames, E_HUD_MAX, astrTokens[1]);
+      if (hdr.iTheme == -1) ThrowF_t(TRANS("line %d: unknown theme '%s'"), iLine, astrTokens[1].str_String);
+
+    } else if (strKey == "Color" && ctTokens == 3) {
+      const INDEX iColor = FindName(_astrColorNames, CT_THEME_COLORS, astrTokens[1]);
+      if (iColor == -1) ThrowF_t(TRANS("line %d: unknown color '%s'"), iLine, astrTokens[1].str_String);
+
+      ((COLOR *)&hdr.colors)[iColor] = strtoul(astrTokens[2].str_String, NULL, 16);
+      hdr.ulColors |= (1UL << iColor);
+
+    } else if (strKey == "Unit" && ctTokens == 3) {
+      const INDEX iUnit = FindName(_astrUnitNames, E_HTU_MAX, astrTokens[1]);
+      if (iUnit == -1) ThrowF_t(TRANS("line %d: unknown unit '%s'"), iLine, astrTokens[1].str_String);
+
+      hdr.afUnits[iUnit] = (FLOAT)atof(astrTokens[2].str_String);
+      hdr.ulUnits |= (1UL << iUnit);
+
+    } else if (strKey == "Font" && ctTokens == 3) {
+      const INDEX iFont = FindName(_astrFontNames, E_HTF_MAX, astrTokens[1]);
+      if (iFont == -1) ThrowF_t(TRANS("line %d: unknown font '%s'"), iLine, astrTokens[1].str_String);
+
+      hdr.aiFonts[iFont] = AddString(achStrings, astrTokens[2]);
+
+    } else if (strKey == "Directory" && ctTokens == 2) {
+      hdr.iIconDir = AddString(achStrings, astrTokens[1]);
+
+    } else if (strKey == "Icon" && ctTokens == 3) {
+      aiIcons.Push() = AddString(achStrings, astrTokens[1]);
+      aiIcons.Push() = AddString(achStrings, astrTokens[2]);
+
+    } else {
+      ThrowF_t(TRANS("line %d: invalid property '%s'"), iLine, strKey.str_String);
+    }
+  }
+
+  if (hdr.iTheme == -1) ThrowF_t(TRANS("theme that's being changed isn't specified"));
+
+  hdr.ctIcons = aiIcons.Count() / 2;
+  hdr.slStrings = achStrings.Count();
+
+  // Put everything together
+  const SLONG slIcons = aiIcons.Count() * sizeof(INDEX);
+
+  aBlob.PopAll();
+  UBYTE *pub = aBlob.Push(sizeof(hdr) + slIcons + hdr.slStrings);
+
+  memcpy(pub, &hdr, sizeof(hdr));
+  if (slIcons > 0) memcpy(pub + sizeof(hdr), &aiIcons[0], slIcons);
+  if (hdr.slStrings > 0) memcpy(pub + sizeof(hdr) + slIcons, &achStrings[0], hdr.slStrings);
+};
+
+// Check if the compiled theme is complete and made from the current definition
+static BOOL IsThemeBlobValid(const UBYTE *pub, SLONG slSize, ULONG ulCRC, SLONG slSourceSize) {
+  if (slSize < (SLONG)sizeof(HudThemeBlob)) return FALSE;
+
+  const HudThemeBlob &hdr = *(const HudThemeBlob *)pub;
+
+  if (hdr.ulID != THEME_BLOB_ID || hdr.iVersion != _iThemeBlobVersion) return FALSE;
+  if (hdr.ulSourceCRC != ulCRC || hdr.slSourceSize != slSourceSize) return FALSE;
+  if (hdr.iTheme < 0 || hdr.iTheme >= E_HUD_MAX || hdr.ctIcons < 0 || hdr.slStrings < 0) return FALSE;
+
+  if (slSize != SLONG(sizeof(HudThemeBlob) + hdr.ctIcons * 2 * sizeof(INDEX) + hdr.slStrings)) return FALSE;
+
+  // Every string must end within the table
+  if (hdr.slStrings > 0 && pub[slSize - 1] != '\0') return FALSE;
+
+  return TRUE;
+};
+
+// Apply compiled theme in place
+static void ApplyThemeBlob(const UBYTE *pub) {
+  const HudThemeBlob &hdr = *(const HudThemeBlob *)pub;
+  const INDEX *aiIcons = (const INDEX *)(pub + sizeof(HudThemeBlob));
+  const char *strTable = (const char *)(aiIcons + hdr.ctIcons * 2);
+
+  #define BLOB_STRING(_Offset) ((_Offset) >= 0 && (_Offset) < hdr.slStrings ? strTable + (_Offset) : "")
+
+  HudThemeData &thd = _athdThemes[hdr.iTheme];
+
+  for (INDEX iColor = 0; iColor < CT_THEME_COLORS; iColor++) {
+    if (hdr.ulColors & (1UL << iColor)) {
+      ((COLOR *)&thd.colors)[iColor] = ((const COLOR *)&hdr.colors)[iColor];
+    }
+  }
+
+  for (INDEX iUnit = 0; iUnit < E_HTU_MAX; iUnit++) {
+    if (hdr.ulUnits & (1UL << iUnit)) {
+      thd.afUnits[iUnit] = hdr.afUnits[iUnit];
+    }
+  }
+
+  for (INDEX iFont = 0; iFont < E_HTF_MAX; iFont++) {
+    if (hdr.aiFonts[iFont] != -1) {
+      thd.afnmFonts[iFont] = CTString(BLOB_STRING(hdr.aiFonts[iFont]));
+    }
+  }
+
+  if (hdr.iIconDir != -1) {
+    thd.strIconDir = BLOB_STRING(hdr.iIconDir);
+  }
+
+  for (INDEX iIcon = 0; iIcon < hdr.ctIcons; iIcon++) {
+    thd.astrIconNames.Push() = BLOB_STRING(aiIcons[iIcon * 2 + 0]);
+    thd.astrIconPaths.Push() = BLOB_STRING(aiIcons[iIcon * 2 + 1]);
+  }
+
+  #undef BLOB_STRING
+};
+
+// Apply one theme file and compile it again if it has changed
+static void LoadThemeFile(const CTFileName &fnmSource) {
+  const CTFileName fnmBlob = fnmSource.NoExt() + ".ahtc";
+
+  try {
+    CStaticArray<UBYTE> aSource;
+    ReadWholeFile_t(fnmSource, aSource);
+
+    const SLONG slSourceSize = aSource.Count();
+    ULONG ulCRC;
+    CRC_Start(ulCRC);
+    if (slSourceSize > 0) CRC_AddBlock(ulCRC, &aSource[0], slSourceSize);
+    CRC_Finish(ulCRC);
+
+    // Use compiled theme as is
+    if (FileExists(fnmBlob)) {
+      CStaticArray<UBYTE> aCompiled;
+      ReadWholeFile_t(fnmBlob, aCompiled);
+
+      if (aCompiled.Count() > 0 && IsThemeBlobValid(&aCompiled[0], aCompiled.Count(), ulCRC, slSourceSize)) {
+        ApplyThemeBlob(&aCompiled[0]);
+        return;
+      }
+    }
+
+    // Compile it again
+    CStaticStackArray<UBYTE> aBlob;
+    CompileTheme_t(aSource, ulCRC, aBlob);
+    ApplyThemeBlob(&aBlob[0]);
+
+    // Cache it for the next time
+    try {
+      CTFileStream strm;
+      strm.Create_t(fnmBlob);
+      strm.Write_t(&aBlob[0], aBlob.Count());
+
+    } catch (char *strError) {
+      CPrintF(TRANS("Cannot save compiled HUD theme '%s': %s\n"), fnmBlob.str_String, strError);
+    }
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot load HUD theme '%s': %s\n"), fnmSource.str_String, strError);
+  }
+};
+
+// Apply all theme files to current properties of themes
+void LoadThemeFiles(void) {
+  ASSERT(ARRAYCOUNT(_astrColorNames) == CT_THEME_COLORS);
+
+  CDynamicStackArray<CTFileName> afnmThemes;
+  MakeDirList(afnmThemes, CTString(THEME_FILES_DIR), CTString("*.aht"), 0);
+
+  for (INDEX iFile = 0; iFile < afnmThemes.Count(); iFile++) {
+    LoadThemeFile(afnmThemes[iFile]);
+  }
+};
@@ -0,0 +1,50 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#ifndef CECIL_INCL_THEMEFILES_H
+#define CECIL_INCL_THEMEFILES_H
+
+#ifdef PRAGMA_ONCE
+  #pragma once
+#endif
+
+// Directory with theme definitions
+#define THEME_FILES_DIR "Data\\ClassicsPatch\\AdvancedHUD\\Themes\\"
+
+// Header of a compiled theme file
+struct HudThemeBlob {
+  ULONG ulID;
+  INDEX iVersion;
+  ULONG ulSourceCRC; // Checksum of the definition that it's been compiled from
+  SLONG slSourceSize;
+
+  INDEX iTheme; // Theme that's being changed
+  ULONG ulColors; // Defined colors (bit per color in the set)
+  HudColorSet colors;
+  ULONG ulUnits; // Defined units (bit per EHudThemeUnit)
+  FLOAT afUnits[E_HTU_MAX];
+
+  // Offsets in the string table (-1 if not defined)
+  INDEX iIconDir;
+  INDEX aiFonts[E_HTF_MAX];
+
+  INDEX ctIcons; // Replaced icons as pairs of file name and path offsets after the header
+  SLONG slStrings; // Size of the string table after the icons
+};
+
+// Apply all theme files to current properties of themes
+void LoadThemeFiles(void);
+
+#endif
@@ -46,70 +46,150 @@ const HudColorSet _hcolSSR = {
   0x56596700, 0xCCDDFF00, 0x22334400, 0xFFBF5B00, // Weapon selection
 };
 
-void HudTextureSet::LoadTextures(void) {
-  // Directories with themed icons
-  static const CTString astrPaths[E_HUD_MAX] = {
-    "Textures\\Interface\\",
-    "Textures\\Interface\\",
-    "TexturesMP\\Interface\\",
-    "TexturesPatch\\Interface\\Revolution\\",
+// Directories with themed icons
+static const CTString _astrThemePaths[E_HUD_MAX] = {
+  "Textures\\Interface\\",
+  "Textures\\Interface\\",
+  "TexturesMP\\Interface\\",
+  "TexturesPatch\\Interface\\Revolution\\",
+};
+
+// Theme names for reports and theme files
+const char *_astrThemeNames[E_HUD_MAX] = {
+  "TFE", "Warped", "TSE", "SSR",
+};
+
+// Current properties of each theme
+HudThemeData _athdThemes[E_HUD_MAX];
+
+// Theme whose icon textures are currently drawn
+INDEX _iTextureTheme = HUD_DEFAULT_THEME;
+
+// Get path to an icon in some directory unless it's been replaced
+CTString HudThemeData::GetIconPath(const CTString &strDir, const char *strFile) const {
+  for (INDEX iIcon = 0; iIcon < astrIconNames.Count(); iIcon++) {
+    if (astrIconNames[iIcon] == strFile) return astrIconPaths[iIcon];
+  }
+
+  return strDir + strFile;
+};
+
+// Set default properties of all themes and apply theme files over them
+void SetupThemes(void) {
+  static const HudColorSet *aColorSets[E_HUD_MAX] = {
+    &_hcolTFE, &_hcolWarped, &_hcolTSE, &_hcolSSR,
   };
 
   for (INDEX iTheme = 0; iTheme < E_HUD_MAX; iTheme++) {
-    const CTString &strPath = astrPaths[iTheme];
-    const BOOL bTFE = (iTheme <= E_HUD_WARPED);
-
-    // Status bar textures
-    toHealth   .SetIcon(iTheme, strPath + "HSuper.tex");
-    toOxygen   .SetIcon(iTheme, strPath + "Oxygen-2.tex");
-    toFrags    .SetIcon(iTheme, strPath + "IBead.tex");
-    toDeaths   .SetIcon(iTheme, strPath + "ISkull.tex");
-    toScore    .SetIcon(iTheme, strPath + "IScore.tex");
-    toHiScore  .SetIcon(iTheme, strPath + "IHiScore.tex");
-    toMessage  .SetIcon(iTheme, strPath + "IMessage.tex");
-    atoArmor[0].SetIcon(iTheme, strPath + (bTFE ? "ArStrong.tex" : "ArSmall.tex"));
-    atoArmor[1].SetIcon(iTheme, strPath + (bTFE ? "ArStrong.tex" : "ArMedium.tex"));
-    atoArmor[2].SetIcon(iTheme, strPath + "ArStrong.tex");
-
-    // Ammo textures
-    toAShells     .SetIcon(iTheme, strPath + "AmShells.tex");
-    toABullets    .SetIcon(iTheme, strPath + "AmBullets.tex");
-    toARockets    .SetIcon(iTheme, strPath + "AmRockets.tex");
-    toAGrenades   .SetIcon(iTheme, strPath + "AmGrenades.tex");
-    toAElectricity.SetIcon(iTheme, strPath + "AmElectricity.tex");
-    toAIronBall   .SetIcon(iTheme, strPath + (bTFE ? "AmCannon.tex" : "AmCannonBall.tex"));
-
-    // Weapon textures
-    toWKnife          .SetIcon(iTheme, strPath + "WKnife.tex");
-    toWColt           .SetIcon(iTheme, strPath + "WColt.tex");
-    toWSingleShotgun  .SetIcon(iTheme, strPath + "WSingleShotgun.tex");
-    toWDoubleShotgun  .SetIcon(iTheme, strPath + "WDoubleShotgun.tex");
-    toWTommygun       .SetIcon(iTheme, strPath + "WTommygun.tex");
-    toWMinigun        .SetIcon(iTheme, strPath + "WMinigun.tex");
-    toWRocketLauncher .SetIcon(iTheme, strPath + "WRocketLauncher.tex");
-    toWGrenadeLauncher.SetIcon(iTheme, strPath + "WGrenadeLauncher.tex");
-    toWLaser          .SetIcon(iTheme, strPath + "WLaser.tex");
-    toWIronCannon     .SetIcon(iTheme, strPath + "WCannon.tex");
+    HudThemeData &thd = _athdThemes[iTheme];
 
-  #if SE1_GAME != SS_TFE
-    // Ammo textures
-    toANapalm       .SetIcon(iTheme, strPath + "AmFuelReservoir.tex");
-    toASniperBullets.SetIcon(iTheme, strPath + "AmSniperBullets.tex");
-
-    // Weapon textures
-    toWChainsaw.SetIcon(iTheme, strPath + "WChainsaw.tex");
-    toWSniper  .SetIcon(iTheme, strPath + "WSniper.tex");
-    toWFlamer  .SetIcon(iTheme, strPath + "WFlamer.tex");
-
-    // Power up textures
-    const CTString &strPowerUp = (bTFE ? astrPaths[E_HUD_TSE] : strPath);
-
-    atoPowerups[0].SetIcon(iTheme, strPowerUp + "PInvisibility.tex");
-    atoPowerups[1].SetIcon(iTheme, strPowerUp + "PInvulnerability.tex");
-    atoPowerups[2].SetIcon(iTheme, strPowerUp + "PSeriousDamage.tex");
-    atoPowerups[3].SetIcon(iTheme, strPowerUp + "PSeriousSpeed.tex");
-    toASeriousBomb.SetIcon(iTheme, strPowerUp + "AmSeriousBomb.tex");
-  #endif
+    thd.colors = *aColorSets[iTheme];
+    thd.strIconDir = _astrThemePaths[iTheme];
+
+    if (iTheme <= E_HUD_TSE) {
+      thd.afnmFonts[E_HTF_TEXT] = CTFILENAME("Fonts\\Display3-narrow.fnt");
+      thd.afnmFonts[E_HTF_NUMBERS] = CTFILENAME("Fonts\\Numbers3.fnt");
+
+    } else {
+      thd.afnmFonts[E_HTF_TEXT] = CTFILENAME("Fonts\\Rev_HUD\\Cabin.fnt");
+      thd.afnmFonts[E_HTF_NUMBERS] = CTFILENAME("Fonts\\Rev_HUD\\Numbers.fnt");
+    }
+
+    thd.afUnits[E_HTU_ONE]  = 32.0f;
+    thd.afUnits[E_HTU_ADV]  = 36.0f;
+    thd.afUnits[E_HTU_NEXT] = 40.0f;
+
+    thd.astrIconNames.PopAll();
+    thd.astrIconPaths.PopAll();
+  }
+
+  LoadThemeFiles();
+};
+
+// Load textures of one theme
+void HudTextureSet::LoadTheme(INDEX iTheme, BOOL bConstant) {
+  const HudThemeData &thd = _athdThemes[iTheme];
+  const CTString &strPath = thd.strIconDir;
+  const BOOL bTFE = (iTheme <= E_HUD_WARPED);
+
+  // Icon from the theme directory or its replacement
+  #define THEME_ICON(_Dir, _File) thd.GetIconPath(_Dir, _File)
+
+  // Status bar textures
+  toHealth   .SetIcon(iTheme, THEME_ICON(strPath, "HSuper.tex"), bConstant);
+  toOxygen   .SetIcon(iTheme, THEME_ICON(strPath, "Oxygen-2.tex"), bConstant);
+  toFrags    .SetIcon(iTheme, THEME_ICON(strPath, "IBead.tex"), bConstant);
+  toDeaths   .SetIcon(iTheme, THEME_ICON(strPath, "ISkull.tex"), bConstant);
+  toScore    .SetIcon(iTheme, THEME_ICON(strPath, "IScore.tex"), bConstant);
+  toHiScore  .SetIcon(iTheme, THEME_ICON(strPath, "IHiScore.tex"), bConstant);
+  toMessage  .SetIcon(iTheme, THEME_ICON(strPath, "IMessage.tex"), bConstant);
+  atoArmor[0].SetIcon(iTheme, THEME_ICON(strPath, (bTFE ? "ArStrong.tex" : "ArSmall.tex")), bConstant);
+  atoArmor[1].SetIcon(iTheme, THEME_ICON(strPath, (bTFE ? "ArStrong.tex" : "ArMedium.tex")), bConstant);
+  atoArmor[2].SetIcon(iTheme, THEME_ICON(strPath, "ArStrong.tex"), bConstant);
+
+  // Ammo textures
+  toAShells     .SetIcon(iTheme, THEME_ICON(strPath, "AmShells.tex"), bConstant);
+  toABullets    .SetIcon(iTheme, THEME_ICON(strPath, "AmBullets.tex"), bConstant);
+  toARockets    .SetIcon(iTheme, THEME_ICON(strPath, "AmRockets.tex"), bConstant);
+  toAGrenades   .SetIcon(iTheme, THEME_ICON(strPath, "AmGrenades.tex"), bConstant);
+  toAElectricity.SetIcon(iTheme, THEME_ICON(strPath, "AmElectricity.tex"), bConstant);
+  toAIronBall   .SetIcon(iTheme, THEME_ICON(strPath, (bTFE ? "AmCannon.tex" : "AmCannonBall.tex")), bConstant);
+
+  // Weapon textures
+  toWKnife          .SetIcon(iTheme, THEME_ICON(strPath, "WKnife.tex"), bConstant);
+  toWColt           .SetIcon(iTheme, THEME_ICON(strPath, "WColt.tex"), bConstant);
+  toWSingleShotgun  .SetIcon(iTheme, THEME_ICON(strPath, "WSingleShotgun.tex"), bConstant);
+  toWDoubleShotgun  .SetIcon(iTheme, THEME_ICON(strPath, "WDoubleShotgun.tex"), bConstant);
+  toWTommygun       .SetIcon(iTheme, THEME_ICON(strPath, "WTommygun.tex"), bConstant);
+  toWMinigun        .SetIcon(iTheme, THEME_ICON(strPath, "WMinigun.tex"), bConstant);
+  toWRocketLauncher .SetIcon(iTheme, THEME_ICON(strPath, "WRocketLauncher.tex"), bConstant);
+  toWGrenadeLauncher.SetIcon(iTheme, THEME_ICON(strPath, "WGrenadeLauncher.tex"), bConstant);
+  toWLaser          .SetIcon(iTheme, THEME_ICON(strPath, "WLaser.tex"), bConstant);
+  toWIronCannon     .SetIcon(iTheme, THEME_ICON(strPath, "WCannon.tex"), bConstant);
+
+#if SE1_GAME != SS_TFE
+  // Ammo textures
+  toANapalm       .SetIcon(iTheme, THEME_ICON(strPath, "AmFuelReservoir.tex"), bConstant);
+  toASniperBullets.SetIcon(iTheme, THEME_ICON(strPath, "AmSniperBullets.tex"), bConstant);
+
+  // Weapon textures
+  toWChainsaw.SetIcon(iTheme, THEME_ICON(strPath, "WChainsaw.tex"), bConstant);
+  toWSniper  .SetIcon(iTheme, THEME_ICON(strPath, "WSniper.tex"), bConstant);
+  toWFlamer  .SetIcon(iTheme, THEME_ICON(strPath, "WFlamer.tex"), bConstant);
+
+  // Power up textures
+  const CTString &strPowerUp = (bTFE ? _athdThemes[E_HUD_TSE].strIconDir : strPath);
+
+  atoPowerups[0].SetIcon(iTheme, THEME_ICON(strPowerUp, "PInvisibility.tex"), bConstant);
+  atoPowerups[1].SetIcon(iTheme, THEME_ICON(strPowerUp, "PInvulnerability.tex"), bConstant);
+  atoPowerups[2].SetIcon(iTheme, THEME_ICON(strPowerUp, "PSeriousDamage.tex"), bConstant);
+  atoPowerups[3].SetIcon(iTheme, THEME_ICON(strPowerUp, "PSeriousSpeed.tex"), bConstant);
+  toASeriousBomb.SetIcon(iTheme, THEME_ICON(strPowerUp, "AmSeriousBomb.tex"), bConstant);
+#endif
+
+  #undef THEME_ICON
+
+  abLoaded[iTheme] = TRUE;
+  abConstant[iTheme] = bConstant;
+};
+
+// Load textures of all themes that are needed right away
+void HudTextureSet::LoadTextures(INDEX iSetLoadMode, INDEX iActiveTheme) {
+  iLoadMode = Clamp(iSetLoadMode, (INDEX)E_TT_CONSTANT, (INDEX)E_TT_ONDEMAND);
+  RegisterIcons();
+  _iTextureTheme = iActiveTheme;
+
+  for (INDEX iTheme = 0; iTheme < E_HUD_MAX; iTheme++) {
+    abLoaded[iTheme] = FALSE;
+    abConstant[iTheme] = FALSE;
+    abFailed[iTheme] = FALSE;
+
+    const BOOL bActive = (iTheme == iActiveTheme);
+
+    // Load other themes later
+    if (iLoadMode == E_TT_ONDEMAND && !bActive) continue;
+
+    LoadTheme(iTheme, (iLoadMode == E_TT_CONSTANT || bActive));
   }
 
   // Sniper mask textures for TSE
@@ -139,3 +219,180 @@ void HudTextureSet::LoadTextures(void) {
   toMarker.SetData_t(CTFILENAME("TexturesPatch\\Interface\\IPlayerMarker.tex"));
   ((CTextureData *)toMarker.GetData())->Force(TEX_CONSTANT);
 };
+
+// Add all themed icons to the groups
+void HudTextureSet::RegisterIcons(void) {
+  for (INDEX iGroup = 0; iGroup < E_HTG_MAX; iGroup++) {
+    aIcons[iGroup].PopAll();
+  }
+
+  #define ADD_ICON(_Group, _Icon) aIcons[_Group].Push() = &_Icon
+
+  ADD_ICON(E_HTG_STATUS, toHealth);
+  ADD_ICON(E_HTG_STATUS, toOxygen);
+  ADD_ICON(E_HTG_STATUS, toFrags);
+  ADD_ICON(E_HTG_STATUS, toDeaths);
+  ADD_ICON(E_HTG_STATUS, toScore);
+  ADD_ICON(E_HTG_STATUS, toHiScore);
+  ADD_ICON(E_HTG_STATUS, toMessage);
+  ADD_ICON(E_HTG_STATUS, atoArmor[0]);
+  ADD_ICON(E_HTG_STATUS, atoArmor[1]);
+  ADD_ICON(E_HTG_STATUS, atoArmor[2]);
+
+  ADD_ICON(E_HTG_AMMO, toAShells);
+  ADD_ICON(E_HTG_AMMO, toABullets);
+  ADD_ICON(E_HTG_AMMO, toARockets);
+  ADD_ICON(E_HTG_AMMO, toAGrenades);
+  ADD_ICON(E_HTG_AMMO, toAElectricity);
+  ADD_ICON(E_HTG_AMMO, toAIronBall);
+
+  ADD_ICON(E_HTG_WEAPONS, toWKnife);
+  ADD_ICON(E_HTG_WEAPONS, toWColt);
+  ADD_ICON(E_HTG_WEAPONS, toWSingleShotgun);
+  ADD_ICON(E_HTG_WEAPONS, toWDoubleShotgun);
+  ADD_ICON(E_HTG_WEAPONS, toWTommygun);
+  ADD_ICON(E_HTG_WEAPONS, toWMinigun);
+  ADD_ICON(E_HTG_WEAPONS, toWRocketLauncher);
+  ADD_ICON(E_HTG_WEAPONS, toWGrenadeLauncher);
+  ADD_ICON(E_HTG_WEAPONS, toWLaser);
+  ADD_ICON(E_HTG_WEAPONS, toWIronCannon);
+
+#if SE1_GAME != SS_TFE
+  ADD_ICON(E_HTG_AMMO, toANapalm);
+  ADD_ICON(E_HTG_AMMO, toASniperBullets);
+
+  ADD_ICON(E_HTG_WEAPONS, toWChainsaw);
+  ADD_ICON(E_HTG_WEAPONS, toWSniper);
+  ADD_ICON(E_HTG_WEAPONS, toWFlamer);
+
+  ADD_ICON(E_HTG_POWERUPS, atoPowerups[0]);
+  ADD_ICON(E_HTG_POWERUPS, atoPowerups[1]);
+  ADD_ICON(E_HTG_POWERUPS, atoPowerups[2]);
+  ADD_ICON(E_HTG_POWERUPS, atoPowerups[3]);
+  ADD_ICON(E_HTG_POWERUPS, toASeriousBomb);
+#endif
+
+  #undef ADD_ICON
+};
+
+// Make sure that textures of the active theme are loaded in full quality
+INDEX HudTextureSet::PrepareTheme(INDEX iTheme) {
+  // Load the theme on demand
+  if (!abLoaded[iTheme] && !abFailed[iTheme]) {
+    try {
+      LoadTheme(iTheme, TRUE);
+
+    } catch (char *strError) {
+      CPrintF(TRANS("Cannot load textures of HUD theme %d: %s\n"), iTheme, strError);
+      abFailed[iTheme] = TRUE;
+    }
+  }
+
+  // Fall back to the default theme or any other one that has been loaded
+  if (!abLoaded[iTheme]) {
+    if (iTheme != HUD_DEFAULT_THEME && !abFailed[HUD_DEFAULT_THEME]) {
+      return PrepareTheme(HUD_DEFAULT_THEME);
+    }
+
+    for (INDEX iOther = 0; iOther < E_HUD_MAX; iOther++) {
+      if (abLoaded[iOther]) return PrepareTheme(iOther);
+    }
+
+    // Active theme is always loaded with the rest of the HUD
+    ASSERTALWAYS("No HUD theme textures have been loaded!");
+    return iTheme;
+  }
+
+  _iTextureTheme = iTheme;
+
+  if (abConstant[iTheme]) return iTheme;
+
+  // Restore full quality of the previously inactive theme
+  for (INDEX iGroup = 0; iGroup < E_HTG_MAX; iGroup++) {
+    for (INDEX iIcon = 0; iIcon < aIcons[iGroup].Count(); iIcon++) {
+      aIcons[iGroup][iIcon]->MakeConstant(iTheme);
+    }
+  }
+
+  abConstant[iTheme] = TRUE;
+  return iTheme;
+};
+
+// Add memory of texture data unless it has already been counted
+static SLONG CountTextureOnce(CStaticStackArray<CTextureData *> &aCounted, CTextureObject &to) {
+  CTextureData *ptd = (CTextureData *)to.GetData();
+  if (ptd == NULL) return 0;
+
+  for (INDEX i = 0; i < aCounted.Count(); i++) {
+    if (aCounted[i] == ptd) return 0;
+  }
+
+  aCounted.Push() = ptd;
+  return ptd->GetUsedMemory();
+};
+
+// Print memory used by textures of each theme and group
+void HudTextureSet::ReportMemory(void) {
+  static const char *astrGroups[E_HTG_MAX] = {
+    "status", "ammo", "weapons", "powerups",
+  };
+
+  static const char *astrLoadModes[] = {
+    "constant", "reduced", "on demand",
+  };
+
+  CPrintF(TRANS("HUD textures (%s):\n"), astrLoadModes[iLoadMode]);
+
+  // Textures counted across all themes
+  CStaticStackArray<CTextureData *> aCountedTotal;
+  SLONG slTotal = 0;
+
+  for (INDEX iTheme = 0; iTheme < E_HUD_MAX; iTheme++) {
+    if (!abLoaded[iTheme]) {
+      CPrintF(TRANS("  %-6s: not loaded\n"), _astrThemeNames[iTheme]);
+      continue;
+    }
+
+    // Textures counted for this theme
+    CStaticStackArray<CTextureData *> aCounted;
+    CTString strGroups = "";
+    SLONG slTheme = 0;
+
+    for (INDEX iGroup = 0; iGroup < E_HTG_MAX; iGroup++) {
+      SLONG slGroup = 0;
+
+      for (INDEX iIcon = 0; iIcon < aIcons[iGroup].Count(); iIcon++) {
+        CTextureObject &to = aIcons[iGroup][iIcon]->ato[iTheme];
+
+        slGroup += CountTextureOnce(aCounted, to);
+        slTotal += CountTextureOnce(aCountedTotal, to);
+      }
+
+      if (slGroup == 0) continue;
+
+      strGroups.PrintF("%s, %s %d KB", strGroups, astrGroups[iGroup], slGroup / 1024);
+      slTheme += slGroup;
+    }
+
+    CPrintF("  %-6s: %5d KB%s%s\n", _astrThemeNames[iTheme], slTheme / 1024, strGroups,
+      abConstant[iTheme] ? "" : TRANS(" (reduced)"));
+  }
+
+  // Textures shared between all themes
+  SLONG slShared = 0;
+
+#if SE1_GAME != SS_TFE
+  slShared += CountTextureOnce(aCountedTotal, toSniperMask);
+  slShared += CountTextureOnce(aCountedTotal, toSniperWheel);
+  slShared += CountTextureOnce(aCountedTotal, toSniperArrow);
+  slShared += CountTextureOnce(aCountedTotal, toSniperEye);
+  slShared += CountTextureOnce(aCountedTotal, toSniperLed);
+#endif
+
+  slShared += CountTextureOnce(aCountedTotal, toTile);
+  slShared += CountTextureOnce(aCountedTotal, toLives);
+  slShared += CountTextureOnce(aCountedTotal, toMarker);
+
+  CPrintF(TRANS("  Shared: %5d KB\n"), slShared / 1024);
+  CPrintF(TRANS("  Total : %5d KB (textures used by multiple themes are counted once)\n"), (slTotal + slShared) / 1024);
+};
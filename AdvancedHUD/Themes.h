@@ -30,22 +30,67 @@ enum EHudTheme {
   E_HUD_MAX, // Maximum amount of themes
 };
 
+// Theme selected by default
+#if SE1_GAME == SS_TFE
+  #define HUD_DEFAULT_THEME E_HUD_TFE
+#else
+  #define HUD_DEFAULT_THEME E_HUD_TSE
+#endif
+
+// Theme whose icon textures are currently drawn
+extern INDEX _iTextureTheme;
+
+// Theme properties known at compile time
+template<INDEX iTheme>
+struct HudThemeTraits {
+  enum {
+    bTSEColors = (iTheme > E_HUD_TFE), // Colors from TSE
+    bTSETheme  = (iTheme >= E_HUD_TSE), // Icons from TSE
+    bRevStyle  = (iTheme == E_HUD_SSR), // Revolution layout
+  };
+};
+
 #define MAX_POWERUPS 4
 
+// How textures of themes other than the active one are kept in memory
+enum EThemeTextures {
+  E_TT_CONSTANT = 0, // Load all themes in full quality
+  E_TT_REDUCED  = 1, // Let texture quality settings downscale inactive themes
+  E_TT_ONDEMAND = 2, // Load themes when they are selected for the first time
+};
+
+// Groups of themed textures for memory reports
+enum EHudTexGroup {
+  E_HTG_STATUS,
+  E_HTG_AMMO,
+  E_HTG_WEAPONS,
+  E_HTG_POWERUPS,
+
+  E_HTG_MAX,
+};
+
 // Multi-theme container for icons
 struct SIconTexture {
   CTextureObject ato[E_HUD_MAX];
 
   // Set icon texture for a specific theme
-  void SetIcon(INDEX iTheme, const CTString &strTexture) {
+  void SetIcon(INDEX iTheme, const CTString &strTexture, BOOL bConstant = TRUE) {
     ato[iTheme].SetData_t(strTexture);
-    ((CTextureData *)ato[iTheme].GetData())->Force(TEX_CONSTANT);
+
+    if (bConstant) {
+      ((CTextureData *)ato[iTheme].GetData())->Force(TEX_CONSTANT);
+    }
+  };
+
+  // Prevent texture of a specific theme from being downscaled
+  void MakeConstant(INDEX iTheme) {
+    CTextureData *ptd = (CTextureData *)ato[iTheme].GetData();
+    if (ptd != NULL) ptd->Force(TEX_CONSTANT);
   };
 
   // Return texture depending on the theme
   inline CTextureObject &Texture(void) {
-    INDEX iTheme = Clamp(_psTheme.GetIndex(), (INDEX)0, INDEX(E_HUD_MAX - 1));
-    return ato[iTheme];
+    return ato[_iTextureTheme];
   };
 
   // Implicit conversion
@@ -115,7 +160,29 @@ struct HudTextureSet {
   // Player marker
   CTextureObject toMarker;
 
-  void LoadTextures(void);
+  // Themed icons by group
+  CStaticStackArray<SIconTexture *> aIcons[E_HTG_MAX];
+
+  INDEX iLoadMode; // EThemeTextures
+  BOOL abLoaded[E_HUD_MAX]; // Theme textures have been loaded
+  BOOL abConstant[E_HUD_MAX]; // Theme textures have full quality
+  BOOL abFailed[E_HUD_MAX]; // Theme textures couldn't be loaded on demand
+
+  // Load textures of all themes that are needed right away
+  void LoadTextures(INDEX iSetLoadMode, INDEX iActiveTheme);
+
+  // Load textures of one theme
+  void LoadTheme(INDEX iTheme, BOOL bConstant);
+
+  // Make sure that textures of the active theme are loaded in full quality
+  // Returns the theme that can actually be drawn with
+  INDEX PrepareTheme(INDEX iTheme);
+
+  // Print memory used by textures of each theme and group
+  void ReportMemory(void);
+
+  // Add all themed icons to the groups
+  void RegisterIcons(void);
 };
 
 // Set of colors for the theme
@@ -151,4 +218,45 @@ extern const HudColorSet _hcolWarped;
 extern const HudColorSet _hcolTSE;
 extern const HudColorSet _hcolSSR;
 
+// Unit sizes that the layout is based on
+enum EHudThemeUnit {
+  E_HTU_ONE,  // Icon size
+  E_HTU_ADV,  // Distance between icons in a row
+  E_HTU_NEXT, // Distance between rows
+
+  E_HTU_MAX,
+};
+
+// Fonts used by the theme
+enum EHudThemeFont {
+  E_HTF_TEXT,
+  E_HTF_NUMBERS,
+
+  E_HTF_MAX,
+};
+
+// Theme properties that can be changed by theme files
+struct HudThemeData {
+  HudColorSet colors;
+  CTString strIconDir; // Directory with themed icons
+  CTFileName afnmFonts[E_HTF_MAX];
+  FLOAT afUnits[E_HTU_MAX];
+
+  // Icons replaced by theme files (by file name in the icon directory)
+  CStaticStackArray<CTString> astrIconNames;
+  CStaticStackArray<CTString> astrIconPaths;
+
+  // Get path to an icon in some directory unless it's been replaced
+  CTString GetIconPath(const CTString &strDir, const char *strFile) const;
+};
+
+// Theme names for reports and theme files
+extern const char *_astrThemeNames[E_HUD_MAX];
+
+// Current properties of each theme
+extern HudThemeData _athdThemes[E_HUD_MAX];
+
+// Set default properties of all themes and apply theme files over them
+void SetupThemes(void);
+
 #endif
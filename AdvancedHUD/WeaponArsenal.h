@@ -25,13 +25,10 @@ struct HudAmmo {
   struct SIconTexture *ptoAmmo;
   INDEX iAmmo;
   INDEX iMaxAmmo;
-  INDEX iLastAmmo;
-  FLOAT tmAmmoChanged;
   BOOL bHasWeapon;
 
   HudAmmo() : ptoAmmo(NULL),
-    iAmmo(0), iMaxAmmo(0), iLastAmmo(0),
-    tmAmmoChanged(-9), bHasWeapon(FALSE)
+    iAmmo(0), iMaxAmmo(0), bHasWeapon(FALSE)
   {
   };
 
@@ -59,6 +56,34 @@ struct HudWeapon {
   };
 };
 
+// Weapon selection strip laid out for a certain state of the arsenal
+struct HudWeaponStrip {
+  // One visible weapon
+  struct Slot {
+    FLOAT fCol;
+    SIconTexture *ptoWeapon;
+    COLOR colBorder;
+    COLOR colIcon;
+  };
+
+  // State that the layout has been made for
+  BOOL bValid;
+  INDEX iAvailableWeapons;
+  ULONG ulEmptyAmmo; // Ammo types that have ran out
+  SIconTexture *ptoWanted;
+  FLOAT fRow;
+  FLOAT fAdv;
+  FLOAT fOne;
+  COLOR colBorder;
+  COLOR colIcon;
+  COLOR colNoAmmo;
+  COLOR colWanted;
+
+  CStaticStackArray<Slot> aSlots;
+
+  HudWeaponStrip() : bValid(FALSE) {};
+};
+
 struct HudArsenal {
   // Stack types
   typedef CStaticStackArray<HudAmmo> AmmoStack;
@@ -66,6 +91,7 @@ struct HudArsenal {
 
   AmmoStack aAmmo;
   WeaponStack aWeapons;
+  HudWeaponStrip strip;
 };
 
 #endif
@@ -0,0 +1,417 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "StartActions.h"
+#include "AffectTable.h"
+#include "AffectPlan.h"
+
+// Directory with plans on disk
+#define AFFECT_PLANS_DIR "Data\\ClassicsPatch\\ServerUtilities\\Plans\\"
+
+// Plan format on disk
+static const INDEX _iPlanVersion = 1;
+
+// Maximum amount of plans kept in memory
+static const INDEX _ctMaxPlans = 16;
+
+// Recorded change of some entity
+struct AffectPlanRecord {
+  ULONG ulEntity;
+  INDEX iClassID; // For verifying that the entity is still the same
+  INDEX iType;
+  ULONG ulPropType;
+  ULONG ulPropID;
+  DOUBLE fValue;
+};
+
+// Changes of some world with some settings
+struct AffectPlan {
+  CTFileName fnmWorld;
+  ULONG ulWorldCRC;
+  ULONG ulSettingsCRC;
+  CStaticStackArray<AffectPlanRecord> aRecords;
+};
+
+// Plans in memory from the oldest to the newest
+static CDynamicContainer<AffectPlan> _cPlans;
+
+// Checksum of the last world file, calculated once per world load
+static BOOL _bWorldCRC = FALSE;
+static CTFileName _fnmWorldCRC;
+static ULONG _ulWorldCRC = 0;
+
+// Calculate checksum of a world file if it hasn't been calculated since the current world was loaded
+ULONG IAffectPlan::GetWorldCRC_t(const CTFileName &fnmWorld) {
+  if (_bWorldCRC && _fnmWorldCRC == fnmWorld) return _ulWorldCRC;
+
+  CTFileStream strm;
+  strm.Open_t(fnmWorld);
+
+  const SLONG slSize = strm.GetStreamSize();
+
+  CStaticArray<UBYTE> aubFile;
+  aubFile.New(slSize);
+  if (slSize > 0) strm.Read_t(&aubFile[0], slSize);
+
+  ULONG ulCRC;
+  CRC_Start(ulCRC);
+  if (slSize > 0) CRC_AddBlock(ulCRC, &aubFile[0], slSize);
+  CRC_Finish(ulCRC);
+
+  _bWorldCRC = TRUE;
+  _fnmWorldCRC = fnmWorld;
+  _ulWorldCRC = ulCRC;
+  return ulCRC;
+};
+
+// Calculate world checksum again after a new world is loaded
+void IAffectPlan::ResetWorldCRC(void) {
+  _bWorldCRC = FALSE;
+};
+
+// Add value of some symbol to the checksum
+static inline void AddSymbolToCRC(ULONG &ulCRC, CPluginSymbol &ps) {
+  const INDEX iValue = ps.GetIndex();
+  CRC_AddLONG(ulCRC, iValue);
+};
+
+static inline void AddFloatToCRC(ULONG &ulCRC, CPluginSymbol &ps) {
+  const FLOAT fValue = ps.GetFloat();
+  CRC_AddFLOAT(ulCRC, fValue);
+};
+
+// Calculate checksum of all settings that affect entities
+static ULONG GetSettingsCRC(void) {
+  ULONG ulCRC;
+  CRC_Start(ulCRC);
+
+  INDEX i;
+
+  for (i = 0; i < CT_WEAPONS; i++) {
+    AddSymbolToCRC(ulCRC, _apsGiveWeapons[i]);
+    AddSymbolToCRC(ulCRC, _apsWeaponItems[i]);
+    AddSymbolToCRC(ulCRC, _apsAmmoItems[i]);
+  }
+
+  for (i = 0; i < CT_ITEMS; i++) {
+    AddSymbolToCRC(ulCRC, _apsHealthItems[i]);
+    AddSymbolToCRC(ulCRC, _apsArmorItems[i]);
+    AddSymbolToCRC(ulCRC, _apsPowerUpItems[i]);
+  }
+
+  AddSymbolToCRC(ulCRC, _psReplaceWeapons);
+  AddSymbolToCRC(ulCRC, _psReplaceAmmo);
+  AddSymbolToCRC(ulCRC, _psReplaceHealth);
+  AddSymbolToCRC(ulCRC, _psReplaceArmor);
+  AddSymbolToCRC(ulCRC, _psMaxAmmo);
+
+  AddFloatToCRC(ulCRC, _psStartHP);
+  AddFloatToCRC(ulCRC, _psStartAR);
+  AddFloatToCRC(ulCRC, _psEnemyMul);
+
+  // Modded classes from the config
+  IAffectTable::AddConfigToCRC(ulCRC);
+
+  CRC_Finish(ulCRC);
+  return ulCRC;
+};
+
+// Plan file of some world
+static CTFileName GetPlanFile(const CTFileName &fnmWorld) {
+  return CTString(AFFECT_PLANS_DIR) + fnmWorld.NoExt() + ".sup";
+};
+
+// Find plan in memory
+static AffectPlan *FindPlan(ULONG ulWorldCRC, ULONG ulSettingsCRC) {
+  FOREACHINDYNAMICCONTAINER(_cPlans, AffectPlan, itplan) {
+    if (itplan->ulWorldCRC == ulWorldCRC && itplan->ulSettingsCRC == ulSettingsCRC) return itplan;
+  }
+
+  return NULL;
+};
+
+// Add new plan to memory and discard the oldest one if there are too many
+static void AddPlan(AffectPlan *pplan) {
+  if (_cPlans.Count() >= _ctMaxPlans) {
+    AffectPlan *pplanOldest = _cPlans.Pointer(0);
+    _cPlans.Remove(pplanOldest);
+    delete pplanOldest;
+  }
+
+  _cPlans.Add(pplan);
+};
+
+// Sort records by entities in the order changes are applied to them
+static int CompareRecords(const void *pElement1, const void *pElement2) {
+  const AffectPlanRecord &rec1 = *(const AffectPlanRecord *)pElement1;
+  const AffectPlanRecord &rec2 = *(const AffectPlanRecord *)pElement2;
+
+  if (rec1.ulEntity != rec2.ulEntity) return (rec1.ulEntity < rec2.ulEntity) ? -1 : +1;
+  if (rec1.iType != rec2.iType) return (rec1.iType < rec2.iType) ? -1 : +1;
+  if (rec1.ulPropID != rec2.ulPropID) return (rec1.ulPropID < rec2.ulPropID) ? -1 : +1;
+  return 0;
+};
+
+// Write plan on disk
+static void WritePlan_t(const AffectPlan &plan) {
+  CTFileStream strm;
+  strm.Create_t(GetPlanFile(plan.fnmWorld));
+
+  strm.WriteID_t("SUAP");
+  strm << _iPlanVersion;
+  strm << plan.ulWorldCRC << plan.ulSettingsCRC;
+
+  const INDEX ctRecords = plan.aRecords.Count();
+  strm << ctRecords;
+
+  if (ctRecords > 0) strm.Write_t(&plan.aRecords[0], ctRecords * sizeof(AffectPlanRecord));
+};
+
+// Read plan from disk if it's for the same world and settings
+static BOOL ReadPlan_t(AffectPlan &plan) {
+  const CTFileName fnmPlan = GetPlanFile(plan.fnmWorld);
+  if (!FileExists(fnmPlan)) return FALSE;
+
+  CTFileStream strm;
+  strm.Open_t(fnmPlan);
+  strm.ExpectID_t("SUAP");
+
+  INDEX iVersion;
+  ULONG ulWorldCRC, ulSettingsCRC;
+  strm >> iVersion >> ulWorldCRC >> ulSettingsCRC;
+
+  if (iVersion != _iPlanVersion || ulWorldCRC != plan.ulWorldCRC || ulSettingsCRC != plan.ulSettingsCRC) {
+    return FALSE;
+  }
+
+  INDEX ctRecords;
+  strm >> ctRecords;
+
+  // Records must fit in the rest of the file
+  const SLONG slRecords = strm.GetStreamSize() - strm.GetPos_t();
+
+  if (ctRecords < 0 || ctRecords > slRecords / (SLONG)sizeof(AffectPlanRecord)) {
+    ThrowF_t(TRANS("Invalid amount of records: %d"), ctRecords);
+  }
+
+  plan.aRecords.PopAll();
+
+  if (ctRecords > 0) {
+    plan.aRecords.Push(ctRecords);
+    strm.Read_t(&plan.aRecords[0], ctRecords * sizeof(AffectPlanRecord));
+  }
+
+  return TRUE;
+};
+
+// Sort entities by their IDs
+static int CompareEntityIDs(const void *pElement1, const void *pElement2) {
+  const CEntity *pen1 = *(const CEntity **)pElement1;
+  const CEntity *pen2 = *(const CEntity **)pElement2;
+
+  if (pen1->en_ulID == pen2->en_ulID) return 0;
+  return (pen1->en_ulID < pen2->en_ulID) ? -1 : +1;
+};
+
+// Turn plan records into changes of current world entities
+static BOOL ResolvePlan(const AffectPlan &plan, CStaticStackArray<EntityChange> &aChanges) {
+  CDynamicContainer<CEntity> &cenWorld = IWorld::GetWorld()->wo_cenEntities;
+  const INDEX ctEntities = cenWorld.Count();
+
+  // Records are sorted by entity IDs, so entities can be matched in one pass
+  CStaticArray<CEntity *> apenSorted;
+  apenSorted.New(ctEntities);
+
+  for (INDEX iEntity = 0; iEntity < ctEntities; iEntity++) {
+    apenSorted[iEntity] = cenWorld.Pointer(iEntity);
+  }
+
+  if (ctEntities > 0) {
+    qsort(&apenSorted[0], ctEntities, sizeof(CEntity *), &CompareEntityIDs);
+  }
+
+  aChanges.PopAll();
+  INDEX iEntity = 0;
+
+  for (INDEX iRecord = 0; iRecord < plan.aRecords.Count(); iRecord++) {
+    const AffectPlanRecord &rec = plan.aRecords[iRecord];
+
+    while (iEntity < ctEntities && apenSorted[iEntity]->en_ulID < rec.ulEntity) {
+      iEntity++;
+    }
+
+    // Entity is missing or isn't the same anymore
+    if (iEntity >= ctEntities || apenSorted[iEntity]->en_ulID != rec.ulEntity) return FALSE;
+
+    CEntity *pen = apenSorted[iEntity];
+    if (pen->GetClass()->ec_pdecDLLClass->dec_iID != rec.iClassID) return FALSE;
+
+    EntityChange &ec = aChanges.Push();
+    ec.pen = pen;
+    ec.ulEntity = rec.ulEntity;
+    ec.eType = (EEntityChange)rec.iType;
+    ec.pep = NULL;
+    ec.fValue = rec.fValue;
+    ec.iOrder = iRecord;
+
+    if (ec.eType == E_EC_PROP) {
+      ec.pep = pen->PropertyForTypeAndID(rec.ulPropType, rec.ulPropID);
+      if (ec.pep == NULL) return FALSE;
+    }
+  }
+
+  return TRUE;
+};
+
+// Checksums of the last world and settings that have been checked
+static CTFileName _fnmLastWorld;
+static ULONG _ulLastWorldCRC = 0;
+static ULONG _ulLastSettingsCRC = 0;
+
+// Plan that's being recorded during the affect pass
+static AffectPlan *_pplanRecording = NULL;
+
+// Get changes from a cached plan for the current world and settings, if there is one
+BOOL IAffectPlan::Replay(CStaticStackArray<EntityChange> &aChanges) {
+  const CTFileName fnmWorld = IWorld::GetWorld()->wo_fnmFileName;
+  _fnmLastWorld = CTString("");
+
+  // Discard unfinished plan of the previous world
+  Discard();
+
+  try {
+    _ulLastWorldCRC = GetWorldCRC_t(fnmWorld);
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot calculate world checksum for the affect plan: %s\n"), strError);
+    return FALSE;
+  }
+
+  _fnmLastWorld = fnmWorld;
+  _ulLastSettingsCRC = GetSettingsCRC();
+
+  AffectPlan *pplan = FindPlan(_ulLastWorldCRC, _ulLastSettingsCRC);
+
+  // Try loading the plan from disk
+  if (pplan == NULL) {
+    pplan = new AffectPlan;
+    pplan->fnmWorld = fnmWorld;
+    pplan->ulWorldCRC = _ulLastWorldCRC;
+    pplan->ulSettingsCRC = _ulLastSettingsCRC;
+
+    BOOL bRead = FALSE;
+
+    try {
+      bRead = ReadPlan_t(*pplan);
+
+    } catch (char *strError) {
+      CPrintF(TRANS("Cannot read affect plan: %s\n"), strError);
+    }
+
+    if (!bRead) {
+      delete pplan;
+      return FALSE;
+    }
+
+    AddPlan(pplan);
+  }
+
+  // Go through the whole affect pass if the world doesn't match the plan
+  if (!ResolvePlan(*pplan, aChanges)) {
+    CPutString(TRANS("Affect plan doesn't match the world entities, discarding it\n"));
+
+    _cPlans.Remove(pplan);
+    delete pplan;
+    return FALSE;
+  }
+
+  CPrintF(TRANS("Replaying affect plan for '%s'\n"), fnmWorld.str_String);
+  return TRUE;
+};
+
+// Add entity changes applied to the current world to the recorded plan
+void IAffectPlan::Record(const CStaticStackArray<EntityChange> &aApplied) {
+  // Couldn't fingerprint the world
+  if (_fnmLastWorld == "") return;
+
+  if (_pplanRecording == NULL) {
+    _pplanRecording = new AffectPlan;
+    _pplanRecording->fnmWorld = _fnmLastWorld;
+    _pplanRecording->ulWorldCRC = _ulLastWorldCRC;
+    _pplanRecording->ulSettingsCRC = _ulLastSettingsCRC;
+  }
+
+  const INDEX ctApplied = aApplied.Count();
+  if (ctApplied == 0) return;
+
+  AffectPlanRecord *arec = _pplanRecording->aRecords.Push(ctApplied);
+
+  for (INDEX i = 0; i < ctApplied; i++) {
+    const EntityChange &ec = aApplied[i];
+    AffectPlanRecord &rec = arec[i];
+
+    rec.ulEntity = ec.ulEntity;
+    rec.iClassID = ec.pen->GetClass()->ec_pdecDLLClass->dec_iID;
+    rec.iType = ec.eType;
+    rec.ulPropType = (ec.pep != NULL) ? (ULONG)ec.pep->ep_eptType : 0;
+    rec.ulPropID = (ec.pep != NULL) ? ec.pep->ep_ulID : 0;
+    rec.fValue = ec.fValue;
+  }
+};
+
+// Store the recorded plan in memory and on disk
+void IAffectPlan::Finish(void) {
+  if (_pplanRecording == NULL) return;
+
+  AffectPlan *pplan = _pplanRecording;
+  _pplanRecording = NULL;
+
+  // Changes may have been recorded in multiple batches
+  const INDEX ctRecords = pplan->aRecords.Count();
+
+  if (ctRecords > 0) {
+    qsort(&pplan->aRecords[0], ctRecords, sizeof(AffectPlanRecord), &CompareRecords);
+  }
+
+  AddPlan(pplan);
+
+  try {
+    WritePlan_t(*pplan);
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot save affect plan: %s\n"), strError);
+  }
+};
+
+// Forget the recorded plan without storing it
+void IAffectPlan::Discard(void) {
+  if (_pplanRecording != NULL) {
+    delete _pplanRecording;
+    _pplanRecording = NULL;
+  }
+};
+
+// Forget all plans in memory
+void IAffectPlan::ClearCache(void) {
+  Discard();
+
+  FOREACHINDYNAMICCONTAINER(_cPlans, AffectPlan, itplan) {
+    delete (AffectPlan *)itplan;
+  }
+
+  _cPlans.Clear();
+};
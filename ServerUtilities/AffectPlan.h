@@ -0,0 +1,38 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+class IAffectPlan {
+  public:
+    // Calculate checksum of a world file if it hasn't been calculated since the current world was loaded
+    static ULONG GetWorldCRC_t(const CTFileName &fnmWorld);
+
+    // Calculate world checksum again after a new world is loaded
+    static void ResetWorldCRC(void);
+
+    // Get changes from a cached plan for the current world and settings, if there is one
+    static BOOL Replay(CStaticStackArray<EntityChange> &aChanges);
+
+    // Add entity changes applied to the current world to the recorded plan
+    static void Record(const CStaticStackArray<EntityChange> &aApplied);
+
+    // Store the recorded plan in memory and on disk
+    static void Finish(void);
+
+    // Forget the recorded plan without storing it
+    static void Discard(void);
+
+    // Forget all plans in memory
+    static void ClearCache(void);
+};
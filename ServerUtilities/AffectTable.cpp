@@ -0,0 +1,598 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "StartActions.h"
+#include "AffectTable.h"
+#include "AffectPlan.h"
+#include "SpawnedEntities.h"
+
+#include <EntitiesV/StdH/StdH.h>
+#include <EntitiesV/AmmoItem.h>
+#include <EntitiesV/ArmorItem.h>
+#include <EntitiesV/HealthItem.h>
+#if SE1_GAME != SS_TFE
+  #include <EntitiesV/PowerUpItem.h>
+#endif
+#include <EntitiesV/WeaponItem.h>
+#include <EntitiesV/EnemySpawner.h>
+#include <EntitiesV/PlayerMarker.h>
+
+// Initial amount of slots in the table (power of two)
+#define CT_AFFECT_SLOTS 256
+
+// Handler slot of some entity class
+struct AffectSlot {
+  INDEX iClassID;
+  FEntityAffect pAffect;
+  BOOL bUsed;
+};
+
+// Handler of an entity class that's been set by its name
+struct AffectClassName {
+  CTString strClass;
+  FEntityAffect pAffect;
+};
+
+// Entities affected when their world has been loaded
+INDEX IAffectTable::ctAffectedAtLoad = 0;
+
+// Handlers by class IDs with open addressing (power of two)
+static CStaticArray<AffectSlot> _aSlots;
+static INDEX _ctUsedSlots = 0;
+
+// Handlers by class names that are resolved when their class is encountered
+static CStaticStackArray<AffectClassName> _aClassNames;
+
+// Handler list from the config
+static CTString _strConfigClasses = "";
+
+// Built-in handlers that can be assigned from the config
+static const struct { const char *strName; FEntityAffect pAffect; } _aHandlerNames[] = {
+  { "Weapon",       &AffectWeaponItem },
+  { "Ammo",         &AffectAmmoItem },
+  { "Health",       &AffectHealthItem },
+  { "Armor",        &AffectArmorItem },
+#if SE1_GAME != SS_TFE
+  { "PowerUp",      &AffectPowerUpItem },
+#endif
+  { "PlayerMarker", &AffectPlayerMarker },
+  { "EnemySpawner", &AffectEnemySpawner },
+};
+
+// Find slot of an entity class or an empty slot for it
+static AffectSlot *FindSlot(INDEX iClassID) {
+  // Table is never full, so the search always ends
+  const INDEX ctSlots = _aSlots.Count();
+  INDEX iSlot = ((ULONG)iClassID * 2654435761UL) & (ctSlots - 1);
+
+  while (_aSlots[iSlot].bUsed && _aSlots[iSlot].iClassID != iClassID) {
+    iSlot = (iSlot + 1) & (ctSlots - 1);
+  }
+
+  return &_aSlots[iSlot];
+};
+
+// Resize the table and put all used slots back into it
+static void ResizeSlots(INDEX ctSlots) {
+  CStaticArray<AffectSlot> aOld;
+  aOld.New(_aSlots.Count());
+
+  INDEX iSlot;
+
+  for (iSlot = 0; iSlot < _aSlots.Count(); iSlot++) {
+    aOld[iSlot] = _aSlots[iSlot];
+  }
+
+  _aSlots.Clear();
+  _aSlots.New(ctSlots);
+
+  for (iSlot = 0; iSlot < ctSlots; iSlot++) {
+    _aSlots[iSlot].bUsed = FALSE;
+  }
+
+  for (iSlot = 0; iSlot < aOld.Count(); iSlot++) {
+    if (aOld[iSlot].bUsed) *FindSlot(aOld[iSlot].iClassID) = aOld[iSlot];
+  }
+};
+
+// Register built-in handlers for entity classes
+void IAffectTable::RegisterDefault(void) {
+  AddHandler(CWeaponItem_ClassID, &AffectWeaponItem);
+  AddHandler(CAmmoItem_ClassID, &AffectAmmoItem);
+  AddHandler(CHealthItem_ClassID, &AffectHealthItem);
+  AddHandler(CArmorItem_ClassID, &AffectArmorItem);
+#if SE1_GAME != SS_TFE
+  AddHandler(CPowerUpItem_ClassID, &AffectPowerUpItem);
+#endif
+  AddHandler(CPlayerMarker_ClassID, &AffectPlayerMarker);
+  AddHandler(CEnemySpawner_ClassID, &AffectEnemySpawner);
+};
+
+// Register handlers for modded entity classes from the plugin config
+// Format: "AffectClasses=CModWeaponItem:Weapon, CModAmmoItem:Ammo"
+// Modded classes should have the same properties as the class of the handler (e.g. derive from it)
+void IAffectTable::LoadConfig(CIniConfig &props) {
+  CTString strList = props.GetValue("", "AffectClasses", "");
+  if (strList == "") return;
+
+  _strConfigClasses = strList;
+
+  char *strEntry = strtok(strList.str_String, ",; \t");
+
+  while (strEntry != NULL) {
+    CTString strClass = strEntry;
+    CTString strHandler = "";
+
+    // Split into the class and the handler
+    char *pchSeparator = strchr(strEntry, ':');
+
+    if (pchSeparator != NULL) {
+      strHandler = pchSeparator + 1;
+      strClass.TrimRight(pchSeparator - strEntry);
+    }
+
+    FEntityAffect pAffect = HandlerByName(strHandler);
+
+    if (pAffect == NULL) {
+      CPrintF(TRANS("Unknown affect handler '%s' for '%s' class!\n"), strHandler.str_String, strClass.str_String);
+    } else {
+      AddClassHandler(strClass, pAffect);
+    }
+
+    strEntry = strtok(NULL, ",; \t");
+  }
+};
+
+// Add handlers from the config to some checksum
+void IAffectTable::AddConfigToCRC(ULONG &ulCRC) {
+  CRC_AddBlock(ulCRC, (UBYTE *)_strConfigClasses.str_String, _strConfigClasses.Length());
+};
+
+// Set handler for an entity class by its ID
+void IAffectTable::AddHandler(INDEX iClassID, FEntityAffect pAffect) {
+  if (_aSlots.Count() == 0) ResizeSlots(CT_AFFECT_SLOTS);
+
+  AffectSlot *pSlot = FindSlot(iClassID);
+
+  if (!pSlot->bUsed) {
+    // Grow the table once it's three quarters full to keep the searches short
+    if ((_ctUsedSlots + 1) * 4 > _aSlots.Count() * 3) {
+      ResizeSlots(_aSlots.Count() * 2);
+      pSlot = FindSlot(iClassID);
+    }
+
+    _ctUsedSlots++;
+  }
+
+  pSlot->iClassID = iClassID;
+  pSlot->pAffect = pAffect;
+  pSlot->bUsed = TRUE;
+};
+
+// Set handler for an entity class by its name
+void IAffectTable::AddClassHandler(const CTString &strClass, FEntityAffect pAffect) {
+  AffectClassName &cn = _aClassNames.Push();
+  cn.strClass = strClass;
+  cn.pAffect = pAffect;
+};
+
+// Find built-in handler by its name
+FEntityAffect IAffectTable::HandlerByName(const CTString &strHandler) {
+  for (INDEX i = 0; i < ARRAYCOUNT(_aHandlerNames); i++) {
+    if (strHandler == _aHandlerNames[i].strName) return _aHandlerNames[i].pAffect;
+  }
+
+  return NULL;
+};
+
+// Find handler for an entity (NULL if its class isn't affected)
+FEntityAffect IAffectTable::FindHandler(CEntity *pen) {
+  const CDLLEntityClass *pdec = pen->GetClass()->ec_pdecDLLClass;
+  const INDEX iClassID = pdec->dec_iID;
+
+  if (_aSlots.Count() != 0) {
+    AffectSlot *pSlot = FindSlot(iClassID);
+    if (pSlot->bUsed) return pSlot->pAffect;
+  }
+
+  // Resolve classes from the config by name the first time they are encountered
+  FEntityAffect pAffect = NULL;
+
+  for (INDEX i = 0; i < _aClassNames.Count(); i++) {
+    if (_aClassNames[i].strClass == pdec->dec_strName) {
+      pAffect = _aClassNames[i].pAffect;
+      break;
+    }
+  }
+
+  // Remember the class even if it isn't affected
+  AddHandler(iClassID, pAffect);
+  return pAffect;
+};
+
+// Entity that's waiting to be affected
+struct AffectTarget {
+  CEntity *pen; // Referenced until it's affected
+  FEntityAffect pAffect; // NULL if replaying changes from a plan
+  INDEX iChange; // Replayed changes of this entity
+  INDEX ctChanges;
+  FLOAT fPriority; // Distance to the closest player marker
+};
+
+// Entities that are left to affect during a sliced pass
+static CStaticStackArray<AffectTarget> _aTargets;
+static INDEX _iNextTarget = 0;
+static INDEX _ctSliceTicks = 0;
+
+// Changes from a cached plan that are replayed instead of affecting entities
+static CStaticStackArray<EntityChange> _aReplay;
+static CStaticStackArray<EntityChange> _aReplayTick; // Replayed during the current tick
+static BOOL _bReplaying = FALSE;
+
+// Some entities have been removed before they could be affected
+static BOOL _bPassIncomplete = FALSE;
+
+// Affect pass statistics
+static INDEX _ctPassTicks = 0;
+static INDEX _ctPassEntities = 0;
+static DOUBLE _dPassTotal = 0.0;
+static DOUBLE _dPassWorst = 0.0;
+
+// Closest entities are affected first
+static int CompareTargets(const void *pElement1, const void *pElement2) {
+  const AffectTarget &at1 = *(const AffectTarget *)pElement1;
+  const AffectTarget &at2 = *(const AffectTarget *)pElement2;
+
+  if (at1.fPriority == at2.fPriority) return 0;
+  return (at1.fPriority < at2.fPriority) ? -1 : +1;
+};
+
+// Apply changes queued during this tick and measure its time
+static void FinishAffectTick(const CTimerValue &tvStart) {
+  if (_bReplaying) {
+    const INDEX ctReplayed = _aReplayTick.Count();
+    if (ctReplayed > 0) ApplyEntityChanges(_aReplayTick, ctReplayed, TRUE);
+
+    _aReplayTick.PopAll();
+
+  } else {
+    CStaticStackArray<EntityChange> aChanges;
+    const INDEX ctQueued = CollectEntityChanges(aChanges);
+
+    // Remember changes before any entities are destroyed
+    IAffectPlan::Record(aChanges);
+
+    if (ctQueued > 0) ApplyEntityChanges(aChanges, ctQueued, TRUE);
+  }
+
+  const DOUBLE dTick = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds();
+  _dPassTotal += dTick;
+  _dPassWorst = Max(_dPassWorst, dTick);
+  _ctPassTicks++;
+};
+
+// Store the plan of the finished affect pass and report its time
+static void FinishAffectPass(void) {
+  if (_bReplaying) {
+    _aReplay.PopAll();
+    _bReplaying = FALSE;
+
+  // Plan would be missing changes of removed entities
+  } else if (_bPassIncomplete) {
+    IAffectPlan::Discard();
+    CPutString(TRANS("Some entities have been removed before they could be affected, not storing the affect plan\n"));
+
+  } else {
+    IAffectPlan::Finish();
+  }
+
+  IAffectTable::ctAffectedAtLoad += _ctPassEntities;
+
+  CPrintF(TRANS("Affected %d entities over %d ticks: %.2f ms total, %.2f ms worst tick\n"),
+    _ctPassEntities, _ctPassTicks, _dPassTotal * 1000.0, _dPassWorst * 1000.0);
+};
+
+// Check if an entity is affected by an item handler, since items can be picked up right away
+static BOOL IsPickableTarget(const AffectTarget &at) {
+  // Replayed entities use handlers of their classes
+  FEntityAffect pAffect = (at.pAffect != NULL) ? at.pAffect : IAffectTable::FindHandler(at.pen);
+
+  return pAffect == &AffectWeaponItem || pAffect == &AffectAmmoItem
+      || pAffect == &AffectHealthItem || pAffect == &AffectArmorItem
+#if SE1_GAME != SS_TFE
+      || pAffect == &AffectPowerUpItem
+#endif
+  ;
+};
+
+// Queue entity to be affected during a sliced pass
+static void AddTarget(CEntity *pen, FEntityAffect pAffect, INDEX iChange, INDEX ctChanges, CStaticStackArray<FLOAT3D> &avMarkers) {
+  AffectTarget &at = _aTargets.Push();
+  at.pen = pen;
+  at.pAffect = pAffect;
+  at.iChange = iChange;
+  at.ctChanges = ctChanges;
+  at.fPriority = 0.0f;
+  pen->AddReference();
+
+  if (IsOfClassID(pen, CPlayerMarker_ClassID)) {
+    avMarkers.Push() = pen->GetPlacement().pl_PositionVector;
+  }
+};
+
+// Stop affecting entities of the current world without storing its plan
+void IAffectTable::Cancel(void) {
+  for (INDEX iTarget = _iNextTarget; iTarget < _aTargets.Count(); iTarget++) {
+    _aTargets[iTarget].pen->RemReference();
+  }
+
+  _aTargets.PopAll();
+  _iNextTarget = 0;
+
+  _aReplay.PopAll();
+  _aReplayTick.PopAll();
+  _bReplaying = FALSE;
+  _bPassIncomplete = FALSE;
+
+  IAffectPlan::Discard();
+};
+
+// Affect all entities in the current world
+void IAffectTable::AffectWorld(void) {
+  // Stop affecting the previous world
+  Cancel();
+
+  // Affect entities that will be spawned in this world
+  ISpawnedEntities::Reset(TRUE);
+
+  // Use current settings for this world
+  ResetAffectSettings();
+
+  const CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+  _ctPassTicks = 0;
+  _ctPassEntities = 0;
+  _dPassTotal = 0.0;
+  _dPassWorst = 0.0;
+
+  _ctSliceTicks = _psAffectTicks.GetIndex();
+
+  // Same world with the same settings has been affected before
+  _bReplaying = IAffectPlan::Replay(_aReplay);
+  if (!_bReplaying) _aReplay.PopAll();
+
+  // Replay everything at once
+  if (_ctSliceTicks <= 0 && _bReplaying) {
+    for (INDEX iChange = 0; iChange < _aReplay.Count(); iChange++) {
+      const EntityChange &ec = _aReplay[iChange];
+      if (iChange == 0 || ec.pen != _aReplay[iChange - 1].pen) _ctPassEntities++;
+
+      _aReplayTick.Push() = ec;
+    }
+
+    FinishAffectTick(tvStart);
+    FinishAffectPass();
+    return;
+  }
+
+  // Affect everything at once
+  if (_ctSliceTicks <= 0) {
+    FOREACHINDYNAMICCONTAINER(IWorld::GetWorld()->wo_cenEntities, CEntity, iten) {
+      CEntity *pen = iten;
+
+      FEntityAffect pAffect = FindHandler(pen);
+      if (pAffect == NULL) continue;
+
+      pAffect(pen);
+      _ctPassEntities++;
+    }
+
+    FinishAffectTick(tvStart);
+    FinishAffectPass();
+    return;
+  }
+
+  // Gather entities to affect over the next few ticks
+  CStaticStackArray<FLOAT3D> avMarkers;
+
+  if (_bReplaying) {
+    // Changes of each entity are replayed together
+    const INDEX ctChanges = _aReplay.Count();
+    INDEX iChange = 0;
+
+    while (iChange < ctChanges) {
+      INDEX iEnd = iChange + 1;
+
+      while (iEnd < ctChanges && _aReplay[iEnd].pen == _aReplay[iChange].pen) {
+        iEnd++;
+      }
+
+      AddTarget(_aReplay[iChange].pen, NULL, iChange, iEnd - iChange, avMarkers);
+      iChange = iEnd;
+    }
+
+  } else {
+    FOREACHINDYNAMICCONTAINER(IWorld::GetWorld()->wo_cenEntities, CEntity, iten) {
+      CEntity *pen = iten;
+
+      FEntityAffect pAffect = FindHandler(pen);
+      if (pAffect == NULL) continue;
+
+      AddTarget(pen, pAffect, 0, 0, avMarkers);
+    }
+  }
+
+  for (INDEX iTarget = 0; iTarget < _aTargets.Count(); iTarget++) {
+    AffectTarget &at = _aTargets[iTarget];
+
+    // Player markers determine starting inventory, so they go first
+    if (IsOfClassID(at.pen, CPlayerMarker_ClassID)) {
+      at.fPriority = -2.0f;
+      continue;
+    }
+
+    // Items must be affected before anyone can pick them up
+    if (IsPickableTarget(at)) {
+      at.fPriority = -1.0f;
+      continue;
+    }
+
+    const FLOAT3D &vPos = at.pen->GetPlacement().pl_PositionVector;
+    at.fPriority = UpperLimit(0.0f);
+
+    for (INDEX iMarker = 0; iMarker < avMarkers.Count(); iMarker++) {
+      at.fPriority = Min(at.fPriority, (vPos - avMarkers[iMarker]).ManhattanNorm());
+    }
+  }
+
+  // Nothing to spread over ticks
+  if (_aTargets.Count() == 0) {
+    FinishAffectTick(tvStart);
+    FinishAffectPass();
+    return;
+  }
+
+  qsort(&_aTargets[0], _aTargets.Count(), sizeof(AffectTarget), &CompareTargets);
+
+  // Affect the closest entities right away
+  AffectStep(tvStart);
+};
+
+// Continue affecting entities during a sliced pass and return TRUE when it's finished on this tick
+BOOL IAffectTable::AffectStep(const CTimerValue &tvStart) {
+  if (!IsAffecting()) return FALSE;
+
+  // Affect everything that's left on the last tick
+  const BOOL bLastTick = (--_ctSliceTicks <= 0);
+  const DOUBLE dBudget = _psAffectBudget.GetFloat() * 0.001;
+
+  INDEX ctThisTick = 0;
+
+  while (_iNextTarget < _aTargets.Count()) {
+    AffectTarget &at = _aTargets[_iNextTarget++];
+
+    // Entity could have been removed in the meantime
+    if (at.pen->GetFlags() & ENF_DELETED) {
+      _bPassIncomplete = TRUE;
+
+    } else if (at.pAffect != NULL) {
+      at.pAffect(at.pen);
+      _ctPassEntities++;
+
+    } else {
+      EntityChange *aec = _aReplayTick.Push(at.ctChanges);
+
+      for (INDEX iChange = 0; iChange < at.ctChanges; iChange++) {
+        aec[iChange] = _aReplay[at.iChange + iChange];
+      }
+
+      _ctPassEntities++;
+    }
+
+    at.pen->RemReference();
+    ctThisTick++;
+
+    // Check the time every few entities, but always affect player markers and items on the first tick
+    if (bLastTick || at.fPriority < 0.0f || (ctThisTick & 15) != 0) continue;
+
+    if ((_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds() >= dBudget) break;
+  }
+
+  FinishAffectTick(tvStart);
+
+  if (IsAffecting()) return FALSE;
+
+  _aTargets.PopAll();
+  _iNextTarget = 0;
+
+  FinishAffectPass();
+  return TRUE;
+};
+
+// Check if there are entities left to affect during a sliced pass
+BOOL IAffectTable::IsAffecting(void) {
+  return _iNextTarget < _aTargets.Count();
+};
+
+// Classify entities using a chain of class checks
+static INDEX ClassifyByChecks(CEntity **apen, INDEX ctEntities) {
+  INDEX ctAffected = 0;
+
+  for (INDEX i = 0; i < ctEntities; i++) {
+    CEntity *pen = apen[i];
+
+    if (IsOfClassID(pen, CWeaponItem_ClassID)
+     || IsOfClassID(pen, CAmmoItem_ClassID)
+     || IsOfClassID(pen, CHealthItem_ClassID)
+     || IsOfClassID(pen, CArmorItem_ClassID)
+  #if SE1_GAME != SS_TFE
+     || IsOfClassID(pen, CPowerUpItem_ClassID)
+  #endif
+     || IsOfClassID(pen, CPlayerMarker_ClassID)
+     || IsOfClassID(pen, CEnemySpawner_ClassID)) {
+      ctAffected++;
+    }
+  }
+
+  return ctAffected;
+};
+
+// Classify entities using the table
+static INDEX ClassifyByTable(CEntity **apen, INDEX ctEntities) {
+  INDEX ctAffected = 0;
+
+  for (INDEX i = 0; i < ctEntities; i++) {
+    if (IAffectTable::FindHandler(apen[i]) != NULL) ctAffected++;
+  }
+
+  return ctAffected;
+};
+
+// Compare entity classification using class checks and the table
+// Synthetic worlds repeat entities of the current world and handlers aren't executed
+void IAffectTable::Benchmark(void) {
+  CWorld *pwo = IWorld::GetWorld();
+  const INDEX ctWorld = (pwo != NULL) ? pwo->wo_cenEntities.Count() : 0;
+
+  if (ctWorld == 0) {
+    CPutString(TRANS("No entities in the world to benchmark with!\n"));
+    return;
+  }
+
+  static const INDEX actSizes[] = { 10000, 100000 };
+
+  CStaticArray<CEntity *> apen;
+  apen.New(actSizes[ARRAYCOUNT(actSizes) - 1]);
+
+  for (INDEX iFill = 0; iFill < apen.Count(); iFill++) {
+    apen[iFill] = pwo->wo_cenEntities.Pointer(iFill % ctWorld);
+  }
+
+  for (INDEX iSize = 0; iSize < ARRAYCOUNT(actSizes); iSize++) {
+    const INDEX ctEntities = actSizes[iSize];
+
+    CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+    const INDEX ctChecks = ClassifyByChecks(&apen[0], ctEntities);
+    const DOUBLE dChecks = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds();
+
+    tvStart = _pTimer->GetHighPrecisionTimer();
+    const INDEX ctTable = ClassifyByTable(&apen[0], ctEntities);
+    const DOUBLE dTable = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds();
+
+    CPrintF(TRANS("%d entities: class checks %.3f ms (%d affected), table %.3f ms (%d affected)\n"),
+      ctEntities, dChecks * 1000.0, ctChecks, dTable * 1000.0, ctTable);
+  }
+};
@@ -0,0 +1,60 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+// Function that affects an entity of some class at the beginning of the game
+typedef void (*FEntityAffect)(CEntity *pen);
+
+class IAffectTable {
+  public:
+    // Entities affected when their world has been loaded
+    static INDEX ctAffectedAtLoad;
+
+  public:
+    // Register built-in handlers for entity classes
+    static void RegisterDefault(void);
+
+    // Register handlers for modded entity classes from the plugin config
+    static void LoadConfig(CIniConfig &props);
+
+    // Add handlers from the config to some checksum
+    static void AddConfigToCRC(ULONG &ulCRC);
+
+    // Set handler for an entity class by its ID
+    static void AddHandler(INDEX iClassID, FEntityAffect pAffect);
+
+    // Set handler for an entity class by its name
+    static void AddClassHandler(const CTString &strClass, FEntityAffect pAffect);
+
+    // Find built-in handler by its name
+    static FEntityAffect HandlerByName(const CTString &strHandler);
+
+    // Find handler for an entity (NULL if its class isn't affected)
+    static FEntityAffect FindHandler(CEntity *pen);
+
+    // Stop affecting entities of the current world without storing its plan
+    static void Cancel(void);
+
+    // Affect all entities in the current world
+    static void AffectWorld(void);
+
+    // Continue affecting entities during a sliced pass and return TRUE when it's finished on this tick
+    static BOOL AffectStep(const CTimerValue &tvStart);
+
+    // Check if there are entities left to affect during a sliced pass
+    static BOOL IsAffecting(void);
+
+    // Compare entity classification using class checks and the table
+    static void Benchmark(void);
+};
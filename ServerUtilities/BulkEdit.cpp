@@ -0,0 +1,291 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "Sandbox.h"
+#include "BulkEdit.h"
+
+// Split string into words
+static void SplitWords(const CTString &str, CStringStack &astrWords) {
+  const char *pch = str.str_String;
+
+  while (*pch != '\0') {
+    // Skip spaces
+    while (*pch == ' ' || *pch == '\t') pch++;
+    if (*pch == '\0') break;
+
+    const char *pchStart = pch;
+    while (*pch != '\0' && *pch != ' ' && *pch != '\t') pch++;
+
+    CTString &strWord = astrWords.Push();
+    strWord = pchStart;
+    strWord.TrimRight(pch - pchStart);
+  }
+};
+
+// Parse property test in the form of "<name><operator><value>"
+static void ParsePropertyTest_t(const CTString &strTest, PropertyTest &test) {
+  static const char *astrOperators[] = { "!=", "=", "<", ">" };
+  static const EQueryOperator aeOperators[] = { E_QO_NOTEQUAL, E_QO_EQUAL, E_QO_LESS, E_QO_GREATER };
+
+  for (INDEX iOperator = 0; iOperator < ARRAYCOUNT(astrOperators); iOperator++) {
+    const char *pchOperator = strstr(strTest.str_String, astrOperators[iOperator]);
+    if (pchOperator == NULL) continue;
+
+    test.strProperty = strTest;
+    test.strProperty.TrimRight(pchOperator - strTest.str_String);
+    test.eOperator = aeOperators[iOperator];
+    test.strValue = pchOperator + strlen(astrOperators[iOperator]);
+    test.fValue = atof(test.strValue.str_String);
+    return;
+  }
+
+  ThrowF_t(TRANS("No comparison operator in '%s'"), strTest.str_String);
+};
+
+// Parse entity query from conditions separated by spaces:
+// class=<name> name=<pattern> area=<x1>,<y1>,<z1>,<x2>,<y2>,<z2> prop:<name><=|!=|<|><value>
+static void ParseQuery_t(const CTString &strQuery, EntityQuery &query) {
+  query.strClass = "";
+  query.strName = "";
+  query.bArea = FALSE;
+  query.aTests.PopAll();
+
+  CStringStack astrWords;
+  SplitWords(strQuery, astrWords);
+
+  for (INDEX iWord = 0; iWord < astrWords.Count(); iWord++) {
+    CTString strWord = astrWords[iWord];
+
+    if (strWord.RemovePrefix("class=")) {
+      query.strClass = strWord;
+
+    } else if (strWord.RemovePrefix("name=")) {
+      query.strName = strWord;
+
+    } else if (strWord.RemovePrefix("area=")) {
+      FLOAT3D v1, v2;
+
+      if (strWord.ScanF("%g,%g,%g,%g,%g,%g", &v1(1), &v1(2), &v1(3), &v2(1), &v2(2), &v2(3)) != 6) {
+        ThrowF_t(TRANS("Expected six coordinates for the area"));
+      }
+
+      query.boxArea = FLOATaabbox3D(v1, v2);
+      query.bArea = TRUE;
+
+    } else if (strWord.RemovePrefix("prop:")) {
+      ParsePropertyTest_t(strWord, query.aTests.Push());
+
+    } else {
+      ThrowF_t(TRANS("Unknown condition '%s'"), strWord.str_String);
+    }
+  }
+};
+
+// Parse action in one of the forms:
+// delete | init | move <x>,<y>,<z> | set <property> <value>
+static void ParseAction_t(const CTString &strAction, BulkAction &action) {
+  CStringStack astrWords;
+  SplitWords(strAction, astrWords);
+
+  const INDEX ctWords = astrWords.Count();
+  const CTString strVerb = (ctWords > 0) ? astrWords[0] : CTString("");
+
+  if (strVerb == "delete" && ctWords == 1) {
+    action.eAction = E_BA_DELETE;
+
+  } else if (strVerb == "init" && ctWords == 1) {
+    action.eAction = E_BA_INIT;
+
+  } else if (strVerb == "move" && ctWords == 2) {
+    action.eAction = E_BA_MOVE;
+
+    if (astrWords[1].ScanF("%g,%g,%g", &action.vOffset(1), &action.vOffset(2), &action.vOffset(3)) != 3) {
+      ThrowF_t(TRANS("Expected three coordinates for the offset"));
+    }
+
+  } else if (strVerb == "set" && ctWords >= 3) {
+    action.eAction = E_BA_SET;
+    action.strProperty = astrWords[1];
+
+    // Value may contain spaces
+    action.strValue = astrWords[2];
+
+    for (INDEX iWord = 3; iWord < ctWords; iWord++) {
+      action.strValue += " " + astrWords[iWord];
+    }
+
+  } else {
+    ThrowF_t(TRANS("Invalid action '%s'"), strAction.str_String);
+  }
+};
+
+// Compare two values using some operator
+template<class Type> static BOOL CompareValues(const Type &val1, const Type &val2, EQueryOperator eOperator) {
+  switch (eOperator) {
+    case E_QO_EQUAL:    return val1 == val2;
+    case E_QO_NOTEQUAL: return !(val1 == val2);
+    case E_QO_LESS:     return val1 < val2;
+    case E_QO_GREATER:  return val2 < val1;
+  }
+
+  return FALSE;
+};
+
+// Check property of an entity
+static BOOL TestProperty(CEntity *pen, const PropertyTest &test) {
+  CEntityProperty *pep = pen->PropertyForName(test.strProperty);
+  if (pep == NULL) return FALSE;
+
+  switch (IProperties::ConvertType(pep->ep_eptType)) {
+    case CEntityProperty::EPT_INDEX: {
+      const INDEX iValue = ENTITYPROPERTY(pen, pep->ep_slOffset, INDEX);
+      return CompareValues<DOUBLE>(iValue, test.fValue, test.eOperator);
+    }
+
+    case CEntityProperty::EPT_FLOAT: {
+      const FLOAT fValue = ENTITYPROPERTY(pen, pep->ep_slOffset, FLOAT);
+      return CompareValues<DOUBLE>(fValue, test.fValue, test.eOperator);
+    }
+
+    case CEntityProperty::EPT_STRING: {
+      const CTString &strValue = ENTITYPROPERTY(pen, pep->ep_slOffset, CTString);
+      return CompareValues<INDEX>(strcmp(strValue.str_String, test.strValue.str_String), 0, test.eOperator);
+    }
+  }
+
+  return FALSE;
+};
+
+// Check if an entity meets all conditions of a query
+static BOOL MatchEntity(CEntity *pen, const EntityQuery &query) {
+  if (query.strClass != "" && query.strClass != pen->GetClass()->ec_pdecDLLClass->dec_strName) return FALSE;
+
+  if (query.strName != "" && !pen->GetName().Matches(query.strName)) return FALSE;
+
+  if (query.bArea && !query.boxArea.HasContactWith(pen->GetPlacement().pl_PositionVector)) return FALSE;
+
+  for (INDEX iTest = 0; iTest < query.aTests.Count(); iTest++) {
+    if (!TestProperty(pen, query.aTests[iTest])) return FALSE;
+  }
+
+  return TRUE;
+};
+
+// Apply action to one entity
+static BOOL ApplyAction(CEntity *pen, const BulkAction &action) {
+  switch (action.eAction) {
+    case E_BA_DELETE:
+      pen->Destroy();
+      return TRUE;
+
+    case E_BA_INIT:
+      // Reinitialize if some render type has already been set
+      if (pen->GetRenderType() == CEntity::RT_NONE) {
+        pen->Initialize();
+      } else {
+        pen->Reinitialize();
+      }
+      return TRUE;
+
+    case E_BA_MOVE: {
+      CPlacement3D plEntity = pen->GetPlacement();
+      plEntity.pl_PositionVector += action.vOffset;
+
+      pen->Teleport(plEntity, FALSE);
+    } return TRUE;
+
+    case E_BA_SET:
+      return IServerSandbox::SetPropertyValue(pen, action.strProperty, action.strValue);
+  }
+
+  return FALSE;
+};
+
+// Parse query and action of a bulk edit
+void ParseBulkEdit_t(const CTString &strQuery, const CTString &strAction, SandboxBulkEdit &bulk) {
+  ParseQuery_t(strQuery, bulk.query);
+  ParseAction_t(strAction, bulk.action);
+};
+
+// Apply an action to all entities that match a query
+void ApplyBulkEdit(const SandboxBulkEdit &bulk) {
+  const EntityQuery &query = bulk.query;
+  const BulkAction &action = bulk.action;
+
+  // Select all entities in one pass before changing any of them
+  CDynamicContainer<CEntity> cenSelected;
+
+  FOREACHINDYNAMICCONTAINER(IWorld::GetWorld()->wo_cenEntities, CEntity, iten) {
+    CEntity *pen = iten;
+
+    if (!(pen->GetFlags() & ENF_DELETED) && MatchEntity(pen, query)) {
+      cenSelected.Add(pen);
+      pen->AddReference();
+    }
+  }
+
+  INDEX ctApplied = 0;
+
+  FOREACHINDYNAMICCONTAINER(cenSelected, CEntity, itenSelected) {
+    CEntity *pen = itenSelected;
+
+    // Could've been destroyed along with another selected entity
+    if (pen->GetFlags() & ENF_DELETED) continue;
+
+    if (ApplyAction(pen, action)) ctApplied++;
+  }
+
+  // Selected entities are referenced until the action is applied to all of them
+  FOREACHINDYNAMICCONTAINER(cenSelected, CEntity, itenRelease) {
+    itenRelease->RemReference();
+  }
+
+  CPrintF(TRANS("Bulk edit: %d entities selected, action applied to %d\n"), cenSelected.Count(), ctApplied);
+};
+
+// Apply an action to all entities that match a query
+void IServerSandbox::BulkEdit(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const CTString &strQuery = *NEXT_ARG(CTString *);
+  const CTString &strAction = *NEXT_ARG(CTString *);
+
+  // Check the command before scheduling it
+  SandboxBulkEdit *pBulk = new SandboxBulkEdit;
+
+  try {
+    ParseBulkEdit_t(strQuery, strAction, *pBulk);
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Invalid bulk edit: %s\n"), strError);
+    delete pBulk;
+    return;
+  }
+
+  // Schedule the command before the game starts
+  if (!_pNetwork->IsServer()) {
+    SandboxRecord rec = NewRecord(E_SBO_BULK, -1);
+    rec.strArg1 = strQuery;
+    rec.strArg2 = strAction;
+    rec.pBulk = pBulk;
+
+    ScheduleRecord(rec);
+    return;
+  }
+
+  ApplyBulkEdit(*pBulk);
+  delete pBulk;
+};
@@ -0,0 +1,66 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+// Comparison of a property value
+enum EQueryOperator {
+  E_QO_EQUAL,
+  E_QO_NOTEQUAL,
+  E_QO_LESS,
+  E_QO_GREATER,
+};
+
+// Check of some entity property
+struct PropertyTest {
+  CTString strProperty;
+  EQueryOperator eOperator;
+  CTString strValue;
+  DOUBLE fValue;
+};
+
+// Conditions that entities need to meet
+struct EntityQuery {
+  CTString strClass;
+  CTString strName;
+  BOOL bArea;
+  FLOATaabbox3D boxArea;
+  CStaticStackArray<PropertyTest> aTests;
+};
+
+// Action applied to all selected entities
+enum EBulkAction {
+  E_BA_DELETE,
+  E_BA_INIT,
+  E_BA_MOVE,
+  E_BA_SET,
+};
+
+struct BulkAction {
+  EBulkAction eAction;
+  FLOAT3D vOffset;
+  CTString strProperty;
+  CTString strValue;
+};
+
+// Parsed query and action of a bulk edit
+struct SandboxBulkEdit {
+  EntityQuery query;
+  BulkAction action;
+};
+
+// Parse query and action of a bulk edit
+void ParseBulkEdit_t(const CTString &strQuery, const CTString &strAction, SandboxBulkEdit &bulk);
+
+// Apply an action to all entities that match a query
+void ApplyBulkEdit(const SandboxBulkEdit &bulk);
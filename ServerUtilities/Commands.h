@@ -28,6 +28,14 @@ extern CPluginSymbol _psStartHP;
 extern CPluginSymbol _psStartAR;
 extern CPluginSymbol _psEnemyMul;
 
+// Affect pass settings
+extern CPluginSymbol _psAffectTicks;
+extern CPluginSymbol _psAffectBudget;
+extern CPluginSymbol _psAffectSpawned;
+
+// Sandbox settings
+extern CPluginSymbol _psLevelEdits;
+
 // Weapon settings
 extern CPluginSymbol _psMaxAmmo;
 extern CPluginSymbol _apsGiveWeapons[CT_WEAPONS];
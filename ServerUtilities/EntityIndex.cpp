@@ -0,0 +1,248 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "EntityIndex.h"
+
+// Entity of the world under its ID
+struct EntityIndexSlot {
+  ULONG ulID;
+  CEntity *pen; // NULL if the slot is empty
+};
+
+// Slots with open addressing (power of two)
+static CStaticArray<EntityIndexSlot> _aSlots;
+static INDEX _ctUsed = 0;
+
+// World that's been indexed and its next entity ID up to which all entities are indexed
+static CWorld *_pwoIndexed = NULL;
+static ULONG _ulIndexedNextID = 0;
+
+// Starting slot for some ID
+static inline INDEX SlotForID(ULONG ulID) {
+  return (ulID * 2654435761UL) & (_aSlots.Count() - 1);
+};
+
+// Next slot after some slot
+static inline INDEX NextSlot(INDEX iSlot) {
+  return (iSlot + 1) & (_aSlots.Count() - 1);
+};
+
+// Find slot of some ID (-1 if it's not indexed)
+static INDEX FindSlot(ULONG ulID) {
+  INDEX iSlot = SlotForID(ulID);
+
+  while (_aSlots[iSlot].pen != NULL) {
+    if (_aSlots[iSlot].ulID == ulID) return iSlot;
+    iSlot = NextSlot(iSlot);
+  }
+
+  return -1;
+};
+
+// Put entity into a free slot or replace the one under the same ID
+static void InsertEntity(CEntity *pen) {
+  const ULONG ulID = pen->en_ulID;
+  INDEX iSlot = SlotForID(ulID);
+
+  while (_aSlots[iSlot].pen != NULL) {
+    if (_aSlots[iSlot].ulID == ulID) {
+      _aSlots[iSlot].pen = pen;
+      return;
+    }
+
+    iSlot = NextSlot(iSlot);
+  }
+
+  _aSlots[iSlot].ulID = ulID;
+  _aSlots[iSlot].pen = pen;
+  _ctUsed++;
+};
+
+// Index entities of the current world
+static void RebuildIndex(CWorld *pwo) {
+  CDynamicContainer<CEntity> &cen = pwo->wo_cenEntities;
+  const INDEX ctEntities = cen.Count();
+
+  // Keep it at most half full with some room for new entities
+  INDEX ctSlots = 1024;
+  while (ctSlots < ctEntities * 2 + 2) ctSlots <<= 1;
+
+  if (_aSlots.Count() != ctSlots) {
+    _aSlots.Clear();
+    _aSlots.New(ctSlots);
+  }
+
+  for (INDEX iSlot = 0; iSlot < ctSlots; iSlot++) {
+    _aSlots[iSlot].pen = NULL;
+  }
+
+  _ctUsed = 0;
+
+  FOREACHINDYNAMICCONTAINER(cen, CEntity, iten) {
+    CEntity *pen = iten;
+    if (!(pen->GetFlags() & ENF_DELETED)) InsertEntity(pen);
+  }
+
+  _pwoIndexed = pwo;
+  _ulIndexedNextID = pwo->wo_ulNextEntityID;
+};
+
+// Find entity in the current world by its ID
+CEntity *IEntityIndex::Find(ULONG ulID) {
+  CWorld *pwo = IWorld::GetWorld();
+  if (pwo == NULL) return NULL;
+
+  if (pwo != _pwoIndexed) RebuildIndex(pwo);
+
+  INDEX iSlot = FindSlot(ulID);
+
+  // Entities could've been created without being initialized since the world has been indexed
+  if (iSlot == -1 && pwo->wo_ulNextEntityID != _ulIndexedNextID) {
+    RebuildIndex(pwo);
+    iSlot = FindSlot(ulID);
+  }
+
+  return (iSlot != -1) ? _aSlots[iSlot].pen : NULL;
+};
+
+// Add initialized entity to the index
+void IEntityIndex::Add(CEntity *pen) {
+  if (_pwoIndexed == NULL || pen->GetWorld() != _pwoIndexed) return;
+
+  // Grow the index, which also adds the entity
+  if ((_ctUsed + 1) * 2 > _aSlots.Count()) {
+    RebuildIndex(_pwoIndexed);
+    return;
+  }
+
+  InsertEntity(pen);
+
+  // Entities are usually initialized right after being created
+  if (pen->en_ulID == _ulIndexedNextID) _ulIndexedNextID++;
+};
+
+// Remove entity that's being destroyed from the index
+void IEntityIndex::Remove(CEntity *pen) {
+  if (_pwoIndexed == NULL || pen->GetWorld() != _pwoIndexed) return;
+
+  INDEX iHole = FindSlot(pen->en_ulID);
+  if (iHole == -1 || _aSlots[iHole].pen != pen) return;
+
+  // Shift following entities back, so lookups don't stop at the emptied slot
+  INDEX iSlot = NextSlot(iHole);
+  const INDEX iMask = _aSlots.Count() - 1;
+
+  while (_aSlots[iSlot].pen != NULL) {
+    const INDEX iHome = SlotForID(_aSlots[iSlot].ulID);
+
+    // Move it only if the emptied slot is between its starting slot and the current one
+    if (((iSlot - iHome) & iMask) >= ((iSlot - iHole) & iMask)) {
+      _aSlots[iHole] = _aSlots[iSlot];
+      iHole = iSlot;
+    }
+
+    iSlot = NextSlot(iSlot);
+  }
+
+  _aSlots[iHole].pen = NULL;
+  _ctUsed--;
+};
+
+// Rebuild the index on the next lookup
+void IEntityIndex::Reset(void) {
+  _pwoIndexed = NULL;
+};
+
+// Compare entity lookups through the world and through the index while replaying a schedule of edits
+// Every third edit is a deletion, which is only simulated on both sides, so the same entities are found by each
+void IEntityIndex::Benchmark(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const INDEX ctEdits = NEXT_ARG(INDEX);
+
+  CWorld *pwo = IWorld::GetWorld();
+  const INDEX ctEntities = (pwo != NULL) ? pwo->wo_cenEntities.Count() : 0;
+
+  if (ctEntities == 0 || ctEdits <= 0) {
+    CPutString(TRANS("No entities in the world to benchmark with!\n"));
+    return;
+  }
+
+  // Edit entities spread across the whole world
+  CStaticArray<INDEX> aiEntities;
+  CStaticArray<ULONG> aulIDs;
+  aiEntities.New(ctEdits);
+  aulIDs.New(ctEdits);
+
+  INDEX i;
+
+  for (i = 0; i < ctEdits; i++) {
+    aiEntities[i] = (i * 7919) % ctEntities;
+    aulIDs[i] = pwo->wo_cenEntities.Pointer(aiEntities[i])->en_ulID;
+  }
+
+  // Entities deleted from the world during the schedule
+  CStaticArray<BOOL> abDeleted;
+  abDeleted.New(ctEntities);
+
+  for (i = 0; i < ctEntities; i++) {
+    abDeleted[i] = FALSE;
+  }
+
+  INDEX ctFoundWorld = 0;
+  INDEX ctFoundIndex = 0;
+
+  CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+
+  for (i = 0; i < ctEdits; i++) {
+    CEntity *pen = IWorld::FindEntityByID(pwo, aulIDs[i]);
+    if (pen == NULL || abDeleted[aiEntities[i]]) continue;
+
+    ctFoundWorld++;
+
+    if (i % 3 == 0) abDeleted[aiEntities[i]] = TRUE;
+  }
+
+  const DOUBLE dWorld = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds();
+
+  // Include building the index
+  CDynamicContainer<CEntity> cenRemoved;
+
+  Reset();
+  tvStart = _pTimer->GetHighPrecisionTimer();
+
+  for (i = 0; i < ctEdits; i++) {
+    CEntity *pen = Find(aulIDs[i]);
+    if (pen == NULL) continue;
+
+    ctFoundIndex++;
+
+    if (i % 3 == 0) {
+      Remove(pen);
+      cenRemoved.Add(pen);
+    }
+  }
+
+  const DOUBLE dIndex = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds();
+
+  // Put entities back
+  FOREACHINDYNAMICCONTAINER(cenRemoved, CEntity, itenRemoved) {
+    InsertEntity(itenRemoved);
+  }
+
+  CPrintF(TRANS("%d edits among %d entities (%d deletions): world %.3f ms (%d found), index %.3f ms (%d found)\n"),
+    ctEdits, ctEntities, cenRemoved.Count(), dWorld * 1000.0, ctFoundWorld, dIndex * 1000.0, ctFoundIndex);
+};
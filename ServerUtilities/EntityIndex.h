@@ -0,0 +1,32 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+class IEntityIndex {
+  public:
+    // Find entity in the current world by its ID
+    static CEntity *Find(ULONG ulID);
+
+    // Add initialized entity to the index
+    static void Add(CEntity *pen);
+
+    // Remove entity that's being destroyed from the index
+    static void Remove(CEntity *pen);
+
+    // Rebuild the index on the next lookup
+    static void Reset(void);
+
+    // Compare entity lookups through the world and through the index while replaying a schedule of edits
+    static void Benchmark(SHELL_FUNC_ARGS);
+};
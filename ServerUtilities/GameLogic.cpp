@@ -17,78 +17,85 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "StartActions.h"
 #include "Sandbox.h"
+#include "AffectTable.h"
+#include "AffectPlan.h"
+#include "SpawnedEntities.h"
+#include "EntityIndex.h"
+#include "SandboxEdits.h"
 
 #include <CoreLib/Networking/MessageProcessing.h>
 
-#include <EntitiesV/StdH/StdH.h>
-#include <EntitiesV/AmmoItem.h>
-#include <EntitiesV/ArmorItem.h>
-#include <EntitiesV/HealthItem.h>
-#if SE1_GAME != SS_TFE
-  #include <EntitiesV/PowerUpItem.h>
-#endif
-#include <EntitiesV/WeaponItem.h>
-#include <EntitiesV/EnemySpawner.h>
-#include <EntitiesV/PlayerMarker.h>
+// Level edits and scheduled commands are waiting for a sliced affect pass to finish
+static BOOL _bEditsPending = FALSE;
+static BOOL _bScheduledPending = FALSE;
 
-// Affect entities at the beginning of the game
-static void AffectEntities(void) {
-  FOREACHINDYNAMICCONTAINER(IWorld::GetWorld()->wo_cenEntities, CEntity, iten) {
-    CEntity *pen = iten;
-
-    if (IsOfClassID(pen, CWeaponItem_ClassID)) {
-      AffectWeaponItem(pen);
-
-    } else if (IsOfClassID(pen, CAmmoItem_ClassID)) {
-      AffectAmmoItem(pen);
-
-    } else if (IsOfClassID(pen, CHealthItem_ClassID)) {
-      AffectHealthItem(pen);
-
-    } else if (IsOfClassID(pen, CArmorItem_ClassID)) {
-      AffectArmorItem(pen);
+void IGameEvents_OnGameStart(void)
+{
+  // Index entities of the new world
+  IEntityIndex::Reset();
+  IAffectPlan::ResetWorldCRC();
 
-  #if SE1_GAME != SS_TFE
-    } else if (IsOfClassID(pen, CPowerUpItem_ClassID)) {
-      AffectPowerUpItem(pen);
-  #endif
+  IAffectTable::AffectWorld();
 
-    } else if (IsOfClassID(pen, CPlayerMarker_ClassID)) {
-      AffectPlayerMarker(pen);
+  // Commands should be executed over affected entities
+  _bScheduledPending = IAffectTable::IsAffecting();
+  _bEditsPending = _bScheduledPending;
 
-    } else if (IsOfClassID(pen, CEnemySpawner_ClassID)) {
-      AffectEnemySpawner(pen);
-    }
+  if (!_bScheduledPending) {
+    ISandboxEdits::ApplyCurrentLevel();
+    IServerSandbox::ExecuteScheduled();
   }
 };
 
-void IGameEvents_OnGameStart(void)
+void IGameEvents_OnChangeLevel(void)
 {
-  AffectEntities();
+  // Scheduled commands were meant for the previous level
+  _bScheduledPending = FALSE;
+  _bEditsPending = FALSE;
+  IEntityIndex::Reset();
+  IAffectPlan::ResetWorldCRC();
 
-  // Execute all scheduled commands
-  CStringStack &astrCommands = IServerSandbox::astrScheduled;
+  // Entities of the previous level won't be affected anymore
+  IAffectTable::Cancel();
+
+  // Entities of the new level will be tracked only if it's affected
+  ISpawnedEntities::Reset(FALSE);
+
+  // Affect entities on a new level (if singleplayer/split screen or patch-exclusive)
+  const BOOL bLocal = !_pNetwork->IsNetworkEnabled();
+  const BOOL bExclusive = (IProcessPacket::_bForbidVanilla || IProcessPacket::GameplayExtEnabled());
 
-  if (astrCommands.Count() > 0) {
-    CPrintF(TRANS("Executing scheduled sandbox commands...\n"));
+  if (!_pNetwork->IsServer()) return;
 
-    CTString strExecute = "";
+  if (bLocal || bExclusive) {
+    IAffectTable::AffectWorld();
+  }
 
-    for (INDEX iCommand = 0; iCommand < astrCommands.Count(); iCommand++) {
-      strExecute += astrCommands[iCommand];
-    }
+  // Edits of the new level should be applied over affected entities
+  _bEditsPending = IAffectTable::IsAffecting();
 
-    _pShell->Execute(strExecute);
+  if (!_bEditsPending) {
+    ISandboxEdits::ApplyCurrentLevel();
   }
 };
 
-void IGameEvents_OnChangeLevel(void)
+void IProcessingEvents_OnStep(void)
 {
-  // Affect entities on a new level (if singleplayer/split screen or patch-exclusive)
-  const BOOL bLocal = !_pNetwork->IsNetworkEnabled();
-  const BOOL bExclusive = (IProcessPacket::_bForbidVanilla || IProcessPacket::GameplayExtEnabled());
+  if (!_pNetwork->IsServer()) return;
+
+  // Continue affecting entities over multiple ticks
+  if (IAffectTable::AffectStep(_pTimer->GetHighPrecisionTimer())) {
+    if (_bEditsPending) {
+      _bEditsPending = FALSE;
+      ISandboxEdits::ApplyCurrentLevel();
+    }
 
-  if (_pNetwork->IsServer() && (bLocal || bExclusive)) {
-    AffectEntities();
+    if (_bScheduledPending) {
+      _bScheduledPending = FALSE;
+      IServerSandbox::ExecuteScheduled();
+    }
   }
+
+  // Affect entities spawned during the last tick
+  ISpawnedEntities::Flush();
 };
@@ -16,6 +16,12 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "StdH.h"
 
 #include "Sandbox.h"
+#include "StartActions.h"
+#include "AffectTable.h"
+#include "AffectPlan.h"
+#include "SpawnedEntities.h"
+#include "EntityIndex.h"
+#include "SandboxEdits.h"
 
 // Define plugin
 CLASSICSPATCH_DEFINE_PLUGIN(k_EPluginFlagGame | k_EPluginFlagServer, CORE_PATCH_VERSION,
@@ -33,6 +39,14 @@ CPluginSymbol _psStartHP(SSF_PERSISTENT | SSF_USER, 100.0f);
 CPluginSymbol _psStartAR(SSF_PERSISTENT | SSF_USER, 0.0f);
 CPluginSymbol _psEnemyMul(SSF_PERSISTENT | SSF_USER, 1.0f);
 
+// Affect pass settings
+CPluginSymbol _psAffectTicks(SSF_PERSISTENT | SSF_USER, INDEX(0)); // Spread over this many ticks (0 = all at once; items are always affected on the first tick)
+CPluginSymbol _psAffectBudget(SSF_PERSISTENT | SSF_USER, 2.0f); // Time limit per tick in milliseconds
+CPluginSymbol _psAffectSpawned(SSF_PERSISTENT | SSF_USER, INDEX(TRUE)); // Affect entities spawned after the world loads
+
+// Sandbox settings
+CPluginSymbol _psLevelEdits(SSF_PERSISTENT | SSF_USER, INDEX(TRUE)); // Apply saved edits on level start
+
 // Weapon settings
 CPluginSymbol _psMaxAmmo(SSF_PERSISTENT | SSF_USER, INDEX(FALSE));
 
@@ -97,10 +111,17 @@ CLASSICSPATCH_PLUGIN_STARTUP(CIniConfig &props, PluginEvents_t &events)
   events.m_game->OnGameStart   = &IGameEvents_OnGameStart;
   events.m_game->OnChangeLevel = &IGameEvents_OnChangeLevel;
 
+  events.m_processing->OnStep = &IProcessingEvents_OnStep;
+
   events.m_packet->OnCharacterConnect = &IPacketEvents_OnCharacterConnect;
   events.m_packet->OnCharacterChange  = &IPacketEvents_OnCharacterChange;
   events.m_packet->OnPlayerAction     = &IPacketEvents_OnPlayerAction;
 
+  // Entity classes to affect at the beginning of the game
+  IAffectTable::RegisterDefault();
+  IAffectTable::LoadConfig(props);
+  ISpawnedEntities::Initialize();
+
   // Custom symbols
   {
     // Server settings
@@ -112,6 +133,14 @@ CLASSICSPATCH_PLUGIN_STARTUP(CIniConfig &props, PluginEvents_t &events)
     _psStartAR.Register("sutl_fStartArmor");
     _psEnemyMul.Register("sutl_fEnemyMultiplier");
 
+    // Affect pass settings
+    _psAffectTicks.Register("sutl_iAffectTicks");
+    _psAffectBudget.Register("sutl_fAffectBudget");
+    _psAffectSpawned.Register("sutl_bAffectSpawned");
+
+    // Sandbox settings
+    _psLevelEdits.Register("sutl_bLevelEdits");
+
     // Weapon settings
     _psMaxAmmo.Register("sutl_bMaxAmmo");
 
@@ -147,9 +176,14 @@ CLASSICSPATCH_PLUGIN_STARTUP(CIniConfig &props, PluginEvents_t &events)
     _psReplaceHealth.Register("sutl_iReplaceHealth");
     _psReplaceArmor.Register("sutl_iReplaceArmor");
 
+    GetPluginAPI()->RegisterMethod(TRUE, "void", "sutl_BenchmarkAffect", "void", &IAffectTable::Benchmark);
+    GetPluginAPI()->RegisterMethod(TRUE, "void", "sutl_ReportAffected",  "void", &ISpawnedEntities::ReportAffected);
+
     // Server sandbox commands
     GetPluginAPI()->RegisterMethod(TRUE, "void", "sutl_ListScheduledCommands",  "void", &IServerSandbox::ListScheduledCommands);
     GetPluginAPI()->RegisterMethod(TRUE, "void", "sutl_ClearScheduledCommands", "void", &IServerSandbox::ClearScheduledCommands);
+    GetPluginAPI()->RegisterMethod(TRUE, "void", "sutl_SaveLevelEdits",         "CTString", &ISandboxEdits::SaveLevelEdits);
+    GetPluginAPI()->RegisterMethod(TRUE, "void", "sutl_LoadLevelEdits",         "CTString", &ISandboxEdits::LoadLevelEdits);
 
     GetPluginAPI()->RegisterMethod(TRUE, "void", "sutl_DeleteEntity",      "INDEX",                      &IServerSandbox::DeleteEntity);
     GetPluginAPI()->RegisterMethod(TRUE, "void", "sutl_InitEntity",        "INDEX",                      &IServerSandbox::InitEntity);
@@ -157,10 +191,14 @@ CLASSICSPATCH_PLUGIN_STARTUP(CIniConfig &props, PluginEvents_t &events)
     GetPluginAPI()->RegisterMethod(TRUE, "void", "sutl_SetEntityRotation", "INDEX, FLOAT, FLOAT, FLOAT", &IServerSandbox::SetEntityRotation);
     GetPluginAPI()->RegisterMethod(TRUE, "void", "sutl_SetEntityProperty", "INDEX, CTString, CTString",  &IServerSandbox::SetEntityProperty);
     GetPluginAPI()->RegisterMethod(TRUE, "void", "sutl_ParentEntity",      "INDEX, INDEX",               &IServerSandbox::ParentEntity);
+    GetPluginAPI()->RegisterMethod(TRUE, "void", "sutl_BulkEdit",          "CTString, CTString",         &IServerSandbox::BulkEdit);
+
+    GetPluginAPI()->RegisterMethod(TRUE, "void", "sutl_BenchmarkEntityIndex", "INDEX", &IEntityIndex::Benchmark);
   }
 };
 
 // Module cleanup
 CLASSICSPATCH_PLUGIN_SHUTDOWN(CIniConfig &props)
 {
+  IAffectPlan::ClearCache();
 };
@@ -16,37 +16,108 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "StdH.h"
 
 #include "Sandbox.h"
+#include "EntityIndex.h"
+#include "BulkEdit.h"
+
+// Commands scheduled to be executed after the world loads
+CStaticStackArray<SandboxRecord> IServerSandbox::aScheduled;
+
+// Level whose saved edits have been loaded into scheduled commands
+CTFileName IServerSandbox::fnmLoadedEdits;
+
+// Print record as a shell command
+CTString SandboxRecord::ToCommand(void) const {
+  CTString strCommand;
+
+  switch (eOperation) {
+    case E_SBO_DELETE:   strCommand.PrintF("sutl_DeleteEntity(%d);", iEntity); break;
+    case E_SBO_INIT:     strCommand.PrintF("sutl_InitEntity(%d);", iEntity); break;
+    case E_SBO_POSITION: strCommand.PrintF("sutl_SetEntityPosition(%d, %f, %f, %f);", iEntity, vValue(1), vValue(2), vValue(3)); break;
+    case E_SBO_ROTATION: strCommand.PrintF("sutl_SetEntityRotation(%d, %f, %f, %f);", iEntity, vValue(1), vValue(2), vValue(3)); break;
+    case E_SBO_PROPERTY: strCommand.PrintF("sutl_SetEntityProperty(%d, \"%s\", \"%s\");", iEntity, strArg1, strArg2); break;
+    case E_SBO_PARENT:   strCommand.PrintF("sutl_ParentEntity(%d, %d);", iEntity, iOther); break;
+    case E_SBO_BULK:     strCommand.PrintF("sutl_BulkEdit(\"%s\", \"%s\");", strArg1, strArg2); break;
+  }
 
-// Scheduled commands to be executed after the world loads
-CStringStack IServerSandbox::astrScheduled;
+  return strCommand;
+};
 
 // Schedule one command
-void IServerSandbox::ScheduleCommand(const CTString &strCommand) {
+void IServerSandbox::ScheduleRecord(const SandboxRecord &rec) {
   CPutString(TRANS("Scheduled command for the server:\n"));
-  CPrintF("  %s\n", strCommand);
+  CPrintF("  %s\n", rec.ToCommand());
+
+  aScheduled.Push() = rec;
+};
+
+// Start a new record for some operation
+SandboxRecord IServerSandbox::NewRecord(ESandboxOperation eOperation, INDEX iEntity) {
+  SandboxRecord rec;
+  rec.eOperation = eOperation;
+  rec.iEntity = iEntity;
+  rec.iOther = -1;
+  rec.vValue = FLOAT3D(0, 0, 0);
+  rec.pBulk = NULL;
+  return rec;
+};
+
+// Execute one scheduled command without going through the shell
+void IServerSandbox::ExecuteRecord(const SandboxRecord &rec) {
+  switch (rec.eOperation) {
+    case E_SBO_DELETE:   DoDeleteEntity(rec.iEntity); break;
+    case E_SBO_INIT:     DoInitEntity(rec.iEntity); break;
+    case E_SBO_POSITION: DoSetEntityPosition(rec.iEntity, rec.vValue); break;
+    case E_SBO_ROTATION: DoSetEntityRotation(rec.iEntity, rec.vValue); break;
+    case E_SBO_PROPERTY: DoSetEntityProperty(rec.iEntity, rec.strArg1, rec.strArg2); break;
+    case E_SBO_PARENT:   DoParentEntity(rec.iEntity, rec.iOther); break;
+    case E_SBO_BULK:     ApplyBulkEdit(*rec.pBulk); break;
+  }
+};
+
+// Execute all scheduled commands in order
+void IServerSandbox::ExecuteScheduled(void) {
+  const INDEX ctScheduled = aScheduled.Count();
+  if (ctScheduled == 0) return;
+
+  // Loaded level edits are only executed along with their level
+  if (fnmLoadedEdits != "") return;
 
-  astrScheduled.Push() = strCommand;
+  CPrintF(TRANS("Executing %d scheduled sandbox commands...\n"), ctScheduled);
+
+  for (INDEX iCommand = 0; iCommand < ctScheduled; iCommand++) {
+    ExecuteRecord(aScheduled[iCommand]);
+  }
 };
 
 // List all scheduled commands in order
 void IServerSandbox::ListScheduledCommands(void) {
-  if (astrScheduled.Count() == 0) {
+  if (aScheduled.Count() == 0) {
     CPutString(TRANS("No commands have been scheduled\n"));
     return;
   }
 
   CPutString(TRANS("Scheduled commands for the next server start:\n"));
 
-  for (INDEX iCommand = 0; iCommand < astrScheduled.Count(); iCommand++) {
-    CPrintF("  %s\n", astrScheduled[iCommand]);
+  for (INDEX iCommand = 0; iCommand < aScheduled.Count(); iCommand++) {
+    CPrintF("  %s\n", aScheduled[iCommand].ToCommand());
   }
 };
 
 // Clear scheduled commands
 void IServerSandbox::ClearScheduledCommands(void) {
-  CPrintF(TRANS("Cleared %d scheduled commands\n"), astrScheduled.Count());
+  CPrintF(TRANS("Cleared %d scheduled commands\n"), aScheduled.Count());
+
+  ForgetScheduled();
+};
+
+// Remove all scheduled commands
+void IServerSandbox::ForgetScheduled(void) {
+  for (INDEX iCommand = 0; iCommand < aScheduled.Count(); iCommand++) {
+    delete aScheduled[iCommand].pBulk;
+  }
 
-  astrScheduled.Clear();
+  aScheduled.Clear();
+  fnmLoadedEdits = CTString("");
 };
 
 // Delete an entity from the world
@@ -61,14 +132,16 @@ void IServerSandbox::DeleteEntity(SHELL_FUNC_ARGS) {
 
   // Schedule the command before the game starts
   if (!_pNetwork->IsServer()) {
-    CTString strCommand;
-    strCommand.PrintF("sutl_DeleteEntity(%d);", iEntityID);
-
-    ScheduleCommand(strCommand);
+    ScheduleRecord(NewRecord(E_SBO_DELETE, iEntityID));
     return;
   }
 
-  CEntity *pen = IWorld::FindEntityByID(IWorld::GetWorld(), (ULONG)iEntityID);
+  DoDeleteEntity(iEntityID);
+};
+
+// Delete an entity from the world
+void IServerSandbox::DoDeleteEntity(INDEX iEntityID) {
+  CEntity *pen = IEntityIndex::Find((ULONG)iEntityID);
 
   // No entity
   if (pen == NULL) {
@@ -92,14 +165,16 @@ void IServerSandbox::InitEntity(SHELL_FUNC_ARGS) {
 
   // Schedule the command before the game starts
   if (!_pNetwork->IsServer()) {
-    CTString strCommand;
-    strCommand.PrintF("sutl_InitEntity(%d);", iEntityID);
-
-    ScheduleCommand(strCommand);
+    ScheduleRecord(NewRecord(E_SBO_INIT, iEntityID));
     return;
   }
 
-  CEntity *pen = IWorld::FindEntityByID(IWorld::GetWorld(), (ULONG)iEntityID);
+  DoInitEntity(iEntityID);
+};
+
+// Initialize/reinitialize an entity
+void IServerSandbox::DoInitEntity(INDEX iEntityID) {
+  CEntity *pen = IEntityIndex::Find((ULONG)iEntityID);
 
   // No entity
   if (pen == NULL) {
@@ -133,14 +208,19 @@ void IServerSandbox::SetEntityPosition(SHELL_FUNC_ARGS) {
 
   // Schedule the command before the game starts
   if (!_pNetwork->IsServer()) {
-    CTString strCommand;
-    strCommand.PrintF("sutl_SetEntityPosition(%d, %f, %f, %f);", iEntityID, fX, fY, fZ);
+    SandboxRecord rec = NewRecord(E_SBO_POSITION, iEntityID);
+    rec.vValue = FLOAT3D(fX, fY, fZ);
 
-    ScheduleCommand(strCommand);
+    ScheduleRecord(rec);
     return;
   }
 
-  CEntity *pen = IWorld::FindEntityByID(IWorld::GetWorld(), (ULONG)iEntityID);
+  DoSetEntityPosition(iEntityID, FLOAT3D(fX, fY, fZ));
+};
+
+// Set new absolute position of an entity
+void IServerSandbox::DoSetEntityPosition(INDEX iEntityID, const FLOAT3D &vPos) {
+  CEntity *pen = IEntityIndex::Find((ULONG)iEntityID);
 
   // No entity
   if (pen == NULL) {
@@ -149,7 +229,7 @@ void IServerSandbox::SetEntityPosition(SHELL_FUNC_ARGS) {
   }
 
   CPlacement3D plEntity = pen->GetPlacement();
-  plEntity.pl_PositionVector = FLOAT3D(fX, fY, fZ);
+  plEntity.pl_PositionVector = vPos;
 
   pen->Teleport(plEntity, FALSE);
 };
@@ -169,14 +249,19 @@ void IServerSandbox::SetEntityRotation(SHELL_FUNC_ARGS) {
 
   // Schedule the command before the game starts
   if (!_pNetwork->IsServer()) {
-    CTString strCommand;
-    strCommand.PrintF("sutl_SetEntityRotation(%d, %f, %f, %f);", iEntityID, fH, fP, fB);
+    SandboxRecord rec = NewRecord(E_SBO_ROTATION, iEntityID);
+    rec.vValue = FLOAT3D(fH, fP, fB);
 
-    ScheduleCommand(strCommand);
+    ScheduleRecord(rec);
     return;
   }
 
-  CEntity *pen = IWorld::FindEntityByID(IWorld::GetWorld(), (ULONG)iEntityID);
+  DoSetEntityRotation(iEntityID, FLOAT3D(fH, fP, fB));
+};
+
+// Set new absolute rotation of an entity
+void IServerSandbox::DoSetEntityRotation(INDEX iEntityID, const FLOAT3D &vRot) {
+  CEntity *pen = IEntityIndex::Find((ULONG)iEntityID);
 
   // No entity
   if (pen == NULL) {
@@ -185,46 +270,19 @@ void IServerSandbox::SetEntityRotation(SHELL_FUNC_ARGS) {
   }
 
   CPlacement3D plEntity = pen->GetPlacement();
-  plEntity.pl_OrientationAngle = ANGLE3D(fH, fP, fB);
+  plEntity.pl_OrientationAngle = vRot;
 
   pen->Teleport(plEntity, FALSE);
 };
 
-// Set new value to some property by its name of an entity
-void IServerSandbox::SetEntityProperty(SHELL_FUNC_ARGS) {
-  BEGIN_SHELL_FUNC;
-  INDEX iEntityID = NEXT_ARG(INDEX);
-  const CTString &strProperty = *NEXT_ARG(CTString *);
-  CTString &strValue = *NEXT_ARG(CTString *);
-
-  if (iEntityID < 0) {
-    CPrintF(TRANS("Invalid entity ID: %d\n"), iEntityID);
-    return;
-  }
-
-  // Schedule the command before the game starts
-  if (!_pNetwork->IsServer()) {
-    CTString strCommand;
-    strCommand.PrintF("sutl_SetEntityProperty(%d, \"%s\", \"%s\");", iEntityID, strProperty, strValue);
-
-    ScheduleCommand(strCommand);
-    return;
-  }
-  
-  CEntity *pen = IWorld::FindEntityByID(IWorld::GetWorld(), (ULONG)iEntityID);
-
-  // No entity
-  if (pen == NULL) {
-    CPrintF(TRANS("Could not find entity under ID: %d\n"), iEntityID);
-    return;
-  }
-
+// Set new value to some property of an entity from a string
+BOOL IServerSandbox::SetPropertyValue(CEntity *pen, const CTString &strProperty, CTString strValue) {
   CEntityProperty *pep = pen->PropertyForName(strProperty);
 
   // No property
   if (pep == NULL) {
     CPrintF(TRANS("Could not find entity property with the name '%s' in %s\n"), strProperty, pen->GetClass()->ec_pdecDLLClass->dec_strName);
-    return;
+    return FALSE;
   }
 
   INDEX iPropType = IProperties::ConvertType(pep->ep_eptType);
@@ -257,7 +315,7 @@ void IServerSandbox::SetEntityProperty(SHELL_FUNC_ARGS) {
       CEntity *penSet = NULL;
 
       if (iEntityID >= 0) {
-        penSet = IWorld::FindEntityByID(IWorld::GetWorld(), (ULONG)iEntityID);
+        penSet = IEntityIndex::Find((ULONG)iEntityID);
       }
 
       bPropertySet = IProperties::SetPropValue(pen, pep, &penSet);
@@ -271,8 +329,46 @@ void IServerSandbox::SetEntityProperty(SHELL_FUNC_ARGS) {
     } break;
   }
 
+  return bPropertySet;
+};
+
+// Set new value to some property by its name of an entity
+void IServerSandbox::SetEntityProperty(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  INDEX iEntityID = NEXT_ARG(INDEX);
+  const CTString &strProperty = *NEXT_ARG(CTString *);
+  const CTString &strValue = *NEXT_ARG(CTString *);
+
+  if (iEntityID < 0) {
+    CPrintF(TRANS("Invalid entity ID: %d\n"), iEntityID);
+    return;
+  }
+
+  // Schedule the command before the game starts
+  if (!_pNetwork->IsServer()) {
+    SandboxRecord rec = NewRecord(E_SBO_PROPERTY, iEntityID);
+    rec.strArg1 = strProperty;
+    rec.strArg2 = strValue;
+
+    ScheduleRecord(rec);
+    return;
+  }
+
+  DoSetEntityProperty(iEntityID, strProperty, strValue);
+};
+
+// Set new value to some property by its name of an entity
+void IServerSandbox::DoSetEntityProperty(INDEX iEntityID, const CTString &strProperty, const CTString &strValue) {
+  CEntity *pen = IEntityIndex::Find((ULONG)iEntityID);
+
+  // No entity
+  if (pen == NULL) {
+    CPrintF(TRANS("Could not find entity under ID: %d\n"), iEntityID);
+    return;
+  }
+
   // Couldn't set new value
-  if (!bPropertySet) {
+  if (!SetPropertyValue(pen, strProperty, strValue)) {
     CPrintF(TRANS("Could not set '%s' value to '%s' property\n"), strValue, strProperty);
   }
 };
@@ -290,14 +386,19 @@ void IServerSandbox::ParentEntity(SHELL_FUNC_ARGS) {
 
   // Schedule the command before the game starts
   if (!_pNetwork->IsServer()) {
-    CTString strCommand;
-    strCommand.PrintF("sutl_ParentEntity(%d, %d);", iEntityID, iParentEntityID);
+    SandboxRecord rec = NewRecord(E_SBO_PARENT, iEntityID);
+    rec.iOther = iParentEntityID;
 
-    ScheduleCommand(strCommand);
+    ScheduleRecord(rec);
     return;
   }
 
-  CEntity *pen = IWorld::FindEntityByID(IWorld::GetWorld(), (ULONG)iEntityID);
+  DoParentEntity(iEntityID, iParentEntityID);
+};
+
+// Parent an entity to another entity
+void IServerSandbox::DoParentEntity(INDEX iEntityID, INDEX iParentEntityID) {
+  CEntity *pen = IEntityIndex::Find((ULONG)iEntityID);
 
   // No entity
   if (pen == NULL) {
@@ -312,6 +413,6 @@ void IServerSandbox::ParentEntity(SHELL_FUNC_ARGS) {
   }
 
   // Parent to some entity
-  CEntity *penParent = IWorld::FindEntityByID(IWorld::GetWorld(), (ULONG)iParentEntityID);
+  CEntity *penParent = IEntityIndex::Find((ULONG)iParentEntityID);
   pen->SetParent(penParent);
 };
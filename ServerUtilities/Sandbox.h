@@ -13,14 +13,56 @@ You should have received a copy of the GNU General Public License along
 with this program; if not, write to the Free Software Foundation, Inc.,
 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
 
+// Sandbox operations that can be scheduled
+enum ESandboxOperation {
+  E_SBO_DELETE,
+  E_SBO_INIT,
+  E_SBO_POSITION,
+  E_SBO_ROTATION,
+  E_SBO_PROPERTY,
+  E_SBO_PARENT,
+  E_SBO_BULK,
+};
+
+struct SandboxBulkEdit;
+
+// One scheduled sandbox command with its arguments
+struct SandboxRecord {
+  ESandboxOperation eOperation;
+  INDEX iEntity; // Target entity ID
+  INDEX iOther; // Parent entity ID
+  FLOAT3D vValue; // Position or rotation
+  CTString strArg1; // Property name or bulk query
+  CTString strArg2; // Property value or bulk action
+  SandboxBulkEdit *pBulk; // Parsed bulk edit owned by the record
+
+  // Print record as a shell command
+  CTString ToCommand(void) const;
+};
+
 class IServerSandbox {
   public:
-    // Scheduled commands to be executed after the world loads
-    static CStringStack astrScheduled;
+    // Commands scheduled to be executed after the world loads
+    static CStaticStackArray<SandboxRecord> aScheduled;
+
+    // Level whose saved edits have been loaded into scheduled commands
+    static CTFileName fnmLoadedEdits;
 
   public:
+    // Start a new record for some operation
+    static SandboxRecord NewRecord(ESandboxOperation eOperation, INDEX iEntity);
+
     // Schedule one command
-    static void ScheduleCommand(const CTString &strCommand);
+    static void ScheduleRecord(const SandboxRecord &rec);
+
+    // Execute one scheduled command without going through the shell
+    static void ExecuteRecord(const SandboxRecord &rec);
+
+    // Execute all scheduled commands in order
+    static void ExecuteScheduled(void);
+
+    // Remove all scheduled commands
+    static void ForgetScheduled(void);
 
     // List all scheduled commands in order
     static void ListScheduledCommands(void);
@@ -28,6 +70,9 @@ class IServerSandbox {
     // Clear scheduled commands
     static void ClearScheduledCommands(void);
 
+    // Set new value to some property of an entity from a string
+    static BOOL SetPropertyValue(CEntity *pen, const CTString &strProperty, CTString strValue);
+
     // Delete an entity from the world
     static void DeleteEntity(SHELL_FUNC_ARGS);
 
@@ -45,4 +90,16 @@ class IServerSandbox {
 
     // Parent an entity to another entity
     static void ParentEntity(SHELL_FUNC_ARGS);
+
+    // Apply an action to all entities that match a query
+    static void BulkEdit(SHELL_FUNC_ARGS);
+
+  // Operations on the current world
+  public:
+    static void DoDeleteEntity(INDEX iEntityID);
+    static void DoInitEntity(INDEX iEntityID);
+    static void DoSetEntityPosition(INDEX iEntityID, const FLOAT3D &vPos);
+    static void DoSetEntityRotation(INDEX iEntityID, const FLOAT3D &vRot);
+    static void DoSetEntityProperty(INDEX iEntityID, const CTString &strProperty, const CTString &strValue);
+    static void DoParentEntity(INDEX iEntityID, INDEX iParentEntityID);
 };
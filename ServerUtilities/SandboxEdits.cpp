@@ -0,0 +1,465 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "Sandbox.h"
+#include "SandboxEdits.h"
+#include "BulkEdit.h"
+#include "StartActions.h"
+#include "AffectPlan.h"
+
+// Directory with level edits on disk
+#define SANDBOX_EDITS_DIR "Data\\ClassicsPatch\\ServerUtilities\\Edits\\"
+
+// Edits format on disk
+static const INDEX _iEditsVersion = 2;
+
+// Property test of a bulk edit on disk
+struct SandboxEditTest {
+  INDEX iProperty; // Offsets of strings in the string pool
+  INDEX iValue;
+  INDEX iOperator;
+  INDEX iReserved;
+  DOUBLE fValue;
+};
+
+// One sandbox command on disk
+struct SandboxEditRecord {
+  INDEX iOperation;
+  INDEX iEntity;
+  INDEX iOther;
+  FLOAT afValue[3];
+  INDEX iArg1; // Offsets of strings in the string pool
+  INDEX iArg2;
+  INDEX iBulk; // Parsed bulk edit (-1 if none)
+};
+
+// Parsed bulk edit on disk
+struct SandboxEditBulk {
+  INDEX iClass; // Offsets of strings in the string pool
+  INDEX iName;
+  INDEX bArea;
+  FLOAT afArea[6];
+  INDEX iFirstTest;
+  INDEX ctTests;
+  INDEX iAction;
+  FLOAT afOffset[3];
+  INDEX iProperty;
+  INDEX iValue;
+};
+
+// Header of an edits file followed by property tests, records, bulk edits and a string pool
+struct SandboxEditsHeader {
+  char aID[4];
+  INDEX iVersion;
+  ULONG ulWorldCRC;
+  INDEX iWorld; // World file name in the string pool
+  INDEX ctTests;
+  INDEX ctRecords;
+  INDEX ctBulks;
+  INDEX ctPool;
+};
+
+// Edits file that's been read into memory
+struct SandboxEditsFile {
+  CStaticArray<UBYTE> aubData;
+  const SandboxEditsHeader *pHeader;
+  const SandboxEditTest *pTests;
+  const SandboxEditRecord *pRecords;
+  const SandboxEditBulk *pBulks;
+  const char *strPool;
+};
+
+// Edits file of some level under the same relative path
+static CTFileName GetEditsFile(const CTFileName &fnmWorld, const char *strExt) {
+  return CTString(SANDBOX_EDITS_DIR) + fnmWorld.NoExt() + strExt;
+};
+
+// Determine the level from a command argument or take the current one
+static BOOL GetLevel(const CTString &strLevel, CTFileName &fnmWorld) {
+  fnmWorld = CTFileName(strLevel);
+
+  if (fnmWorld == "") {
+    fnmWorld = IWorld::GetWorld()->wo_fnmFileName;
+  }
+
+  if (fnmWorld == "") {
+    CPutString(TRANS("No level has been specified and no level is currently loaded\n"));
+    return FALSE;
+  }
+
+  return TRUE;
+};
+
+// Add a string to the string pool and return its offset
+static INDEX AddToPool(CStaticStackArray<char> &aPool, const CTString &str) {
+  const INDEX iOffset = aPool.Count();
+  const INDEX ctChars = strlen(str.str_String) + 1;
+
+  memcpy(&aPool.Push(ctChars), str.str_String, ctChars);
+  return iOffset;
+};
+
+// Write sandbox commands of some world on disk
+static void WriteEdits_t(const CTFileName &fnmEdits, const CTFileName &fnmWorld, const CStaticStackArray<SandboxRecord> &aRecords) {
+  const INDEX ctRecords = aRecords.Count();
+
+  CStaticArray<SandboxEditRecord> aEdits;
+  CStaticStackArray<SandboxEditBulk> aBulks;
+  CStaticStackArray<SandboxEditTest> aTests;
+  CStaticStackArray<char> aPool;
+
+  if (ctRecords > 0) aEdits.New(ctRecords);
+
+  SandboxEditsHeader header;
+  memcpy(header.aID, "SUED", 4);
+  header.iVersion = _iEditsVersion;
+  header.ulWorldCRC = IAffectPlan::GetWorldCRC_t(fnmWorld);
+  header.iWorld = AddToPool(aPool, fnmWorld);
+
+  for (INDEX iRecord = 0; iRecord < ctRecords; iRecord++) {
+    const SandboxRecord &rec = aRecords[iRecord];
+    SandboxEditRecord &edit = aEdits[iRecord];
+
+    edit.iOperation = rec.eOperation;
+    edit.iEntity = rec.iEntity;
+    edit.iOther = rec.iOther;
+    edit.afValue[0] = rec.vValue(1);
+    edit.afValue[1] = rec.vValue(2);
+    edit.afValue[2] = rec.vValue(3);
+    edit.iArg1 = AddToPool(aPool, rec.strArg1);
+    edit.iArg2 = AddToPool(aPool, rec.strArg2);
+    edit.iBulk = -1;
+
+    if (rec.pBulk == NULL) continue;
+
+    // Store parsed bulk edit, so it doesn't need to be parsed again
+    const EntityQuery &query = rec.pBulk->query;
+    const BulkAction &action = rec.pBulk->action;
+
+    edit.iBulk = aBulks.Count();
+    SandboxEditBulk &bulk = aBulks.Push();
+
+    bulk.iClass = AddToPool(aPool, query.strClass);
+    bulk.iName = AddToPool(aPool, query.strName);
+    bulk.bArea = query.bArea;
+    bulk.afArea[0] = query.boxArea.Min()(1);
+    bulk.afArea[1] = query.boxArea.Min()(2);
+    bulk.afArea[2] = query.boxArea.Min()(3);
+    bulk.afArea[3] = query.boxArea.Max()(1);
+    bulk.afArea[4] = query.boxArea.Max()(2);
+    bulk.afArea[5] = query.boxArea.Max()(3);
+    bulk.iFirstTest = aTests.Count();
+    bulk.ctTests = query.aTests.Count();
+
+    for (INDEX iTest = 0; iTest < query.aTests.Count(); iTest++) {
+      const PropertyTest &test = query.aTests[iTest];
+      SandboxEditTest &testEdit = aTests.Push();
+
+      testEdit.iProperty = AddToPool(aPool, test.strProperty);
+      testEdit.iValue = AddToPool(aPool, test.strValue);
+      testEdit.iOperator = test.eOperator;
+      testEdit.iReserved = 0;
+      testEdit.fValue = test.fValue;
+    }
+
+    bulk.iAction = action.eAction;
+    bulk.afOffset[0] = action.vOffset(1);
+    bulk.afOffset[1] = action.vOffset(2);
+    bulk.afOffset[2] = action.vOffset(3);
+    bulk.iProperty = AddToPool(aPool, action.strProperty);
+    bulk.iValue = AddToPool(aPool, action.strValue);
+  }
+
+  header.ctTests = aTests.Count();
+  header.ctRecords = ctRecords;
+  header.ctBulks = aBulks.Count();
+  header.ctPool = aPool.Count();
+
+  CTFileStream strm;
+  strm.Create_t(fnmEdits);
+  strm.Write_t(&header, sizeof(header));
+
+  if (header.ctTests > 0) strm.Write_t(&aTests[0], header.ctTests * sizeof(SandboxEditTest));
+  if (header.ctRecords > 0) strm.Write_t(&aEdits[0], header.ctRecords * sizeof(SandboxEditRecord));
+  if (header.ctBulks > 0) strm.Write_t(&aBulks[0], header.ctBulks * sizeof(SandboxEditBulk));
+  strm.Write_t(&aPool[0], header.ctPool);
+};
+
+// Write sandbox commands as a script that can be included from the shell
+static void ExportEdits_t(const CTFileName &fnmExport, const CStaticStackArray<SandboxRecord> &aRecords) {
+  CTFileStream strm;
+  strm.Create_t(fnmExport);
+
+  for (INDEX iRecord = 0; iRecord < aRecords.Count(); iRecord++) {
+    strm.FPrintF_t("%s\n", aRecords[iRecord].ToCommand().str_String);
+  }
+};
+
+// Check that a string starts within the pool
+static inline BOOL IsValidString(const SandboxEditsFile &file, INDEX iOffset) {
+  return iOffset >= 0 && iOffset < file.pHeader->ctPool;
+};
+
+// Read the whole edits file of some world into memory and verify it, so records can be used as is
+static void ReadEdits_t(const CTFileName &fnmEdits, const CTFileName &fnmWorld, SandboxEditsFile &file) {
+  CTFileStream strm;
+  strm.Open_t(fnmEdits);
+
+  const SLONG slSize = strm.GetStreamSize();
+
+  if (slSize < (SLONG)sizeof(SandboxEditsHeader)) {
+    ThrowF_t(TRANS("File is too small"));
+  }
+
+  file.aubData.New(slSize);
+  strm.Read_t(&file.aubData[0], slSize);
+
+  const SandboxEditsHeader &header = *(const SandboxEditsHeader *)&file.aubData[0];
+  file.pHeader = &header;
+
+  if (memcmp(header.aID, "SUED", 4) != 0) {
+    ThrowF_t(TRANS("Not a sandbox edits file"));
+  }
+
+  if (header.iVersion != _iEditsVersion) {
+    ThrowF_t(TRANS("Unsupported edits version: %d"), header.iVersion);
+  }
+
+  // Check each section against the remaining size before multiplying, so the counts can't overflow
+  SLONG slLeft = slSize - (SLONG)sizeof(SandboxEditsHeader);
+
+  #define CHECK_SECTION(_Count, _Type) \
+    if (_Count < 0 || _Count > slLeft / (SLONG)sizeof(_Type)) { \
+      ThrowF_t(TRANS("File size doesn't match its contents")); \
+    } \
+    slLeft -= _Count * (SLONG)sizeof(_Type);
+
+  CHECK_SECTION(header.ctTests, SandboxEditTest);
+  CHECK_SECTION(header.ctRecords, SandboxEditRecord);
+  CHECK_SECTION(header.ctBulks, SandboxEditBulk);
+
+  #undef CHECK_SECTION
+
+  if (header.ctPool <= 0 || header.ctPool != slLeft) {
+    ThrowF_t(TRANS("File size doesn't match its contents"));
+  }
+
+  file.pTests = (const SandboxEditTest *)(&header + 1);
+  file.pRecords = (const SandboxEditRecord *)(file.pTests + header.ctTests);
+  file.pBulks = (const SandboxEditBulk *)(file.pRecords + header.ctRecords);
+  file.strPool = (const char *)(file.pBulks + header.ctBulks);
+
+  // Every string must end within the pool
+  if (file.strPool[header.ctPool - 1] != '\0') {
+    ThrowF_t(TRANS("String pool isn't terminated"));
+  }
+
+  // Edits must be for the same world
+  if (!IsValidString(file, header.iWorld) || fnmWorld != file.strPool + header.iWorld) {
+    ThrowF_t(TRANS("Edits are for a different world"));
+  }
+
+  if (header.ulWorldCRC != IAffectPlan::GetWorldCRC_t(fnmWorld)) {
+    ThrowF_t(TRANS("World has been changed since the edits were saved"));
+  }
+
+  INDEX i;
+
+  for (i = 0; i < header.ctTests; i++) {
+    const SandboxEditTest &test = file.pTests[i];
+
+    if (!IsValidString(file, test.iProperty) || !IsValidString(file, test.iValue)
+     || test.iOperator < E_QO_EQUAL || test.iOperator > E_QO_GREATER) {
+      ThrowF_t(TRANS("Invalid property test %d"), i);
+    }
+  }
+
+  for (i = 0; i < header.ctBulks; i++) {
+    const SandboxEditBulk &bulk = file.pBulks[i];
+
+    if (!IsValidString(file, bulk.iClass) || !IsValidString(file, bulk.iName)
+     || !IsValidString(file, bulk.iProperty) || !IsValidString(file, bulk.iValue)
+     || bulk.iFirstTest < 0 || bulk.ctTests < 0 || bulk.ctTests > header.ctTests - bulk.iFirstTest
+     || bulk.iAction < E_BA_DELETE || bulk.iAction > E_BA_SET) {
+      ThrowF_t(TRANS("Invalid bulk edit %d"), i);
+    }
+  }
+
+  for (i = 0; i < header.ctRecords; i++) {
+    const SandboxEditRecord &edit = file.pRecords[i];
+
+    if (edit.iOperation < E_SBO_DELETE || edit.iOperation > E_SBO_BULK
+     || !IsValidString(file, edit.iArg1) || !IsValidString(file, edit.iArg2)
+     || (edit.iOperation == E_SBO_BULK) != (edit.iBulk >= 0 && edit.iBulk < header.ctBulks)) {
+      ThrowF_t(TRANS("Invalid record %d"), i);
+    }
+  }
+};
+
+// Turn a bulk edit on disk into a parsed one
+static SandboxBulkEdit *GetBulkEdit(const SandboxEditsFile &file, INDEX iBulk) {
+  const SandboxEditBulk &bulk = file.pBulks[iBulk];
+  SandboxBulkEdit *pBulk = new SandboxBulkEdit;
+
+  EntityQuery &query = pBulk->query;
+  query.strClass = file.strPool + bulk.iClass;
+  query.strName = file.strPool + bulk.iName;
+  query.bArea = bulk.bArea;
+  query.boxArea = FLOATaabbox3D(FLOAT3D(bulk.afArea[0], bulk.afArea[1], bulk.afArea[2]),
+                                FLOAT3D(bulk.afArea[3], bulk.afArea[4], bulk.afArea[5]));
+
+  for (INDEX iTest = 0; iTest < bulk.ctTests; iTest++) {
+    const SandboxEditTest &testEdit = file.pTests[bulk.iFirstTest + iTest];
+    PropertyTest &test = query.aTests.Push();
+
+    test.strProperty = file.strPool + testEdit.iProperty;
+    test.strValue = file.strPool + testEdit.iValue;
+    test.eOperator = (EQueryOperator)testEdit.iOperator;
+    test.fValue = testEdit.fValue;
+  }
+
+  BulkAction &action = pBulk->action;
+  action.eAction = (EBulkAction)bulk.iAction;
+  action.vOffset = FLOAT3D(bulk.afOffset[0], bulk.afOffset[1], bulk.afOffset[2]);
+  action.strProperty = file.strPool + bulk.iProperty;
+  action.strValue = file.strPool + bulk.iValue;
+
+  return pBulk;
+};
+
+// Turn a record on disk into a sandbox command
+static void GetRecord(const SandboxEditsFile &file, INDEX iRecord, SandboxRecord &rec) {
+  const SandboxEditRecord &edit = file.pRecords[iRecord];
+
+  rec.eOperation = (ESandboxOperation)edit.iOperation;
+  rec.iEntity = edit.iEntity;
+  rec.iOther = edit.iOther;
+  rec.vValue = FLOAT3D(edit.afValue[0], edit.afValue[1], edit.afValue[2]);
+  rec.strArg1 = file.strPool + edit.iArg1;
+  rec.strArg2 = file.strPool + edit.iArg2;
+  rec.pBulk = (edit.iBulk >= 0) ? GetBulkEdit(file, edit.iBulk) : NULL;
+};
+
+// Apply saved edits of the current level
+void ISandboxEdits::ApplyCurrentLevel(void) {
+  if (!_psLevelEdits.GetIndex()) return;
+
+  const CTFileName fnmWorld = IWorld::GetWorld()->wo_fnmFileName;
+
+  // Edits have been loaded into scheduled commands, so execute them from there instead
+  if (IServerSandbox::fnmLoadedEdits == fnmWorld) {
+    const CStaticStackArray<SandboxRecord> &aScheduled = IServerSandbox::aScheduled;
+
+    for (INDEX iCommand = 0; iCommand < aScheduled.Count(); iCommand++) {
+      IServerSandbox::ExecuteRecord(aScheduled[iCommand]);
+    }
+
+    CPrintF(TRANS("Applied %d loaded sandbox edits\n"), aScheduled.Count());
+    return;
+  }
+
+  const CTFileName fnmEdits = GetEditsFile(fnmWorld, ".sue");
+  if (!FileExists(fnmEdits)) return;
+
+  CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+  SandboxEditsFile file;
+
+  try {
+    ReadEdits_t(fnmEdits, fnmWorld, file);
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot load sandbox edits from '%s': %s\n"), fnmEdits.str_String, strError);
+    return;
+  }
+
+  const INDEX ctRecords = file.pHeader->ctRecords;
+  SandboxRecord rec;
+
+  for (INDEX iRecord = 0; iRecord < ctRecords; iRecord++) {
+    GetRecord(file, iRecord, rec);
+    IServerSandbox::ExecuteRecord(rec);
+    delete rec.pBulk;
+  }
+
+  const DOUBLE dMS = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds() * 1000.0;
+  CPrintF(TRANS("Applied %d sandbox edits from '%s' in %.2f ms\n"), ctRecords, fnmEdits.str_String, dMS);
+};
+
+// Save scheduled commands as edits of some level and remove them from the schedule
+void ISandboxEdits::SaveLevelEdits(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const CTString &strLevel = *NEXT_ARG(CTString *);
+
+  CTFileName fnmWorld;
+  if (!GetLevel(strLevel, fnmWorld)) return;
+
+  const CStaticStackArray<SandboxRecord> &aScheduled = IServerSandbox::aScheduled;
+  const CTFileName fnmEdits = GetEditsFile(fnmWorld, ".sue");
+  const CTFileName fnmExport = GetEditsFile(fnmWorld, ".ini");
+
+  try {
+    WriteEdits_t(fnmEdits, fnmWorld, aScheduled);
+    ExportEdits_t(fnmExport, aScheduled);
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot save sandbox edits: %s\n"), strError);
+    return;
+  }
+
+  CPrintF(TRANS("Saved %d sandbox commands into '%s' (text export in '%s')\n"),
+    aScheduled.Count(), fnmEdits.str_String, fnmExport.str_String);
+
+  // Saved edits are applied when the level starts
+  IServerSandbox::ForgetScheduled();
+};
+
+// Load saved edits of some level into scheduled commands to change and save them again
+void ISandboxEdits::LoadLevelEdits(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const CTString &strLevel = *NEXT_ARG(CTString *);
+
+  CTFileName fnmWorld;
+  if (!GetLevel(strLevel, fnmWorld)) return;
+
+  // Only one set of edits can be edited at a time
+  if (IServerSandbox::aScheduled.Count() > 0) {
+    CPutString(TRANS("Save or clear scheduled commands before loading other edits\n"));
+    return;
+  }
+
+  const CTFileName fnmEdits = GetEditsFile(fnmWorld, ".sue");
+  SandboxEditsFile file;
+
+  try {
+    ReadEdits_t(fnmEdits, fnmWorld, file);
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot load sandbox edits: %s\n"), strError);
+    return;
+  }
+
+  const INDEX ctRecords = file.pHeader->ctRecords;
+
+  for (INDEX iRecord = 0; iRecord < ctRecords; iRecord++) {
+    GetRecord(file, iRecord, IServerSandbox::aScheduled.Push());
+  }
+
+  // Scheduled commands replace the saved edits until they are saved again
+  IServerSandbox::fnmLoadedEdits = fnmWorld;
+
+  CPrintF(TRANS("Loaded %d sandbox commands from '%s'\n"), ctRecords, fnmEdits.str_String);
+};
@@ -0,0 +1,26 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+class ISandboxEdits {
+  public:
+    // Apply saved edits of the current level
+    static void ApplyCurrentLevel(void);
+
+    // Save scheduled commands as edits of some level and remove them from the schedule
+    static void SaveLevelEdits(SHELL_FUNC_ARGS);
+
+    // Load saved edits of some level into scheduled commands to change and save them again
+    static void LoadLevelEdits(SHELL_FUNC_ARGS);
+};
@@ -0,0 +1,169 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "StartActions.h"
+#include "AffectTable.h"
+#include "SpawnedEntities.h"
+#include "EntityIndex.h"
+
+// Entity that's been spawned and is waiting to be affected
+struct SpawnedEntity {
+  CEntity *pen; // Referenced until it's affected
+  FEntityAffect pAffect;
+};
+
+// Entities affected after their world has been loaded
+INDEX ISpawnedEntities::ctAffected = 0;
+
+// Spawned entities are being tracked
+static BOOL _bTracking = FALSE;
+
+// First ID that's been given to an entity after the world has been loaded
+static ULONG _ulFirstSpawnedID = 0;
+
+// Which spawned entities have already been seen, starting from the first spawned ID
+static CStaticStackArray<UBYTE> _aubSeen;
+
+// Entities waiting to be affected on the next tick
+static CStaticStackArray<SpawnedEntity> _aSpawned;
+
+// Check if some spawned entity is seen for the first time and mark it
+static BOOL MarkSeen(ULONG ulEntity) {
+  const ULONG ulBit = ulEntity - _ulFirstSpawnedID;
+  const INDEX iByte = ulBit >> 3;
+  const UBYTE ubMask = UBYTE(1 << (ulBit & 7));
+
+  // Entity IDs only increase, so the bits grow along with them
+  const INDEX ctBytes = _aubSeen.Count();
+
+  if (iByte >= ctBytes) {
+    UBYTE *aubNew = _aubSeen.Push(iByte - ctBytes + 1);
+    memset(aubNew, 0, iByte - ctBytes + 1);
+  }
+
+  if (_aubSeen[iByte] & ubMask) return FALSE;
+
+  _aubSeen[iByte] |= ubMask;
+  return TRUE;
+};
+
+// Queue newly spawned entity if it needs to be affected
+static void QueueSpawned(CEntity *pen) {
+  if (!_bTracking || !_psAffectSpawned.GetIndex() || !_pNetwork->IsServer()) return;
+
+  // Entity from the world itself
+  if (pen->en_ulID < _ulFirstSpawnedID) return;
+
+  // Entity is being reinitialized
+  if (!MarkSeen(pen->en_ulID)) return;
+
+  FEntityAffect pAffect = IAffectTable::FindHandler(pen);
+  if (pAffect == NULL) return;
+
+  SpawnedEntity &se = _aSpawned.Push();
+  se.pen = pen;
+  se.pAffect = pAffect;
+  pen->AddReference();
+};
+
+// Original entity initialization and destruction
+typedef void (CEntity::*CInitializeFunc)(const CEntityEvent &);
+static CInitializeFunc pInitialize = NULL;
+
+typedef void (CEntity::*CDestroyFunc)(void);
+static CDestroyFunc pDestroy = NULL;
+
+class CEntityPatch : public CEntity {
+  public:
+    void P_Initialize(const CEntityEvent &eeInput);
+    void P_Destroy(void);
+};
+
+// Patched function
+void CEntityPatch::P_Initialize(const CEntityEvent &eeInput)
+{
+  (this->*pInitialize)(eeInput);
+
+  IEntityIndex::Add(this);
+
+  // Affect it after it's fully set up by whatever spawned it
+  QueueSpawned(this);
+};
+
+// Patched function
+void CEntityPatch::P_Destroy(void)
+{
+  // Entity may be freed afterwards
+  IEntityIndex::Remove(this);
+
+  (this->*pDestroy)();
+};
+
+// Hook entity initialization and destruction
+void ISpawnedEntities::Initialize(void) {
+  pInitialize = &CEntity::Initialize;
+  CreatePatch(pInitialize, &CEntityPatch::P_Initialize, "CEntity::Initialize(...)");
+
+  pDestroy = &CEntity::Destroy;
+  CreatePatch(pDestroy, &CEntityPatch::P_Destroy, "CEntity::Destroy()");
+};
+
+// Forget spawned entities and start or stop tracking new ones
+void ISpawnedEntities::Reset(BOOL bTrack) {
+  for (INDEX i = 0; i < _aSpawned.Count(); i++) {
+    _aSpawned[i].pen->RemReference();
+  }
+
+  _aSpawned.PopAll();
+  _aubSeen.PopAll();
+
+  _bTracking = bTrack;
+
+  CWorld *pwo = IWorld::GetWorld();
+  _ulFirstSpawnedID = (pwo != NULL) ? pwo->wo_ulNextEntityID : 0;
+};
+
+// Affect entities that have been spawned since the last call
+void ISpawnedEntities::Flush(void) {
+  const INDEX ctSpawned = _aSpawned.Count();
+  if (ctSpawned == 0) return;
+
+  for (INDEX i = 0; i < ctSpawned; i++) {
+    SpawnedEntity &se = _aSpawned[i];
+
+    // Entity could have been removed in the meantime
+    if (!(se.pen->GetFlags() & ENF_DELETED)) {
+      se.pAffect(se.pen);
+      ctAffected++;
+    }
+
+    se.pen->RemReference();
+  }
+
+  _aSpawned.PopAll();
+
+  // Spawned entities aren't part of the world's affect plan
+  CStaticStackArray<EntityChange> aChanges;
+  const INDEX ctQueued = CollectEntityChanges(aChanges);
+
+  if (ctQueued > 0) ApplyEntityChanges(aChanges, ctQueued, FALSE);
+};
+
+// Report how many entities have been affected at load and after it
+void ISpawnedEntities::ReportAffected(void) {
+  CPrintF(TRANS("Affected entities: %d at load, %d after spawning\n"), IAffectTable::ctAffectedAtLoad, ctAffected);
+};
@@ -0,0 +1,33 @@
+/* Copyright (c) 2024 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+class ISpawnedEntities {
+  public:
+    // Entities affected after their world has been loaded
+    static INDEX ctAffected;
+
+  public:
+    // Hook entity initialization and destruction
+    static void Initialize(void);
+
+    // Forget spawned entities and start or stop tracking new ones
+    static void Reset(BOOL bTrack);
+
+    // Affect entities that have been spawned since the last call
+    static void Flush(void);
+
+    // Report how many entities have been affected at load and after it
+    static void ReportAffected(void);
+};
@@ -22,72 +22,277 @@ static void ReportPropError(CEntity *pen, const char *strPropertyName) {
   CPrintF(TRANS("'%s' (%u) : Cannot retrieve '%s' property!\n"), pen->GetName(), pen->en_ulID, strPropertyName);
 };
 
-// Verify item type and reset it to default value if it's invalid
-static INDEX VerifyItemType(CEntity *pen, const CPropertyPtr &pptrType, INDEX iType) {
-  CTString strType = pptrType._pep->ep_pepetEnumType->NameForValue(iType);
+// Changes queued during the current affect pass
+static CStaticStackArray<EntityChange> _aChanges;
+
+// Queue new change of some entity
+static EntityChange &QueueChange(CEntity *pen, EEntityChange eType) {
+  EntityChange &ec = _aChanges.Push();
+  ec.pen = pen;
+  ec.ulEntity = pen->en_ulID;
+  ec.eType = eType;
+  ec.pep = NULL;
+  ec.fValue = 0.0;
+  ec.iOrder = _aChanges.Count() - 1;
+  return ec;
+};
 
-  // Set default valid type if invalid
-  if (strType == "") {
-    CPrintF(TRANS("'%s' (%u) : Item type %d is invalid!\n"), pen->GetName(), pen->en_ulID, iType);
-    return 1;
+// Destroy some entity
+static inline void DestroyEntity(CEntity *pen) {
+  QueueChange(pen, E_EC_DELETE);
+};
+
+// Reinitialize some entity
+static inline void ReinitEntity(CEntity *pen) {
+  QueueChange(pen, E_EC_INIT);
+};
+
+// Change property of some entity
+static inline void ChangeEntityProp(CEntity *pen, CPropertyPtr &pptr, DOUBLE fValue) {
+  EntityChange &ec = QueueChange(pen, E_EC_PROP);
+  ec.pep = pptr._pep;
+  ec.fValue = fValue;
+};
+
+// Sort changes by entity, then by type, then by property, then in queued order
+static int CompareChanges(const void *pElement1, const void *pElement2) {
+  const EntityChange &ec1 = *(const EntityChange *)pElement1;
+  const EntityChange &ec2 = *(const EntityChange *)pElement2;
+
+  if (ec1.ulEntity != ec2.ulEntity) return (ec1.ulEntity < ec2.ulEntity) ? -1 : +1;
+  if (ec1.eType != ec2.eType) return (ec1.eType < ec2.eType) ? -1 : +1;
+
+  if (ec1.pep != ec2.pep) {
+    const ULONG ulProp1 = (ec1.pep != NULL) ? ec1.pep->ep_ulID : 0;
+    const ULONG ulProp2 = (ec2.pep != NULL) ? ec2.pep->ep_ulID : 0;
+    if (ulProp1 != ulProp2) return (ulProp1 < ulProp2) ? -1 : +1;
   }
 
-  return iType;
+  return ec1.iOrder - ec2.iOrder;
 };
 
-// Destroy some entity
-static inline void DestroyEntity(CEntity *pen) {
+// Send or apply one entity change and return an estimated amount of sent payload bytes
+// Estimates only count values that are written into packets, not their actual serialized size
+static SLONG ApplyChange(const EntityChange &ec) {
 #if _PATCHCONFIG_EXT_PACKETS
-  // Send packet to destroy the entity
-  CExtEntityDelete pck;
-  pck("ulEntity", (int)pen->en_ulID);
-  pck("bSameClass", false);
-  pck.SendToClients();
+  switch (ec.eType) {
+    // Send packet to change the property
+    case E_EC_PROP: {
+      CExtEntityProp pck;
+      pck("ulEntity", (int)ec.ulEntity);
+      pck.SetProperty(ec.pep->ep_ulID);
+      pck.SetValue(ec.fValue);
+      pck.SendToClients();
+    } return sizeof(ULONG) * 2 + sizeof(DOUBLE);
+
+    // Send packet to reinitialize the entity
+    case E_EC_INIT: {
+      CExtEntityInit pck;
+      pck("ulEntity", (int)ec.ulEntity);
+      pck.SetEvent(EVoid(), sizeof(EVoid));
+      pck.SendToClients();
+    } return sizeof(ULONG) + sizeof(EVoid);
+
+    // Send packet to destroy the entity
+    case E_EC_DELETE: {
+      CExtEntityDelete pck;
+      pck("ulEntity", (int)ec.ulEntity);
+      pck("bSameClass", false);
+      pck.SendToClients();
+    } return sizeof(ULONG) + sizeof(UBYTE);
+  }
 
 #else
-  // Destroy entity immediately
-  pen->Destroy();
+  CEntity *pen = ec.pen;
+
+  switch (ec.eType) {
+    // Change values of float and index properties
+    case E_EC_PROP: {
+      INDEX iType = IProperties::ConvertType(ec.pep->ep_eptType);
+
+      if (iType == CEntityProperty::EPT_FLOAT) {
+        FLOAT fFloatProp = ec.fValue;
+        IProperties::SetPropValue(pen, ec.pep, &fFloatProp);
+
+      } else if (iType == CEntityProperty::EPT_INDEX) {
+        INDEX iIntProp = ec.fValue;
+        IProperties::SetPropValue(pen, ec.pep, &iIntProp);
+      }
+    } break;
+
+    // Reinitialize entity immediately
+    case E_EC_INIT: pen->Reinitialize(); break;
+
+    // Destroy entity immediately
+    case E_EC_DELETE: pen->Destroy(); break;
+  }
 #endif
+
+  return 0;
 };
 
-// Reinitialize some entity
-static inline void ReinitEntity(CEntity *pen) {
-#if _PATCHCONFIG_EXT_PACKETS
-  // Send packet to reinitialize the entity
-  CExtEntityInit pck;
-  pck("ulEntity", (int)pen->en_ulID);
-  pck.SetEvent(EVoid(), sizeof(EVoid));
-  pck.SendToClients();
+// Apply entity changes that are already in order and without redundancies
+void ApplyEntityChanges(const CStaticStackArray<EntityChange> &aChanges, INDEX ctQueued, BOOL bReport) {
+  const INDEX ctApplied = aChanges.Count();
+  SLONG slEstimatedBytes = 0;
+
+  for (INDEX i = 0; i < ctApplied; i++) {
+    slEstimatedBytes += ApplyChange(aChanges[i]);
+  }
+
+  if (!bReport) return;
 
+#if _PATCHCONFIG_EXT_PACKETS
+  CPrintF(TRANS("Entity changes: %d packets sent, %d without deduplication (~%d bytes of payload, estimated)\n"), ctApplied, ctQueued, slEstimatedBytes);
 #else
-  // Reinitialize entity immediately
-  pen->Reinitialize();
+  CPrintF(TRANS("Entity changes: %d queued, %d applied\n"), ctQueued, ctApplied);
 #endif
 };
 
-// Change property of some entity
-static inline void ChangeEntityProp(CEntity *pen, CPropertyPtr &pptr, DOUBLE fValue) {
-#if _PATCHCONFIG_EXT_PACKETS
-  // Send packet to change the property
-  CExtEntityProp pck;
-  pck("ulEntity", (int)pen->en_ulID);
-  pck.SetProperty(pptr._pep->ep_ulID);
-  pck.SetValue(fValue);
-  pck.SendToClients();
+// Collect entity changes queued during the affect pass that need to be applied and return the amount of queued ones
+// Changes of each entity are sent together in the order of entity IDs; changes of destroyed entities,
+// repeated reinitializations and overwritten property values are dropped
+INDEX CollectEntityChanges(CStaticStackArray<EntityChange> &aApplied) {
+  aApplied.PopAll();
 
-#else
-  // Change values of float and index properties
-  INDEX iType = IProperties::ConvertType(pptr._pep->ep_eptType);
+  const INDEX ctQueued = _aChanges.Count();
+  if (ctQueued == 0) return 0;
+
+  qsort(&_aChanges[0], ctQueued, sizeof(EntityChange), &CompareChanges);
+
+  INDEX iGroup = 0;
+
+  while (iGroup < ctQueued) {
+    // Find all changes of the same entity
+    const ULONG ulEntity = _aChanges[iGroup].ulEntity;
+    INDEX iGroupEnd = iGroup + 1;
+
+    while (iGroupEnd < ctQueued && _aChanges[iGroupEnd].ulEntity == ulEntity) {
+      iGroupEnd++;
+    }
+
+    // Deletions are sorted last and make other changes pointless
+    const EntityChange &ecLast = _aChanges[iGroupEnd - 1];
+
+    if (ecLast.eType == E_EC_DELETE) {
+      aApplied.Push() = ecLast;
 
-  if (iType == CEntityProperty::EPT_FLOAT) {
-    FLOAT fFloatProp = fValue;
-    IProperties::SetPropValue(pen, pptr._pep, &fFloatProp);
+    } else {
+      for (INDEX i = iGroup; i < iGroupEnd; i++) {
+        const EntityChange &ec = _aChanges[i];
 
-  } else if (iType == CEntityProperty::EPT_INDEX) {
-    INDEX iIntProp = fValue;
-    IProperties::SetPropValue(pen, pptr._pep, &iIntProp);
+        // Only apply the last value of each property and reinitialize once
+        if (i + 1 < iGroupEnd) {
+          const EntityChange &ecNext = _aChanges[i + 1];
+          if (ecNext.eType == ec.eType && ecNext.pep == ec.pep) continue;
+        }
+
+        aApplied.Push() = ec;
+      }
+    }
+
+    iGroup = iGroupEnd;
   }
-#endif
+
+  _aChanges.PopAll();
+  return ctQueued;
+};
+
+// Item should be left as is
+#define ITEM_KEEP   INDEX(-2)
+
+// Item should be removed
+#define ITEM_REMOVE INDEX(-1)
+
+// Item settings compiled for the current affect pass
+struct ItemRemap {
+  BOOL bCompiled;
+  INDEX aiNewType[CT_WEAPONS]; // ITEM_KEEP, ITEM_REMOVE or a valid type for each current type
+  INDEX iOtherTypes; // For types that can't be set individually
+};
+
+static ItemRemap _remapWeapons;
+static ItemRemap _remapAmmo;
+static ItemRemap _remapHealth;
+static ItemRemap _remapArmor;
+static ItemRemap _remapPowerUps;
+
+// Player marker settings compiled for the current affect pass
+static BOOL _bMarkerCompiled = FALSE;
+static ULONG _ulGiveWeapons = 0;
+static ULONG _ulTakeWeapons = 0;
+
+// Make all settings get compiled again before affecting any entities
+void ResetAffectSettings(void) {
+  _remapWeapons.bCompiled = FALSE;
+  _remapAmmo.bCompiled = FALSE;
+  _remapHealth.bCompiled = FALSE;
+  _remapArmor.bCompiled = FALSE;
+  _remapPowerUps.bCompiled = FALSE;
+  _bMarkerCompiled = FALSE;
+};
+
+// Verify item type set by some symbol and reset it to default value if it's invalid
+static INDEX VerifyItemType(const CPropertyPtr &pptrType, INDEX iType, const CTString &strSymbol) {
+  CTString strType = pptrType._pep->ep_pepetEnumType->NameForValue(iType);
+
+  // Set default valid type if invalid
+  if (strType == "") {
+    CPrintF(TRANS("'%s' : Item type %d is invalid!\n"), strSymbol.str_String, iType);
+    return 1;
+  }
+
+  return iType;
+};
+
+// Compile item settings into a table of new types
+static void CompileItemRemap(ItemRemap &remap, const CPropertyPtr &pptrType, CPluginSymbol *apsTypes, INDEX ctTypes,
+                             const char *strTypeSymbol, CPluginSymbol *psReplace, const char *strReplaceSymbol) {
+  ASSERT(ctTypes <= CT_WEAPONS);
+
+  // Replace with another item
+  remap.iOtherTypes = ITEM_KEEP;
+
+  if (psReplace != NULL && psReplace->GetIndex() >= 0) {
+    remap.iOtherTypes = VerifyItemType(pptrType, psReplace->GetIndex(), strReplaceSymbol);
+  }
+
+  CTString strSymbol;
+
+  for (INDEX iType = 0; iType < CT_WEAPONS; iType++) {
+    const INDEX iSetType = (iType < ctTypes) ? apsTypes[iType].GetIndex() : ITEM_KEEP;
+
+    // Remove item
+    if (iSetType == -1) {
+      remap.aiNewType[iType] = ITEM_REMOVE;
+
+    // Set specific type
+    } else if (iSetType >= 0) {
+      strSymbol.PrintF(strTypeSymbol, iType);
+      remap.aiNewType[iType] = VerifyItemType(pptrType, iSetType, strSymbol);
+
+    } else {
+      remap.aiNewType[iType] = remap.iOtherTypes;
+    }
+  }
+
+  remap.bCompiled = TRUE;
+};
+
+// Affect item of any type using compiled settings
+static void AffectItem(CEntity *pen, CPropertyPtr &pptrType, const ItemRemap &remap) {
+  const INDEX iCurrType = ENTITYPROPERTY(pen, pptrType.Offset(), INDEX);
+  const INDEX iNewType = (iCurrType >= 0 && iCurrType < CT_WEAPONS) ? remap.aiNewType[iCurrType] : remap.iOtherTypes;
+
+  if (iNewType == ITEM_KEEP || iNewType == iCurrType) return;
+
+  if (iNewType == ITEM_REMOVE) {
+    DestroyEntity(pen);
+    return;
+  }
+
+  ChangeEntityProp(pen, pptrType, iNewType);
+  ReinitEntity(pen);
 };
 
 // Affect weapon item at the beginning of the game
@@ -100,27 +305,11 @@ void AffectWeaponItem(CEntity *pen) {
     return;
   }
 
-  INDEX iCurrType = ENTITYPROPERTY(pen, pptr.Offset(), INDEX);
-  INDEX iSetType = _apsWeaponItems[iCurrType].GetIndex();
-
-  // Remove weapon item
-  if (iSetType == -1) {
-    DestroyEntity(pen);
-
-  // Set specific type
-  } else if (iSetType >= 0) {
-    iCurrType = VerifyItemType(pen, pptr, iSetType);
-
-    ChangeEntityProp(pen, pptr, iCurrType);
-    ReinitEntity(pen);
-
-  // Replace with another weapon
-  } else if (_psReplaceWeapons.GetIndex() >= 0) {
-    iCurrType = VerifyItemType(pen, pptr, _psReplaceWeapons.GetIndex());
-
-    ChangeEntityProp(pen, pptr, iCurrType);
-    ReinitEntity(pen);
+  if (!_remapWeapons.bCompiled) {
+    CompileItemRemap(_remapWeapons, pptr, _apsWeaponItems, CT_WEAPONS, "sutl_iWeaponType%d", &_psReplaceWeapons, "sutl_iReplaceWeapons");
   }
+
+  AffectItem(pen, pptr, _remapWeapons);
 };
 
 // Affect ammo item at the beginning of the game
@@ -133,27 +322,11 @@ void AffectAmmoItem(CEntity *pen) {
     return;
   }
 
-  INDEX iCurrType = ENTITYPROPERTY(pen, pptr.Offset(), INDEX);
-  INDEX iSetType = _apsAmmoItems[iCurrType].GetIndex();
-
-  // Remove ammo item
-  if (iSetType == -1) {
-    DestroyEntity(pen);
-
-  // Set specific type
-  } else if (iSetType >= 0) {
-    iCurrType = VerifyItemType(pen, pptr, iSetType);
-
-    ChangeEntityProp(pen, pptr, iCurrType);
-    ReinitEntity(pen);
-
-  // Replace with another weapon
-  } else if (_psReplaceAmmo.GetIndex() >= 0) {
-    iCurrType = VerifyItemType(pen, pptr, _psReplaceAmmo.GetIndex());
-
-    ChangeEntityProp(pen, pptr, iCurrType);
-    ReinitEntity(pen);
+  if (!_remapAmmo.bCompiled) {
+    CompileItemRemap(_remapAmmo, pptr, _apsAmmoItems, CT_WEAPONS, "sutl_iAmmoType%d", &_psReplaceAmmo, "sutl_iReplaceAmmo");
   }
+
+  AffectItem(pen, pptr, _remapAmmo);
 };
 
 // Affect health item at the beginning of the game
@@ -166,27 +339,11 @@ void AffectHealthItem(CEntity *pen) {
     return;
   }
 
-  INDEX iCurrType = ENTITYPROPERTY(pen, pptr.Offset(), INDEX);
-  INDEX iSetType = _apsHealthItems[iCurrType].GetIndex();
-
-  // Remove health item
-  if (iSetType == -1) {
-    DestroyEntity(pen);
-
-  // Set specific type
-  } else if (iSetType >= 0) {
-    iCurrType = VerifyItemType(pen, pptr, iSetType);
-
-    ChangeEntityProp(pen, pptr, iCurrType);
-    ReinitEntity(pen);
-
-  // Replace with another health item
-  } else if (_psReplaceHealth.GetIndex() >= 0) {
-    iCurrType = VerifyItemType(pen, pptr, _psReplaceHealth.GetIndex());
-
-    ChangeEntityProp(pen, pptr, iCurrType);
-    ReinitEntity(pen);
+  if (!_remapHealth.bCompiled) {
+    CompileItemRemap(_remapHealth, pptr, _apsHealthItems, CT_ITEMS, "sutl_iHealthType%d", &_psReplaceHealth, "sutl_iReplaceHealth");
   }
+
+  AffectItem(pen, pptr, _remapHealth);
 };
 
 // Affect armor item at the beginning of the game
@@ -199,27 +356,11 @@ void AffectArmorItem(CEntity *pen) {
     return;
   }
 
-  INDEX iCurrType = ENTITYPROPERTY(pen, pptr.Offset(), INDEX);
-  INDEX iSetType = _apsArmorItems[iCurrType].GetIndex();
-
-  // Remove armor item
-  if (iSetType == -1) {
-    DestroyEntity(pen);
-
-  // Set specific type
-  } else if (iSetType >= 0) {
-    iCurrType = VerifyItemType(pen, pptr, iSetType);
-
-    ChangeEntityProp(pen, pptr, iCurrType);
-    ReinitEntity(pen);
-
-  // Replace with another armor item
-  } else if (_psReplaceArmor.GetIndex() >= 0) {
-    iCurrType = VerifyItemType(pen, pptr, _psReplaceArmor.GetIndex());
-
-    ChangeEntityProp(pen, pptr, iCurrType);
-    ReinitEntity(pen);
+  if (!_remapArmor.bCompiled) {
+    CompileItemRemap(_remapArmor, pptr, _apsArmorItems, CT_ITEMS, "sutl_iArmorType%d", &_psReplaceArmor, "sutl_iReplaceArmor");
   }
+
+  AffectItem(pen, pptr, _remapArmor);
 };
 
 // Affect power up item at the beginning of the game
@@ -232,20 +373,11 @@ void AffectPowerUpItem(CEntity *pen) {
     return;
   }
 
-  INDEX iCurrType = ENTITYPROPERTY(pen, pptr.Offset(), INDEX);
-  INDEX iSetType = _apsPowerUpItems[iCurrType].GetIndex();
-
-  // Remove power up
-  if (iSetType == -1) {
-    DestroyEntity(pen);
-
-  // Set specific type
-  } else if (iSetType >= 0) {
-    iCurrType = VerifyItemType(pen, pptr, iSetType);
-
-    ChangeEntityProp(pen, pptr, iCurrType);
-    ReinitEntity(pen);
+  if (!_remapPowerUps.bCompiled) {
+    CompileItemRemap(_remapPowerUps, pptr, _apsPowerUpItems, CT_ITEMS, "sutl_iPowerUpType%d", NULL, "");
   }
+
+  AffectItem(pen, pptr, _remapPowerUps);
 };
 
 // Affect player start marker at the beginning of the game
@@ -257,20 +389,30 @@ void AffectPlayerMarker(CEntity *pen) {
     ReportPropError(pen, "CPlayerMarker::m_iGiveWeapons");
 
   } else {
-    INDEX iSet = ENTITYPROPERTY(pen, pptrGive.Offset(), INDEX);
-
-    // Give out specific weapons
-    for (INDEX iWeapon = 0; iWeapon < CT_WEAPONS; iWeapon++) {
-      INDEX iGive = _apsGiveWeapons[iWeapon].GetIndex();
-
-      if (iGive == 1) {
-        iSet |= (1 << iWeapon); // Give the weapon
-      } else if (iGive == 0) {
-        iSet &= ~(1 << iWeapon); // Take away the weapon
+    // Compile weapon masks once
+    if (!_bMarkerCompiled) {
+      _ulGiveWeapons = 0;
+      _ulTakeWeapons = 0;
+
+      for (INDEX iWeapon = 0; iWeapon < CT_WEAPONS; iWeapon++) {
+        const INDEX iGive = _apsGiveWeapons[iWeapon].GetIndex();
+
+        if (iGive == 1) {
+          _ulGiveWeapons |= (1 << iWeapon); // Give the weapon
+        } else if (iGive == 0) {
+          _ulTakeWeapons |= (1 << iWeapon); // Take away the weapon
+        }
       }
+
+      _bMarkerCompiled = TRUE;
     }
 
-    ChangeEntityProp(pen, pptrGive, iSet);
+    const INDEX iCurrent = ENTITYPROPERTY(pen, pptrGive.Offset(), INDEX);
+    const INDEX iSet = (iCurrent | _ulGiveWeapons) & ~_ulTakeWeapons;
+
+    if (iSet != iCurrent) {
+      ChangeEntityProp(pen, pptrGive, iSet);
+    }
   }
 
   // Retrieve CPlayerMarker::m_fMaxAmmoRatio
@@ -13,6 +13,32 @@ You should have received a copy of the GNU General Public License along
 with this program; if not, write to the Free Software Foundation, Inc.,
 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
 
+// Type of a queued entity change in the order they are applied to the same entity
+enum EEntityChange {
+  E_EC_PROP,
+  E_EC_INIT,
+  E_EC_DELETE,
+};
+
+// Entity change that's queued until the end of the affect pass
+struct EntityChange {
+  CEntity *pen;
+  ULONG ulEntity;
+  EEntityChange eType;
+  CEntityProperty *pep;
+  DOUBLE fValue;
+  INDEX iOrder; // Order in which the change has been queued
+};
+
+// Apply entity changes that are already in order and without redundancies
+void ApplyEntityChanges(const CStaticStackArray<EntityChange> &aChanges, INDEX ctQueued, BOOL bReport);
+
+// Collect entity changes queued during the affect pass that need to be applied and return the amount of queued ones
+INDEX CollectEntityChanges(CStaticStackArray<EntityChange> &aApplied);
+
+// Make all settings get compiled again before affecting any entities
+void ResetAffectSettings(void);
+
 // Affect weapon item at the beginning of the game
 void AffectWeaponItem(CEntity *pen);
 